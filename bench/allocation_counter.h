@@ -0,0 +1,50 @@
+// Counts heap allocations made through the global operator new, so benchmarks can report
+// allocations per operation. Linking allocation_counter.cpp replaces operator new and
+// delete for the whole binary.
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace trade_simulator {
+namespace bench {
+
+/**
+ * @brief Get the number of allocations made so far by all threads
+ * @return Calls of operator new since the program started
+ */
+uint64_t allocationCount();
+
+/**
+ * @brief Counts the allocations of a benchmark loop and reports them per iteration
+ *
+ * Construct right before the loop; the destructor adds an "allocs/op" counter.
+ */
+class AllocationCounter {
+public:
+    explicit AllocationCounter(benchmark::State& state)
+        : state_(state), start_(allocationCount()) {}
+
+    ~AllocationCounter() {
+        state_.counters["allocs/op"] = benchmark::Counter(
+            static_cast<double>(allocationCount() - start_), benchmark::Counter::kAvgIterations);
+    }
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    /**
+     * @brief Get the allocations made since construction, e.g. to fail a benchmark on any
+     * @return Calls of operator new by all threads since the counter was constructed
+     */
+    uint64_t count() const { return allocationCount() - start_; }
+
+private:
+    benchmark::State& state_;
+    uint64_t start_;
+};
+
+} // namespace bench
+} // namespace trade_simulator
@@ -0,0 +1,89 @@
+// Benchmark of the fused per-side pass in OrderbookProcessor::calculateStats against
+// computing the same aggregates in separate scalar passes, at several book depths.
+
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <vector>
+
+#include "data/book_kernels.h"
+
+namespace {
+
+using namespace trade_simulator::data;
+
+constexpr size_t kTopLevels = 10;
+
+struct SyntheticSide {
+    std::vector<double> prices;
+    std::vector<double> sizes;
+};
+
+// Ask side around 95,000 with a 0.1 tick and uneven gaps and sizes
+SyntheticSide makeAskSide(size_t depth) {
+    SyntheticSide side;
+    side.prices.resize(depth);
+    side.sizes.resize(depth);
+    double price = 95000.0;
+    for (size_t i = 0; i < depth; ++i) {
+        side.prices[i] = price;
+        side.sizes[i] = 0.01 + static_cast<double>((i * 7919) % 1000) / 100.0;
+        price += 0.1 * static_cast<double>(1 + (i * 31) % 5);
+    }
+    return side;
+}
+
+// The aggregates computed one quantity at a time, as calculateStats did before
+kernels::SideSummary summarizeInSeparatePasses(const SyntheticSide& side) {
+    const double* prices = side.prices.data();
+    const double* sizes = side.sizes.data();
+    size_t count = side.prices.size();
+    size_t topEnd = std::min(kTopLevels, count);
+
+    kernels::SideSummary summary;
+    summary.topSize = std::accumulate(sizes, sizes + topEnd, 0.0);
+    summary.topNotional = std::inner_product(prices, prices + topEnd, sizes, 0.0);
+    summary.totalSize = std::accumulate(sizes, sizes + count, 0.0);
+    summary.totalNotional = std::inner_product(prices, prices + count, sizes, 0.0);
+    for (size_t k = 0; k < kDepthBandCount; ++k) {
+        double limit = prices[0] * (1.0 + kDepthBandsBps[k] / 10000.0);
+        for (size_t i = 0; i < count && prices[i] <= limit; ++i) {
+            summary.bandSize[k] += sizes[i];
+        }
+    }
+    return summary;
+}
+
+void BM_SeparatePasses(benchmark::State& state) {
+    SyntheticSide side = makeAskSide(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(summarizeInSeparatePasses(side));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SeparatePasses)->Arg(50)->Arg(400)->Arg(5000);
+
+void BM_FusedScalar(benchmark::State& state) {
+    SyntheticSide side = makeAskSide(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels::summarizeSideScalar(
+            side.prices.data(), side.sizes.data(), side.prices.size(), kTopLevels, true));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FusedScalar)->Arg(50)->Arg(400)->Arg(5000);
+
+void BM_FusedDispatched(benchmark::State& state) {
+    SyntheticSide side = makeAskSide(static_cast<size_t>(state.range(0)));
+    state.SetLabel(kernels::summarizeSideImplementation());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels::summarizeSide(
+            side.prices.data(), side.sizes.data(), side.prices.size(), kTopLevels, true));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FusedDispatched)->Arg(50)->Arg(400)->Arg(5000);
+
+} // namespace
+
+BENCHMARK_MAIN();
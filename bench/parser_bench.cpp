@@ -0,0 +1,188 @@
+// Benchmark of the single-pass L2Parser against the previous nlohmann::json path,
+// run over recorded GoQuant L2 messages (one JSON message per line), and of the venue
+// decoders over the same books re-encoded in each venue's schema.
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "data/feed_adapter.h"
+#include "data/l2_parser.h"
+
+namespace {
+
+using trade_simulator::data::FeedDecoder;
+using trade_simulator::data::InstrumentSpec;
+using trade_simulator::data::L2Parser;
+using trade_simulator::data::OrderbookData;
+using trade_simulator::data::Venue;
+
+const std::vector<std::string>& recordedMessages() {
+    static const std::vector<std::string> messages = [] {
+        std::vector<std::string> lines;
+        std::ifstream in(TRADE_SIMULATOR_BENCH_DATA_DIR "/okx_btc_usdt_swap_l2.jsonl");
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty()) {
+                lines.push_back(std::move(line));
+            }
+        }
+        if (lines.empty()) {
+            throw std::runtime_error("No recorded messages found");
+        }
+        return lines;
+    }();
+    return messages;
+}
+
+int64_t totalBytes(const std::vector<std::string>& messages) {
+    int64_t bytes = 0;
+    for (const auto& message : messages) {
+        bytes += static_cast<int64_t>(message.size());
+    }
+    return bytes;
+}
+
+// The book layout WebSocketClient produced before L2Parser: a vector of pairs per side
+struct LegacyOrderbookData {
+    std::string timestamp;
+    std::string exchange;
+    std::string symbol;
+    std::vector<std::pair<double, double>> asks;
+    std::vector<std::pair<double, double>> bids;
+};
+
+// The parsing path WebSocketClient used before L2Parser: full DOM, a std::string per
+// price and size, std::stod for the conversion.
+LegacyOrderbookData parseWithDom(const std::string& jsonMessage) {
+    using json = nlohmann::json;
+    json data = json::parse(jsonMessage);
+
+    LegacyOrderbookData orderbookData;
+    orderbookData.timestamp = data["timestamp"].get<std::string>();
+    orderbookData.exchange = data["exchange"].get<std::string>();
+    orderbookData.symbol = data["symbol"].get<std::string>();
+
+    for (const auto& ask : data["asks"]) {
+        if (ask.size() >= 2) {
+            orderbookData.asks.emplace_back(std::stod(ask[0].get<std::string>()),
+                                            std::stod(ask[1].get<std::string>()));
+        }
+    }
+    for (const auto& bid : data["bids"]) {
+        if (bid.size() >= 2) {
+            orderbookData.bids.emplace_back(std::stod(bid[0].get<std::string>()),
+                                            std::stod(bid[1].get<std::string>()));
+        }
+    }
+    return orderbookData;
+}
+
+void BM_ParseNlohmannDom(benchmark::State& state) {
+    const auto& messages = recordedMessages();
+    size_t index = 0;
+    for (auto _ : state) {
+        LegacyOrderbookData book = parseWithDom(messages[index]);
+        benchmark::DoNotOptimize(book.asks.data());
+        index = (index + 1) % messages.size();
+    }
+    state.SetBytesProcessed(state.iterations() * totalBytes(messages) /
+                            static_cast<int64_t>(messages.size()));
+}
+BENCHMARK(BM_ParseNlohmannDom);
+
+void BM_ParseL2Parser(benchmark::State& state) {
+    const auto& messages = recordedMessages();
+    size_t index = 0;
+    // One book reused across messages, as the WebSocket read loop does
+    OrderbookData book;
+    for (auto _ : state) {
+        L2Parser::parse(messages[index], book);
+        benchmark::DoNotOptimize(book.asks.prices.data());
+        index = (index + 1) % messages.size();
+    }
+    state.SetBytesProcessed(state.iterations() * totalBytes(messages) /
+                            static_cast<int64_t>(messages.size()));
+}
+BENCHMARK(BM_ParseL2Parser);
+
+std::string encodeLevels(const trade_simulator::data::BookSide& side, bool deribit) {
+    std::string levels = "[";
+    for (size_t i = 0; i < side.size(); ++i) {
+        levels += i == 0 ? "[" : ",[";
+        if (deribit) {
+            levels += "\"new\"," + std::to_string(side.prices[i]) + "," + std::to_string(side.sizes[i]);
+        } else {
+            levels += "\"" + std::to_string(side.prices[i]) + "\",\"" + std::to_string(side.sizes[i]) + "\"";
+        }
+        levels += "]";
+    }
+    return levels + "]";
+}
+
+// The recorded books in the schema of a venue's own feed
+std::vector<std::string> venueMessages(Venue venue) {
+    std::vector<std::string> messages;
+    OrderbookData book;
+    int64_t seq = 1;
+    for (const auto& recorded : recordedMessages()) {
+        L2Parser::parse(recorded, book);
+        bool deribit = venue == Venue::Deribit;
+        std::string asks = encodeLevels(book.asks, deribit);
+        std::string bids = encodeLevels(book.bids, deribit);
+        std::string id = std::to_string(seq++);
+        switch (venue) {
+            case Venue::GoQuant:
+                messages.push_back(recorded);
+                break;
+            case Venue::Okx:
+                messages.push_back(R"({"arg":{"channel":"books","instId":"BTC-USDT-SWAP"},"action":"snapshot","data":[{"asks":)" +
+                                   asks + R"(,"bids":)" + bids + R"(,"ts":"1746355153000","seqId":)" + id + "}]}");
+                break;
+            case Venue::Binance:
+                messages.push_back(R"({"e":"depthUpdate","E":1746355153000,"T":1746355153000,"s":"BTCUSDT","U":1,"u":)" +
+                                   id + R"(,"pu":0,"b":)" + bids + R"(,"a":)" + asks + "}");
+                break;
+            case Venue::Bybit:
+                messages.push_back(R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1746355153000,"data":{"s":"BTCUSDT","b":)" +
+                                   bids + R"(,"a":)" + asks + R"(,"u":)" + id + "}}");
+                break;
+            case Venue::Deribit:
+                messages.push_back(R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.BTC-PERPETUAL.100ms","data":{"type":"snapshot","timestamp":1746355153000,"instrument_name":"BTC-PERPETUAL","change_id":)" +
+                                   id + R"(,"bids":)" + bids + R"(,"asks":)" + asks + "}}}");
+                break;
+        }
+    }
+    return messages;
+}
+
+// Decoding through FeedDecoder, one dispatch per message; the argument is the Venue
+void BM_DecodeVenue(benchmark::State& state) {
+    Venue venue = static_cast<Venue>(state.range(0));
+    const std::vector<std::string> messages = venueMessages(venue);
+    FeedDecoder decoder(venue, InstrumentSpec());
+    size_t index = 0;
+    OrderbookData book;
+    for (auto _ : state) {
+        decoder.decode(messages[index], book);
+        benchmark::DoNotOptimize(book.asks.prices.data());
+        index = (index + 1) % messages.size();
+    }
+    state.SetLabel(trade_simulator::data::venueName(venue));
+    state.SetBytesProcessed(state.iterations() * totalBytes(messages) /
+                            static_cast<int64_t>(messages.size()));
+}
+BENCHMARK(BM_DecodeVenue)
+    ->Arg(static_cast<int>(Venue::GoQuant))
+    ->Arg(static_cast<int>(Venue::Okx))
+    ->Arg(static_cast<int>(Venue::Binance))
+    ->Arg(static_cast<int>(Venue::Bybit))
+    ->Arg(static_cast<int>(Venue::Deribit));
+
+} // namespace
+
+BENCHMARK_MAIN();
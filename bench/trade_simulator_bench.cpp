@@ -0,0 +1,442 @@
+// Benchmarks of the per-update hot path: parsing, book maintenance and statistics,
+// volatility, cost models and execution schedules. Books are grown from the recorded
+// GoQuant L2 fixture to the benchmarked depth by repeating its price gaps and sizes.
+// Every benchmark reports allocations per operation next to the time; BM_TickPipeline
+// fails if a steady-state tick allocates at all.
+
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "data/l2_parser.h"
+#include "data/orderbook_dispatcher.h"
+#include "data/orderbook_processor.h"
+#include "data/queue_tracker.h"
+#include "data/rolling_volatility.h"
+#include "models/cost_memo.h"
+#include "models/execution_monte_carlo.h"
+#include "models/market_impact.h"
+#include "models/slippage_calibrator.h"
+#include "models/smart_order_router.h"
+#include "models/transaction_cost.h"
+#include "utils/latency_histogram.h"
+#include "utils/work_stealing_pool.h"
+
+namespace {
+
+using namespace trade_simulator;
+using trade_simulator::bench::AllocationCounter;
+
+const std::vector<std::string>& recordedMessages() {
+    static const std::vector<std::string> messages = [] {
+        std::vector<std::string> lines;
+        std::ifstream in(TRADE_SIMULATOR_BENCH_DATA_DIR "/okx_btc_usdt_swap_l2.jsonl");
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty()) {
+                lines.push_back(std::move(line));
+            }
+        }
+        if (lines.empty()) {
+            throw std::runtime_error("No recorded messages found");
+        }
+        return lines;
+    }();
+    return messages;
+}
+
+struct Level {
+    double price;
+    double size;
+};
+
+// One side of a recorded book, extended to depth by cycling its gaps and sizes
+std::vector<Level> growSide(const data::BookSide& side, size_t depth) {
+    std::vector<Level> levels;
+    levels.reserve(depth);
+    for (size_t i = 0; i < side.size() && i < depth; ++i) {
+        levels.push_back({side.prices[i], side.sizes[i]});
+    }
+    for (size_t i = levels.size(); i < depth; ++i) {
+        size_t source = 1 + (i - 1) % (side.size() - 1);
+        double gap = side.prices[source] - side.prices[source - 1];
+        double price = std::round((levels.back().price + gap) * 10.0) / 10.0;
+        levels.push_back({price, side.sizes[source]});
+    }
+    return levels;
+}
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendSide(std::string& out, const char* name, const std::vector<Level>& levels) {
+    out += '"';
+    out += name;
+    out += "\":[";
+    for (size_t i = 0; i < levels.size(); ++i) {
+        out += i == 0 ? "[\"" : ",[\"";
+        appendNumber(out, levels[i].price);
+        out += "\",\"";
+        appendNumber(out, levels[i].size);
+        out += "\"]";
+    }
+    out += ']';
+}
+
+// A recorded message rewritten at the given depth per side
+std::string messageAtDepth(size_t index, size_t depth) {
+    const std::string& recorded = recordedMessages()[index % recordedMessages().size()];
+    data::OrderbookData book;
+    data::L2Parser::parse(recorded, book);
+
+    std::string message = "{\"timestamp\":\"" + std::string(book.timestamp.view()) +
+                          "\",\"exchange\":\"" + std::string(data::symbolName(book.exchange)) +
+                          "\",\"symbol\":\"" + std::string(data::symbolName(book.symbol)) + "\",";
+    appendSide(message, "asks", growSide(book.asks, depth));
+    message += ',';
+    appendSide(message, "bids", growSide(book.bids, depth));
+    message += '}';
+    return message;
+}
+
+// Parsed books at a depth, alternating between two recorded messages
+std::vector<data::OrderbookData> booksAtDepth(size_t depth) {
+    std::vector<data::OrderbookData> books(2);
+    for (size_t i = 0; i < books.size(); ++i) {
+        data::L2Parser::parse(messageAtDepth(i, depth), books[i]);
+    }
+    return books;
+}
+
+void BM_ParseOrderbook(benchmark::State& state) {
+    std::string message = messageAtDepth(0, static_cast<size_t>(state.range(0)));
+    data::OrderbookData book;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            data::L2Parser::parse(message, book);
+            benchmark::DoNotOptimize(book.asks.prices.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message.size()));
+}
+// Levels beyond kMaxBookDepth are parsed and dropped
+BENCHMARK(BM_ParseOrderbook)->Arg(10)->Arg(100)->Arg(400)->Arg(1000)->Arg(5000);
+
+void BM_ProcessSnapshot(benchmark::State& state) {
+    std::vector<data::OrderbookData> books = booksAtDepth(static_cast<size_t>(state.range(0)));
+    data::OrderbookProcessor processor([](const data::OrderbookStats& stats) {
+        benchmark::DoNotOptimize(stats.midprice);
+    });
+    auto time = std::chrono::steady_clock::time_point();
+    size_t index = 0;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            data::OrderbookData& book = books[index++ & 1];
+            time += std::chrono::milliseconds(100);
+            book.received_time = time;
+            processor.processOrderbook(book);
+        }
+    }
+}
+BENCHMARK(BM_ProcessSnapshot)->Arg(10)->Arg(100)->Arg(400);
+
+// Virtual orders spread over the 100 bid levels behind the touch of a 400-level book;
+// every delta changes one of them, alternately shrinking and restoring it
+void BM_QueueTrackerDelta(benchmark::State& state) {
+    constexpr size_t kTrackedLevels = 100;
+    data::OrderbookData snapshot = booksAtDepth(400)[0];
+    data::L2Book book;
+    book.apply(snapshot);
+    data::QueueTracker tracker;
+    size_t orders = static_cast<size_t>(state.range(0));
+    for (size_t i = 0; i < orders; ++i) {
+        size_t level = 1 + i % kTrackedLevels;
+        double price = book.bids().prices[level];
+        tracker.place(true, price, 0.01, book.sizeAt(true, price));
+    }
+
+    data::OrderbookData delta;
+    delta.update_type = data::BookUpdateType::Delta;
+    delta.bids.count = 1;
+    auto time = std::chrono::steady_clock::time_point();
+    size_t index = 0;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            size_t level = 1 + (index >> 1) % kTrackedLevels;
+            double size = snapshot.bids.sizes[level] * ((index & 1) ? 1.0 : 0.99);
+            ++index;
+            delta.bids.prices[0] = snapshot.bids.prices[level];
+            delta.bids.sizes[0] = size;
+            time += std::chrono::milliseconds(1);
+            delta.received_time = time;
+            book.apply(delta);
+            tracker.apply(delta, book);
+        }
+    }
+    state.counters["orders/level"] = static_cast<double>(orders) / kTrackedLevels;
+}
+BENCHMARK(BM_QueueTrackerDelta)->Arg(100)->Arg(400)->Arg(1000);
+
+void BM_CalculateVolatility(benchmark::State& state) {
+    size_t window = static_cast<size_t>(state.range(0));
+    data::RollingVolatility volatility{data::VolatilityConfig(window)};
+
+    // Recorded midprices, cycled with a small drift so the window keeps changing
+    std::vector<double> midprices;
+    for (size_t i = 0; i < recordedMessages().size(); ++i) {
+        data::OrderbookData book;
+        data::L2Parser::parse(recordedMessages()[i], book);
+        midprices.push_back((book.asks.prices[0] + book.bids.prices[0]) / 2.0);
+    }
+    auto time = std::chrono::steady_clock::time_point();
+    size_t index = 0;
+    auto nextMidprice = [&]() {
+        double drift = static_cast<double>(index % 997) * 0.01;
+        return midprices[index++ % midprices.size()] + drift;
+    };
+    for (size_t i = 0; i < window; ++i) {
+        time += std::chrono::milliseconds(1);
+        volatility.addMidprice(nextMidprice(), time);
+    }
+
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            time += std::chrono::milliseconds(1);
+            volatility.addMidprice(nextMidprice(), time);
+            benchmark::DoNotOptimize(volatility.volatility());
+        }
+    }
+}
+BENCHMARK(BM_CalculateVolatility)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Statistics and depth profile of a recorded book at a depth
+struct PricedBook {
+    data::OrderbookStats stats;
+    data::DepthProfile profile;
+};
+
+PricedBook pricedBookAtDepth(size_t depth) {
+    PricedBook priced;
+    data::OrderbookProcessor processor([&priced](const data::OrderbookStats& stats) {
+        priced.stats = stats;
+    });
+    for (const data::OrderbookData& book : booksAtDepth(depth)) {
+        processor.processOrderbook(book);
+    }
+    priced.profile = processor.getDepthProfile();
+    return priced;
+}
+
+void BM_CalculateTotalCost(benchmark::State& state) {
+    PricedBook priced = pricedBookAtDepth(static_cast<size_t>(state.range(0)));
+    auto impactModel = std::make_shared<models::MarketImpactModel>();
+    models::TransactionCostModel costModel(impactModel);
+    double baseQuantity = 100000.0 / priced.stats.midprice;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            auto cost = costModel.calculateTotalCost(baseQuantity, true, priced.stats, priced.profile);
+            benchmark::DoNotOptimize(cost);
+        }
+    }
+}
+BENCHMARK(BM_CalculateTotalCost)->Arg(10)->Arg(100)->Arg(400);
+
+// An unchanged book, as between ticks that move nothing the models read: every call but
+// the first is a hit, left with the walk and the slippage
+void BM_CalculateTotalCostMemoized(benchmark::State& state) {
+    PricedBook priced = pricedBookAtDepth(static_cast<size_t>(state.range(0)));
+    auto impactModel = std::make_shared<models::MarketImpactModel>();
+    auto costModel = std::make_shared<models::TransactionCostModel>(impactModel);
+    models::CostMemo memo(costModel);
+    double baseQuantity = 100000.0 / priced.stats.midprice;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            data::FillEstimate fill = priced.profile.walk(baseQuantity, true);
+            models::MemoizedCost cost = memo.evaluate(baseQuantity, true, priced.stats, fill, 0);
+            benchmark::DoNotOptimize(cost);
+        }
+    }
+}
+BENCHMARK(BM_CalculateTotalCostMemoized)->Arg(10)->Arg(100)->Arg(400);
+
+// Order sizes 0.2% apart, cycling through four times the buckets the memo holds: every
+// call is a miss, on about the book walk of BM_CalculateTotalCost
+void BM_CalculateTotalCostMemoMiss(benchmark::State& state) {
+    PricedBook priced = pricedBookAtDepth(static_cast<size_t>(state.range(0)));
+    auto impactModel = std::make_shared<models::MarketImpactModel>();
+    auto costModel = std::make_shared<models::TransactionCostModel>(impactModel);
+    models::CostMemo memo(costModel);
+    std::vector<double> sizes;
+    for (size_t i = 0; i < 256; ++i) {
+        sizes.push_back(100000.0 / priced.stats.midprice * (1.0 + 0.002 * static_cast<double>(i)));
+    }
+    size_t index = 0;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            double baseQuantity = sizes[index++ % sizes.size()];
+            data::FillEstimate fill = priced.profile.walk(baseQuantity, true);
+            models::MemoizedCost cost = memo.evaluate(baseQuantity, true, priced.stats, fill, 0);
+            benchmark::DoNotOptimize(cost);
+        }
+    }
+    models::CostMemoStats stats = memo.stats();
+    state.counters["hit_rate"] = static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses);
+}
+BENCHMARK(BM_CalculateTotalCostMemoMiss)->Arg(10)->Arg(100)->Arg(400);
+
+void BM_CalculateOptimalExecution(benchmark::State& state) {
+    PricedBook priced = pricedBookAtDepth(100);
+    models::MarketImpactModel impactModel;
+    int steps = static_cast<int>(state.range(0));
+    double baseQuantity = 100000.0 / priced.stats.midprice;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            std::vector<double> schedule =
+                impactModel.calculateOptimalExecution(baseQuantity, true, priced.stats, steps);
+            benchmark::DoNotOptimize(schedule.data());
+        }
+    }
+}
+BENCHMARK(BM_CalculateOptimalExecution)->Arg(10)->Arg(100)->Arg(1000);
+
+// A $1M buy routed over N venues: the recorded book at 400 levels, each venue's copy shifted
+// by a tick and thinned, with its own fee tier
+void BM_SmartOrderRoute(benchmark::State& state) {
+    PricedBook priced = pricedBookAtDepth(400);
+    data::OrderbookData book = booksAtDepth(400)[0];
+    models::MarketImpactModel impactModel;
+    size_t venues = static_cast<size_t>(state.range(0));
+    std::vector<models::VenueQuote> quotes(venues);
+    for (size_t v = 0; v < venues; ++v) {
+        data::OrderbookData venueBook = book;
+        for (size_t i = 0; i < venueBook.asks.count; ++i) {
+            venueBook.asks.prices[i] += 0.1 * static_cast<double>(v);
+            venueBook.asks.sizes[i] /= static_cast<double>(1 + v);
+        }
+        for (size_t i = 0; i < venueBook.bids.count; ++i) {
+            venueBook.bids.prices[i] -= 0.1 * static_cast<double>(v);
+            venueBook.bids.sizes[i] /= static_cast<double>(1 + v);
+        }
+        quotes[v].depth.assign(venueBook.asks, venueBook.bids);
+        quotes[v].takerFeeRate = models::FeeModel::forTier(static_cast<int>(v % 5)).takerFeeRate;
+        quotes[v].impact = impactModel.calculateCoefficients(priced.stats);
+        quotes[v].updatedNs = 1;
+    }
+    models::SmartOrderRouter router;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            const models::RouteAllocation& route = router.route(quotes.data(), venues, 1000000.0, true);
+            benchmark::DoNotOptimize(route.totalCost);
+        }
+    }
+}
+BENCHMARK(BM_SmartOrderRoute)->Arg(2)->Arg(4)->Arg(8);
+
+// Cost distribution of a 10-step schedule over K paths on every hardware thread, as the
+// simulator's risk thread runs it
+void BM_MonteCarloExecution(benchmark::State& state) {
+    PricedBook priced = pricedBookAtDepth(100);
+    models::MarketImpactModel impactModel;
+    double baseQuantity = 100000.0 / priced.stats.midprice;
+    std::vector<double> schedule =
+        impactModel.calculateOptimalExecution(baseQuantity, true, priced.stats, 10);
+    models::ExecutionProblem problem = impactModel.executionProblem(priced.stats, 10);
+
+    models::MonteCarloConfig config;
+    config.paths = static_cast<size_t>(state.range(0));
+    models::ExecutionMonteCarlo monteCarlo(config);
+    utils::WorkStealingPool pool;
+    for (auto _ : state) {
+        models::CostDistribution distribution = monteCarlo.simulate(schedule, problem, pool);
+        benchmark::DoNotOptimize(distribution);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["threads"] = static_cast<double>(pool.threadCount());
+}
+BENCHMARK(BM_MonteCarloExecution)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// One tick end to end as the simulator runs it: parse off the read buffer, copy into the
+// queue, process on the consumer side, then calibrate and price the order
+void BM_TickPipeline(benchmark::State& state) {
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < recordedMessages().size(); ++i) {
+        messages.push_back(messageAtDepth(i, static_cast<size_t>(state.range(0))));
+    }
+
+    auto impactModel = std::make_shared<models::MarketImpactModel>();
+    auto costModel = std::make_shared<models::TransactionCostModel>(impactModel);
+    models::SlippageCalibrator calibrator(costModel);
+    utils::PipelineLatency latency;
+    double baseQuantity = 0.0;
+
+    std::shared_ptr<data::OrderbookProcessor> processor;
+    processor = std::make_shared<data::OrderbookProcessor>([&](const data::OrderbookStats& stats) {
+        const data::DepthProfile& profile = processor->getDepthProfile();
+        baseQuantity = stats.midprice > 0.0 ? 100000.0 / stats.midprice : 0.0;
+        calibrator.observe(baseQuantity, true, stats, profile.walk(baseQuantity, true));
+        calibrator.observe(baseQuantity, false, stats, profile.walk(baseQuantity, false));
+        auto cost = costModel->calculateTotalCost(baseQuantity, true, stats, profile);
+        benchmark::DoNotOptimize(cost);
+        benchmark::DoNotOptimize(costModel->predictMakerProportion(baseQuantity, true, stats));
+    });
+    processor->setLatencyRecorder(&latency);
+
+    data::DispatcherConfig dispatcherConfig;
+    dispatcherConfig.dedicatedThread = false;
+    data::OrderbookDispatcher dispatcher(processor, dispatcherConfig);
+    dispatcher.start();
+
+    data::OrderbookData parsed;
+    size_t index = 0;
+    auto tick = [&]() {
+        const std::string& message = messages[index++ % messages.size()];
+        parsed.trace.readNs = utils::nowNanoseconds();
+        parsed.trace.parseStartNs = parsed.trace.readNs;
+        data::L2Parser::parse(message, parsed);
+        parsed.trace.parsedNs = utils::nowNanoseconds();
+        parsed.received_time = std::chrono::steady_clock::now();
+        dispatcher.submit(parsed);
+        dispatcher.drain(1);
+    };
+
+    // One lap of the queue first, so every slot has been written once
+    for (size_t i = 0; i < 2 * dispatcherConfig.queueCapacity; ++i) {
+        tick();
+    }
+    uint64_t allocated = 0;
+    {
+        AllocationCounter allocations(state);
+        for (auto _ : state) {
+            tick();
+        }
+        allocated = allocations.count();
+    }
+    dispatcher.stop();
+    if (allocated != 0) {
+        state.SkipWithError("The tick pipeline allocated");
+    }
+}
+BENCHMARK(BM_TickPipeline)->Arg(10)->Arg(400);
+
+} // namespace
+
+BENCHMARK_MAIN();
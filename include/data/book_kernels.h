@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Reduction kernels over the contiguous arrays of a book side
+ *
+ * The inline loops keep four independent accumulators so the compiler can map them onto
+ * SIMD lanes without reassociating a single floating-point sum. summarizeSide() is the
+ * fused per-side pass used for the orderbook statistics, with explicit AVX2 and NEON
+ * implementations selected at runtime.
+ */
+namespace kernels {
+
+/**
+ * @brief Aggregates of one book side, produced in a single pass
+ */
+struct SideSummary {
+    double totalSize = 0.0;       // Cumulative size over all levels
+    double totalNotional = 0.0;   // Cumulative price * size over all levels
+    double topSize = 0.0;         // Cumulative size over the top levels
+    double topNotional = 0.0;     // Cumulative notional over the top levels
+    std::array<double, kDepthBandCount> bandSize{};  // Size within each band of the best price
+
+    /**
+     * @brief Volume-weighted average price of the top levels
+     * @return Top-N VWAP, or 0 if there is no volume
+     */
+    double topVwap() const {
+        return topSize > 0.0 ? topNotional / topSize : 0.0;
+    }
+};
+
+/**
+ * @brief Fused pass over one side: totals, top-N VWAP inputs and depth bands together
+ *
+ * Uses the widest implementation the CPU supports, chosen once at startup.
+ *
+ * @param prices Price array, best price first
+ * @param sizes Size array
+ * @param count Number of levels
+ * @param topLevels Number of levels included in the top-N aggregates
+ * @param isAsk True for asks (bands above the best price), false for bids (below)
+ * @return Aggregates of the side
+ */
+SideSummary summarizeSide(const double* prices, const double* sizes, size_t count,
+                          size_t topLevels, bool isAsk);
+
+/**
+ * @brief Portable scalar implementation of summarizeSide()
+ */
+SideSummary summarizeSideScalar(const double* prices, const double* sizes, size_t count,
+                                size_t topLevels, bool isAsk);
+
+/**
+ * @brief Name of the implementation summarizeSide() dispatches to
+ * @return "avx2", "neon" or "scalar"
+ */
+const char* summarizeSideImplementation();
+
+/**
+ * @brief Sum of sizes
+ * @param sizes Size array
+ * @param count Number of levels
+ * @return Total size
+ */
+inline double sumSizes(const double* sizes, size_t count) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc[0] += sizes[i];
+        acc[1] += sizes[i + 1];
+        acc[2] += sizes[i + 2];
+        acc[3] += sizes[i + 3];
+    }
+    for (; i < count; ++i) {
+        acc[0] += sizes[i];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/**
+ * @brief Sum of price times size
+ * @param prices Price array
+ * @param sizes Size array
+ * @param count Number of levels
+ * @return Total notional
+ */
+inline double sumNotional(const double* prices, const double* sizes, size_t count) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc[0] += prices[i] * sizes[i];
+        acc[1] += prices[i + 1] * sizes[i + 1];
+        acc[2] += prices[i + 2] * sizes[i + 2];
+        acc[3] += prices[i + 3] * sizes[i + 3];
+    }
+    for (; i < count; ++i) {
+        acc[0] += prices[i] * sizes[i];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/**
+ * @brief Volume-weighted average price
+ * @param prices Price array
+ * @param sizes Size array
+ * @param count Number of levels
+ * @return VWAP, or 0 if there is no volume
+ */
+inline double vwap(const double* prices, const double* sizes, size_t count) {
+    double volume = sumSizes(sizes, count);
+    return volume > 0.0 ? sumNotional(prices, sizes, count) / volume : 0.0;
+}
+
+} // namespace kernels
+} // namespace data
+} // namespace trade_simulator 
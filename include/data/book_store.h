@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Level encoding of a book store file
+ */
+enum class BookStoreEncoding : uint32_t {
+    Delta = 1,  // Compact: levels as zigzag varint deltas in ticks and lots
+    Raw = 2     // Fixed int64 columns per book, readable in place (BookView)
+};
+
+/**
+ * @brief Configuration of a book store written by BookStoreWriter
+ */
+struct BookStoreConfig {
+    InstrumentSpec spec;                         // Fixed-point grid of prices and sizes
+    BookStoreEncoding encoding = BookStoreEncoding::Delta;
+    size_t booksPerBlock = 256;                  // Books per indexed block
+
+    // Default constructor
+    BookStoreConfig() = default;
+};
+
+/**
+ * @brief Zero-copy view of one book in a Raw-encoded store
+ *
+ * Prices are in ticks and sizes in lots of the store's InstrumentSpec; the arrays point
+ * into the mapped file and stay valid as long as the reader.
+ */
+struct BookView {
+    int64_t receivedTimeNs = 0;
+    int64_t seqId = -1;
+    int64_t prevSeqId = -1;
+    int32_t checksum = 0;
+    bool hasChecksum = false;
+    BookUpdateType updateType = BookUpdateType::Snapshot;
+    std::string_view timestamp;
+    std::string_view exchange;
+    std::string_view symbol;
+    const int64_t* askTicks = nullptr;
+    const int64_t* askLots = nullptr;
+    size_t askCount = 0;
+    const int64_t* bidTicks = nullptr;
+    const int64_t* bidLots = nullptr;
+    size_t bidCount = 0;
+};
+
+/**
+ * @brief Writes books to a columnar book store file
+ *
+ * Books are grouped into blocks of one instrument each; every block starts with the
+ * instrument strings, and a trailing index holds the first and last receive time and the
+ * offset of every block. Prices and sizes are stored as int64 ticks and lots. In Delta
+ * encoding each level's price is the zigzag varint difference to the previous level (the
+ * best price to the previous book's best), which shrinks a 400-level book to little more
+ * than a byte per value. The file layout is little-endian.
+ */
+class BookStoreWriter {
+public:
+    /**
+     * @brief Constructor
+     * @param path Store file; created or truncated
+     * @param config Encoding and fixed-point grid
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    BookStoreWriter(const std::string& path, const BookStoreConfig& config);
+
+    /**
+     * @brief Destructor; closes the store if close() was not called
+     */
+    ~BookStoreWriter();
+
+    BookStoreWriter(const BookStoreWriter&) = delete;
+    BookStoreWriter& operator=(const BookStoreWriter&) = delete;
+
+    /**
+     * @brief Append a book
+     * @param book Snapshot or delta; its received_time is stored as the timestamp
+     */
+    void append(const OrderbookData& book);
+
+    /**
+     * @brief Write the last block and the index and close the file
+     */
+    void close();
+
+    /**
+     * @brief Get the number of books written
+     * @return Book count
+     */
+    uint64_t bookCount() const { return bookCount_; }
+
+    /**
+     * @brief Get the number of prices and sizes that were not on the fixed-point grid
+     * @return Values rounded to the nearest tick or lot
+     */
+    uint64_t roundedValues() const { return roundedValues_; }
+
+private:
+    BookStoreConfig config_;
+    std::FILE* file_ = nullptr;
+    uint64_t fileOffset_ = 0;
+    uint64_t bookCount_ = 0;
+    uint64_t roundedValues_ = 0;
+
+    // Block being built
+    std::vector<uint8_t> block_;
+    SymbolId blockExchange_ = kNoSymbol;
+    SymbolId blockSymbol_ = kNoSymbol;
+    uint32_t blockBooks_ = 0;
+    int64_t blockFirstNs_ = 0;
+    int64_t blockLastNs_ = 0;
+
+    // Delta state, reset at every block
+    int64_t previousNs_ = 0;
+    int64_t previousSeqId_ = 0;
+    int64_t previousAskTop_ = 0;
+    int64_t previousBidTop_ = 0;
+
+    // Index entries of the written blocks
+    struct IndexEntry {
+        int64_t firstNs;
+        int64_t lastNs;
+        uint64_t offset;
+        uint64_t bookCount;
+    };
+    std::vector<IndexEntry> index_;
+
+    // Scratch of converted levels
+    TickBookSide askTicks_;
+    TickBookSide bidTicks_;
+
+    void startBlock(const OrderbookData& book);
+    void flushBlock();
+    void appendDelta(const OrderbookData& book, int64_t receivedNs);
+    void appendRaw(const OrderbookData& book, int64_t receivedNs);
+    void convert(const BookSide& side, TickBookSide& out);
+    void write(const void* data, size_t size);
+};
+
+/**
+ * @brief Memory-mapped reader of a book store file
+ *
+ * Books are read sequentially; seek() jumps to the block containing a receive time
+ * with a binary search of the index.
+ */
+class BookStoreReader {
+public:
+    /**
+     * @brief Constructor
+     * @param path Store file
+     * @throws std::runtime_error if the file cannot be mapped or is not a book store
+     */
+    explicit BookStoreReader(const std::string& path);
+
+    /**
+     * @brief Destructor; unmaps the store
+     */
+    ~BookStoreReader();
+
+    BookStoreReader(const BookStoreReader&) = delete;
+    BookStoreReader& operator=(const BookStoreReader&) = delete;
+
+    /**
+     * @brief Check whether a file starts like a book store
+     * @param path File to check
+     * @return True if the file has the book store magic
+     */
+    static bool isBookStore(const std::string& path);
+
+    /**
+     * @brief Read the next book
+     * @param book Output book, with prices and sizes converted back from the grid
+     * @return False at the end of the store
+     * @throws std::runtime_error if a block is corrupt
+     */
+    bool next(OrderbookData& book);
+
+    /**
+     * @brief Read the next book in place (Raw encoding only)
+     * @param view Output view into the mapping
+     * @return False at the end of the store
+     * @throws std::logic_error if the store is not Raw-encoded
+     */
+    bool nextView(BookView& view);
+
+    /**
+     * @brief Continue reading at the first block whose last book is at or after a time
+     * @param receivedTimeNs Receive time in nanoseconds
+     */
+    void seek(int64_t receivedTimeNs);
+
+    /**
+     * @brief Go back to the first book
+     */
+    void rewind();
+
+    BookStoreEncoding encoding() const { return encoding_; }
+    const InstrumentSpec& spec() const { return spec_; }
+    uint64_t bookCount() const { return bookCount_; }
+    size_t blockCount() const { return blockCount_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    BookStoreEncoding encoding_ = BookStoreEncoding::Delta;
+    InstrumentSpec spec_;
+    uint64_t bookCount_ = 0;
+    size_t blockCount_ = 0;
+    const uint8_t* index_ = nullptr;
+
+    // Read position
+    size_t block_ = 0;
+    const uint8_t* cursor_ = nullptr;
+    const uint8_t* blockEnd_ = nullptr;
+    uint32_t booksLeft_ = 0;
+    std::string_view exchange_;
+    std::string_view symbol_;
+    SymbolId exchangeId_ = kNoSymbol;  // Interned once per block
+    SymbolId symbolId_ = kNoSymbol;
+
+    // Delta state, reset at every block
+    int64_t previousNs_ = 0;
+    int64_t previousSeqId_ = 0;
+    int64_t previousAskTop_ = 0;
+    int64_t previousBidTop_ = 0;
+
+    bool enterNextBlock();
+    void readDelta(OrderbookData& book);
+    void readRawView(BookView& view);
+};
+
+/**
+ * @brief Convert a feed log written by FeedRecorder into a book store
+ * @param feedLogPath Feed log to read
+ * @param storePath Store to write
+ * @param config Encoding and fixed-point grid
+ * @return Number of books written; unparsable messages are skipped
+ */
+uint64_t convertFeedLog(const std::string& feedLogPath, const std::string& storePath,
+                        const BookStoreConfig& config);
+
+} // namespace data
+} // namespace trade_simulator 
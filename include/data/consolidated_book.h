@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+// Venues merged into one consolidated book, and levels kept of each
+constexpr size_t kMaxVenues = 8;
+constexpr size_t kVenueDepth = 64;
+
+/**
+ * @brief Top levels of one venue's book
+ *
+ * Plain arrays rather than BookSide, so a venue can publish its depth through a SeqLock
+ * for other threads to consolidate.
+ */
+struct VenueDepth {
+    std::array<double, kVenueDepth> askPrices{};
+    std::array<double, kVenueDepth> askSizes{};
+    std::array<double, kVenueDepth> bidPrices{};
+    std::array<double, kVenueDepth> bidSizes{};
+    size_t askCount = 0;
+    size_t bidCount = 0;
+
+    /**
+     * @brief Copy the best kVenueDepth levels of each side
+     * @param asks Ask side, best first
+     * @param bids Bid side, best first
+     */
+    void assign(const BookSide& asks, const BookSide& bids);
+};
+
+/**
+ * @brief One side of the consolidated book: every venue's levels in price order
+ */
+struct ConsolidatedSide {
+    static constexpr size_t kMaxLevels = kMaxVenues * kVenueDepth;
+
+    alignas(64) std::array<double, kMaxLevels> prices;
+    alignas(64) std::array<double, kMaxLevels> sizes;
+    std::array<uint8_t, kMaxLevels> venues;  // Venue of each level
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+/**
+ * @brief Best prices across venues
+ */
+struct ConsolidatedTop {
+    double bestBid = 0.0;
+    double bestAsk = 0.0;
+    double bidSize = 0.0;   // Size at the best bid, summed over the venues quoting it
+    double askSize = 0.0;
+    int bidVenue = -1;      // First venue at the best bid, -1 without bids
+    int askVenue = -1;
+
+    double midprice() const { return bidVenue >= 0 && askVenue >= 0 ? (bestBid + bestAsk) / 2.0 : 0.0; }
+};
+
+/**
+ * @brief Book consolidated from the depth of several venues
+ *
+ * merge() is a k-way merge of the venues' sorted SoA arrays: each side keeps a cursor per
+ * venue and repeatedly appends the best head. With at most kMaxVenues venues the best
+ * head is found by a scan of the cursors, which is cheaper than a heap at that size, so
+ * a merge costs about levels * venues comparisons. Levels at the same price stay
+ * separate, tagged with their venue. The consolidated book may be crossed across venues.
+ */
+class ConsolidatedBook {
+public:
+    /**
+     * @brief Rebuild both sides from the venues' depth
+     * @param venues Depth of each venue; nullptr skips a venue
+     * @param count Venues, at most kMaxVenues
+     */
+    void merge(const VenueDepth* const* venues, size_t count);
+
+    const ConsolidatedSide& asks() const { return asks_; }
+    const ConsolidatedSide& bids() const { return bids_; }
+
+    /**
+     * @brief Get the best prices and the size quoted at them
+     * @return Top of the consolidated book
+     */
+    const ConsolidatedTop& top() const { return top_; }
+
+private:
+    ConsolidatedSide asks_;
+    ConsolidatedSide bids_;
+    ConsolidatedTop top_;
+
+    /**
+     * @brief Merge one side of the venues
+     * @param ascending True for asks
+     */
+    static void mergeSide(const VenueDepth* const* venues, size_t count, bool ascending,
+                          ConsolidatedSide& side);
+};
+
+} // namespace data
+} // namespace trade_simulator
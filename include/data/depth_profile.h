@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Result of walking one side of the book to fill a quantity
+ */
+struct FillEstimate {
+    double vwap = 0.0;            // Average price of the filled part
+    double notional = 0.0;        // Sum of price * size of the filled part
+    double filledSize = 0.0;      // Size the book can fill
+    double residualSize = 0.0;    // Size left over when the book runs out
+    double worstPrice = 0.0;      // Price of the last level touched
+    size_t levelsConsumed = 0;    // Levels touched, including a partially filled one
+
+    /**
+     * @brief Check whether the book was deep enough for the whole quantity
+     * @return True if nothing is left over
+     */
+    bool complete() const { return residualSize <= 0.0; }
+};
+
+/**
+ * @brief Cumulative size and notional per level of both sides of a book
+ *
+ * Any fill query is a binary search over the cumulative sizes plus one partial level, so
+ * many what-if quantities per update cost O(log depth) each instead of a scan of the book.
+ *
+ * update() only notes the first level of each side the book's last update changed. The
+ * prefix sums of a side are brought up to date by the first query of that side, from the
+ * lowest level changed since the previous query: a delta at the top of the book still
+ * costs its depth, but one deeper in the book or on a side nothing queries costs nothing.
+ * A profile following a book reads the book's sides on those queries, so the book must
+ * outlive it and be queried on the thread that updates it; copies are brought up to date
+ * first and stand alone.
+ */
+class DepthProfile {
+public:
+    // Default constructor
+    DepthProfile() = default;
+
+    /**
+     * @brief Copy constructor; the copy holds the source's up-to-date prefix sums
+     * @param other Profile to copy
+     */
+    DepthProfile(const DepthProfile& other);
+
+    /**
+     * @brief Copy assignment; the copy holds the source's up-to-date prefix sums
+     * @param other Profile to copy
+     * @return This profile
+     */
+    DepthProfile& operator=(const DepthProfile& other);
+
+    /**
+     * @brief Rebuild the prefix sums from a book now
+     * @param asks Ask side, sorted ascending
+     * @param bids Bid side, sorted descending
+     */
+    void rebuild(const BookSide& asks, const BookSide& bids);
+
+    /**
+     * @brief Follow a book after an update, deferring the prefix sums to the next query
+     * @param asks Ask side of the book, sorted ascending
+     * @param bids Bid side of the book, sorted descending
+     * @param firstAsk First ask level the update changed (L2Book::firstChangedLevel)
+     * @param firstBid First bid level the update changed
+     */
+    void update(const BookSide& asks, const BookSide& bids, size_t firstAsk, size_t firstBid);
+
+    /**
+     * @brief Fill a market order against the book
+     * @param quantity Order size in base units
+     * @param isBuy True to walk the asks, false to walk the bids
+     * @return Fill estimate
+     */
+    FillEstimate walk(double quantity, bool isBuy) const;
+
+    /**
+     * @brief Get the midprice of the book the profile was built from
+     * @return Midprice, or 0 if a side was empty
+     */
+    double midprice() const { return midprice_; }
+
+    /**
+     * @brief Get the total size resting on a side
+     * @param isBuy True for the asks, false for the bids
+     * @return Total size
+     */
+    double totalSize(bool isBuy) const;
+
+    /**
+     * @brief Get the number of levels on a side
+     * @param isBuy True for the asks, false for the bids
+     * @return Number of levels
+     */
+    size_t depth(bool isBuy) const { return current(isBuy).count; }
+
+private:
+    /**
+     * @brief Prices and prefix sums of one side; cum*[i] covers levels [0, i)
+     */
+    struct SideProfile {
+        std::array<double, kMaxBookDepth> prices;
+        std::array<double, kMaxBookDepth + 1> cumSize;
+        std::array<double, kMaxBookDepth + 1> cumNotional;
+        size_t count = 0;
+
+        // Book side followed, and the first level whose prefix sums are out of date
+        const BookSide* source = nullptr;
+        size_t staleFrom = kMaxBookDepth;
+
+        SideProfile() : cumSize{}, cumNotional{} {}
+    };
+
+    // Brought up to date by const queries
+    mutable SideProfile asks_;
+    mutable SideProfile bids_;
+    double midprice_ = 0.0;
+
+    /**
+     * @brief Get a side with its prefix sums up to date
+     * @param isBuy True for the asks, false for the bids
+     * @return Side profile
+     */
+    const SideProfile& current(bool isBuy) const;
+
+    static void rebuildSide(const BookSide& side, size_t from, SideProfile& profile);
+    static FillEstimate walkSide(const SideProfile& profile, double quantity);
+};
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "data/orderbook_types.h"
+#include "utils/timestamp.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Source and message schema of an orderbook feed
+ */
+enum class Venue : uint8_t {
+    GoQuant,  // GoQuant L2 gateway, one normalized schema for the venues it proxies
+    Okx,      // OKX v5 public "books" channel
+    Binance,  // Binance USD-M futures partial book depth
+    Bybit,    // Bybit v5 public linear orderbook
+    Deribit   // Deribit JSON-RPC "book" subscription
+};
+
+/**
+ * @brief Get the display name of a venue, as decoded books report their exchange
+ * @param venue Venue
+ * @return Name such as "Binance"
+ */
+const char* venueName(Venue venue);
+
+/**
+ * @brief Look up a venue by name, ignoring case
+ * @param name "GoQuant", "OKX", "Binance", "Bybit" or "Deribit"
+ * @return Venue, or nothing for an unknown name
+ */
+std::optional<Venue> parseVenue(std::string_view name);
+
+/**
+ * @brief Recognize the venue of a message from its shape
+ *
+ * Only looks at the first few hundred bytes. Acknowledgements and other control messages
+ * that do not identify their venue are not recognized.
+ *
+ * @param message Raw message
+ * @return Venue, or nothing if the message could be from any venue
+ */
+std::optional<Venue> detectVenue(std::string_view message);
+
+/**
+ * @brief Get the tick size, lot size and size unit of a venue's instrument
+ *
+ * Knows the BTC and ETH perpetuals of every venue; other instruments get the venue's size
+ * unit with generic tick and lot sizes, and should set FeedConfig::spec explicitly.
+ *
+ * @param venue Venue
+ * @param instrument Venue instrument name, e.g. "BTCUSDT"
+ * @return Instrument metadata
+ */
+InstrumentSpec defaultInstrumentSpec(Venue venue, std::string_view instrument);
+
+/**
+ * @brief Name a venue uses for the perpetual of a currency pair
+ * @param venue Venue
+ * @param symbol Pair as "BASE-QUOTE", e.g. "BTC-USDT"
+ * @return Instrument name, e.g. "BTC-USDT-SWAP" on OKX and "BTCUSDT" on Binance
+ */
+std::string perpetualInstrument(Venue venue, std::string_view symbol);
+
+/**
+ * @brief Name a venue uses for an instrument given either as a pair or by its own name
+ * @param venue Venue
+ * @param name Pair quoted in USD, USDT or USDC, e.g. "BTC-USDT", which is taken to mean
+ *             its perpetual; any other name is the venue's own and kept as it is
+ * @return Instrument name, e.g. "BTC-USDT-SWAP" for "BTC-USDT" on OKX
+ */
+std::string venueInstrument(Venue venue, std::string_view name);
+
+/**
+ * @brief Outcome of decoding one message
+ */
+enum class DecodeResult {
+    Book,     // The book was filled in
+    Ignored   // Not an orderbook message (subscription acknowledgement, heartbeat, ...)
+};
+
+/**
+ * @brief Base of the venue message decoders, bound at compile time
+ *
+ * Each venue derives with itself as the template argument and implements
+ * DecodeResult decodeMessage(std::string_view, OrderbookData&), walking its schema with a
+ * JsonCursor. decode() resets the book, calls it without virtual dispatch and then
+ * normalizes sizes to base units, recording the contract value a checksum is taken in. The level loops are instantiated per venue layout, so
+ * nothing is dispatched per level.
+ *
+ * @tparam Derived Venue decoder
+ */
+template <typename Derived>
+class VenueDecoder {
+public:
+    /**
+     * @brief Constructor
+     * @param spec Size unit of the venue's levels; with lookupSpecs, the unit used until
+     *             the first instrument is seen
+     * @param lookupSpecs Take each instrument's spec from defaultInstrumentSpec(), for
+     *                    logs whose instrument is not known up front
+     */
+    explicit VenueDecoder(const InstrumentSpec& spec, bool lookupSpecs = false)
+        : spec_(spec), lookupSpecs_(lookupSpecs) {}
+
+    /**
+     * @brief Decode a message into a book
+     * @param message Raw message
+     * @param book Output book; reset first, sizes in base units, exchange time parsed
+     * @return Whether the message was a book
+     * @throws std::runtime_error if a book message is malformed
+     */
+    DecodeResult decode(std::string_view message, OrderbookData& book) {
+        book.asks.clear();
+        book.bids.clear();
+        book.update_type = BookUpdateType::Snapshot;
+        book.seq_id = -1;
+        book.prev_seq_id = -1;
+        book.has_checksum = false;
+        book.checksum_size_unit = 1.0;
+
+        DecodeResult result = static_cast<Derived&>(*this).decodeMessage(message, book);
+        if (result == DecodeResult::Book) {
+            book.exchange_time_ns = utils::parseTimestampNs(book.timestamp.view());
+            if (lookupSpecs_ && book.symbol != specSymbol_) {
+                specSymbol_ = book.symbol;
+                spec_ = defaultInstrumentSpec(Derived::kVenue, symbolName(book.symbol));
+            }
+            if (!spec_.hasBaseSizes()) {
+                normalizeSizes(book.asks, spec_);
+                normalizeSizes(book.bids, spec_);
+                // Exchange checksums cover the venue's own size strings: contracts are
+                // recovered from base units when checking, quote sizes cannot be
+                if (spec_.sizeUnit == SizeUnit::Contracts) {
+                    book.checksum_size_unit = spec_.contractValue;
+                } else {
+                    book.has_checksum = false;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get the metadata sizes are normalized with
+     * @return Current instrument spec
+     */
+    const InstrumentSpec& spec() const { return spec_; }
+
+private:
+    InstrumentSpec spec_;
+    bool lookupSpecs_;
+    SymbolId specSymbol_ = kNoSymbol;
+};
+
+/**
+ * @brief GoQuant gateway messages, decoded by L2Parser
+ */
+class GoQuantDecoder : public VenueDecoder<GoQuantDecoder> {
+public:
+    static constexpr Venue kVenue = Venue::GoQuant;
+    using VenueDecoder::VenueDecoder;
+    DecodeResult decodeMessage(std::string_view message, OrderbookData& book);
+};
+
+/**
+ * @brief OKX v5 "books" pushes: {"arg":{"instId"},"action","data":[{"asks","bids","ts",
+ *        "checksum","prevSeqId","seqId"}]}
+ */
+class OkxDecoder : public VenueDecoder<OkxDecoder> {
+public:
+    static constexpr Venue kVenue = Venue::Okx;
+    using VenueDecoder::VenueDecoder;
+    DecodeResult decodeMessage(std::string_view message, OrderbookData& book);
+};
+
+/**
+ * @brief Binance futures partial depth: {"e":"depthUpdate","E","s","u","pu","b","a"};
+ *        each message is the top of the book, so it is decoded as a snapshot
+ */
+class BinanceDecoder : public VenueDecoder<BinanceDecoder> {
+public:
+    static constexpr Venue kVenue = Venue::Binance;
+    using VenueDecoder::VenueDecoder;
+    DecodeResult decodeMessage(std::string_view message, OrderbookData& book);
+};
+
+/**
+ * @brief Bybit v5 orderbook: {"topic","type":"snapshot"|"delta","ts","data":{"s","b","a","u"}}
+ */
+class BybitDecoder : public VenueDecoder<BybitDecoder> {
+public:
+    static constexpr Venue kVenue = Venue::Bybit;
+    using VenueDecoder::VenueDecoder;
+    DecodeResult decodeMessage(std::string_view message, OrderbookData& book);
+};
+
+/**
+ * @brief Deribit book notifications: {"method":"subscription","params":{"data":{"type",
+ *        "timestamp","instrument_name","change_id","prev_change_id","bids","asks"}}}, with
+ *        levels as [action, price, amount]
+ */
+class DeribitDecoder : public VenueDecoder<DeribitDecoder> {
+public:
+    static constexpr Venue kVenue = Venue::Deribit;
+    using VenueDecoder::VenueDecoder;
+    DecodeResult decodeMessage(std::string_view message, OrderbookData& book);
+};
+
+/**
+ * @brief Decoder of one feed: the venue's decoder behind a single dispatch per message
+ *
+ * Built for a venue, it decodes that venue's schema only. Default-constructed, it
+ * recognizes the venue from the first message that identifies one (see detectVenue()) and
+ * ignores messages until then, e.g. the subscription acknowledgements at the start of a
+ * recording; instrument specs then come from defaultInstrumentSpec().
+ */
+class FeedDecoder {
+public:
+    /**
+     * @brief Constructor for recordings of unknown venue
+     */
+    FeedDecoder() = default;
+
+    /**
+     * @brief Constructor for a known venue
+     * @param venue Venue whose schema the messages follow
+     * @param spec Size unit of the levels
+     */
+    FeedDecoder(Venue venue, const InstrumentSpec& spec);
+
+    /**
+     * @brief Decode a message into a book
+     * @param message Raw message
+     * @param book Output book
+     * @return Whether the message was a book
+     * @throws std::runtime_error if a book message is malformed
+     */
+    DecodeResult decode(std::string_view message, OrderbookData& book) {
+        if (std::holds_alternative<std::monostate>(decoders_) && !detect(message)) {
+            return DecodeResult::Ignored;
+        }
+        return std::visit([&](auto& decoder) -> DecodeResult {
+            if constexpr (std::is_same_v<std::decay_t<decltype(decoder)>, std::monostate>) {
+                return DecodeResult::Ignored;
+            } else {
+                return decoder.decode(message, book);
+            }
+        }, decoders_);
+    }
+
+    /**
+     * @brief Get the venue being decoded
+     * @return Venue, or nothing while it is still being detected
+     */
+    std::optional<Venue> venue() const;
+
+private:
+    std::variant<std::monostate, GoQuantDecoder, OkxDecoder, BinanceDecoder, BybitDecoder,
+                 DeribitDecoder> decoders_;
+
+    void select(Venue venue, const InstrumentSpec& spec, bool lookupSpecs);
+    bool detect(std::string_view message);
+};
+
+} // namespace data
+} // namespace trade_simulator
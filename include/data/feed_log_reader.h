@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief One message of a feed log
+ */
+struct FeedLogRecord {
+    std::chrono::nanoseconds receivedTime{0};  // Steady-clock receive time when recorded
+    std::string_view message;                  // Raw bytes, pointing into the mapping
+};
+
+/**
+ * @brief Read-only memory mapping of a log written by FeedRecorder
+ *
+ * Records are returned as views into the mapping, so iterating a log copies nothing.
+ */
+class FeedLogReader {
+public:
+    /**
+     * @brief Constructor
+     * @param path Log file
+     * @throws std::runtime_error if the file cannot be mapped or is not a feed log
+     */
+    explicit FeedLogReader(const std::string& path);
+
+    /**
+     * @brief Destructor; unmaps the log
+     */
+    ~FeedLogReader();
+
+    FeedLogReader(const FeedLogReader&) = delete;
+    FeedLogReader& operator=(const FeedLogReader&) = delete;
+
+    /**
+     * @brief Read the next record
+     * @param record Output record
+     * @return False at the end of the log or at a truncated trailing record
+     */
+    bool next(FeedLogRecord& record);
+
+    /**
+     * @brief Go back to the first record
+     */
+    void rewind();
+
+    /**
+     * @brief Get the size of the log
+     * @return Size in bytes
+     */
+    size_t sizeBytes() const { return size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+};
+
+} // namespace data
+} // namespace trade_simulator 
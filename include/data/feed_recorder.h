@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Appends raw feed messages with their receive time to a binary log
+ *
+ * Layout: the 8-byte magic "GQFEED01", then one record per message:
+ *
+ *     uint64 receive time in nanoseconds (steady clock)
+ *     uint32 message length in bytes
+ *     message bytes
+ *
+ * Integers are little-endian. Messages are stored exactly as received so that parsing
+ * and modeling can be replayed bit for bit (see ReplayFeedSource).
+ */
+class FeedRecorder {
+public:
+    static constexpr char kMagic[8] = {'G', 'Q', 'F', 'E', 'E', 'D', '0', '1'};
+
+    /**
+     * @brief Constructor
+     * @param path Log file; created or truncated
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit FeedRecorder(const std::string& path);
+
+    /**
+     * @brief Destructor; flushes and closes the log
+     */
+    ~FeedRecorder();
+
+    FeedRecorder(const FeedRecorder&) = delete;
+    FeedRecorder& operator=(const FeedRecorder&) = delete;
+
+    /**
+     * @brief Append a message
+     * @param message Raw message bytes
+     * @param receivedTime Time the message was received
+     */
+    void record(std::string_view message, std::chrono::steady_clock::time_point receivedTime);
+
+    /**
+     * @brief Flush buffered records to the file
+     */
+    void flush();
+
+    /**
+     * @brief Get the number of messages recorded
+     * @return Message count
+     */
+    uint64_t recordedMessages() const;
+
+private:
+    // Large stdio buffer so recording costs a memcpy per message, not a syscall
+    static constexpr size_t kWriteBufferBytes = 1 << 20;
+
+    std::FILE* file_ = nullptr;
+    uint64_t recordedMessages_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace data
+} // namespace trade_simulator 
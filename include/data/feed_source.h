@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Source of orderbook updates for one selected instrument
+ *
+ * Implementations deliver updates from a single thread at a time, so the consumer can
+ * treat the callback as the only producer of its queue.
+ */
+class FeedSource {
+public:
+    /**
+     * @brief Callback type for orderbook updates
+     *
+     * The book passed to the callback is reused for the next update; copy it to keep it.
+     */
+    using OrderbookCallback = std::function<void(const OrderbookData&)>;
+
+    virtual ~FeedSource() = default;
+
+    /**
+     * @brief Start delivering updates
+     */
+    virtual void start() = 0;
+
+    /**
+     * @brief Stop delivering updates; no callback runs once this returns
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Switch to another instrument; updates of the previous one are no longer delivered
+     * @param exchange Exchange name, e.g. "OKX"
+     * @param instrument Instrument name, e.g. "BTC-USDT-SWAP"
+     */
+    virtual void selectInstrument(const std::string& exchange, const std::string& instrument) = 0;
+
+    /**
+     * @brief Ask for a fresh snapshot after the book lost sync
+     */
+    virtual void resubscribe() = 0;
+
+    /**
+     * @brief Check if the source is delivering updates
+     * @return True if connected or replaying
+     */
+    virtual bool isConnected() const = 0;
+};
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstdint>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Forward-only cursor over a JSON document
+ *
+ * The cursor walks the text exactly once and never builds a DOM. String values are
+ * returned as views into the original message (escape sequences are skipped over but
+ * not decoded), and numbers are converted in place with std::from_chars, so no
+ * temporary strings are created.
+ *
+ * Objects and arrays are iterated with the begin/next pairs:
+ * @code
+ * for (bool more = cursor.beginObject(); more; more = cursor.nextMember()) {
+ *     std::string_view key = cursor.readKey();
+ *     ...
+ * }
+ * @endcode
+ */
+class JsonCursor {
+public:
+    /**
+     * @brief Constructor
+     * @param text JSON text; must outlive the cursor and any views it returns
+     */
+    explicit JsonCursor(std::string_view text)
+        : pos_(text.data()), end_(text.data() + text.size()) {}
+
+    /**
+     * @brief Check whether only whitespace is left
+     * @return True if the end of the text has been reached
+     */
+    bool atEnd() {
+        skipWhitespace();
+        return pos_ == end_;
+    }
+
+    /**
+     * @brief Peek at the next significant character
+     * @return The next non-whitespace character, or '\0' at the end of the text
+     */
+    char peek() {
+        skipWhitespace();
+        return pos_ != end_ ? *pos_ : '\0';
+    }
+
+    /**
+     * @brief Consume the given character if it is next
+     * @param c Character to match
+     * @return True if the character was consumed
+     */
+    bool consumeIf(char c) {
+        if (peek() == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Consume the given character or fail
+     * @param c Character that must come next
+     */
+    void expect(char c) {
+        if (!consumeIf(c)) {
+            fail("unexpected character");
+        }
+    }
+
+    /**
+     * @brief Enter an object
+     * @return True if the object has at least one member
+     */
+    bool beginObject() {
+        expect('{');
+        return !consumeIf('}');
+    }
+
+    /**
+     * @brief Advance to the next object member after a value has been read
+     * @return True if another member follows, false at the closing brace
+     */
+    bool nextMember() {
+        if (consumeIf(',')) {
+            return true;
+        }
+        expect('}');
+        return false;
+    }
+
+    /**
+     * @brief Enter an array
+     * @return True if the array has at least one element
+     */
+    bool beginArray() {
+        expect('[');
+        return !consumeIf(']');
+    }
+
+    /**
+     * @brief Advance to the next array element after a value has been read
+     * @return True if another element follows, false at the closing bracket
+     */
+    bool nextElement() {
+        if (consumeIf(',')) {
+            return true;
+        }
+        expect(']');
+        return false;
+    }
+
+    /**
+     * @brief Read an object key and the following colon
+     * @return View of the key
+     */
+    std::string_view readKey() {
+        std::string_view key = readString();
+        expect(':');
+        return key;
+    }
+
+    /**
+     * @brief Read a string value
+     * @return View of the raw string contents, without the quotes
+     */
+    std::string_view readString() {
+        expect('"');
+        const char* begin = pos_;
+        while (pos_ != end_ && *pos_ != '"') {
+            // Skip over the escaped character so an escaped quote does not end the string
+            pos_ += (*pos_ == '\\' && pos_ + 1 != end_) ? 2 : 1;
+        }
+        if (pos_ == end_) {
+            fail("unterminated string");
+        }
+        std::string_view value(begin, static_cast<size_t>(pos_ - begin));
+        ++pos_;
+        return value;
+    }
+
+    /**
+     * @brief Read a number, either bare or quoted as exchanges usually send prices
+     * @return Parsed value
+     */
+    double readNumber() {
+        return readArithmetic<double>();
+    }
+
+    /**
+     * @brief Read an integer, either bare or quoted
+     * @return Parsed value
+     */
+    int64_t readInteger() {
+        return readArithmetic<int64_t>();
+    }
+
+    /**
+     * @brief Read a string or a bare scalar as text, e.g. a timestamp sent either way
+     * @return View of the string contents or of the number/literal token
+     */
+    std::string_view readScalarText() {
+        if (peek() == '"') {
+            return readString();
+        }
+        const char* begin = pos_;
+        while (pos_ != end_ && !isDelimiter(*pos_)) {
+            ++pos_;
+        }
+        if (pos_ == begin) {
+            fail("expected a scalar");
+        }
+        return std::string_view(begin, static_cast<size_t>(pos_ - begin));
+    }
+
+    /**
+     * @brief Skip over one complete value of any type
+     */
+    void skipValue() {
+        switch (peek()) {
+            case '"':
+                readString();
+                break;
+            case '{':
+                for (bool more = beginObject(); more; more = nextMember()) {
+                    readKey();
+                    skipValue();
+                }
+                break;
+            case '[':
+                for (bool more = beginArray(); more; more = nextElement()) {
+                    skipValue();
+                }
+                break;
+            default:
+                // Number, true, false or null
+                while (pos_ != end_ && !isDelimiter(*pos_)) {
+                    ++pos_;
+                }
+                break;
+        }
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+
+    static bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static bool isDelimiter(char c) {
+        return c == ',' || c == '}' || c == ']' || isWhitespace(c);
+    }
+
+    void skipWhitespace() {
+        while (pos_ != end_ && isWhitespace(*pos_)) {
+            ++pos_;
+        }
+    }
+
+    template <typename T>
+    T readArithmetic() {
+        bool quoted = consumeIf('"');
+        T value{};
+        auto [ptr, ec] = std::from_chars(pos_, end_, value);
+        if (ec != std::errc()) {
+            fail("invalid number");
+        }
+        pos_ = ptr;
+        if (quoted && (pos_ == end_ || *pos_++ != '"')) {
+            fail("invalid quoted number");
+        }
+        return value;
+    }
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string("JSON parse error: ") + what);
+    }
+};
+
+} // namespace data
+} // namespace trade_simulator
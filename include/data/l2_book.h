@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Outcome of applying an update to an L2Book
+ */
+enum class BookApplyResult {
+    Applied,           // The book reflects the update
+    SequenceGap,       // prevSeqId did not match; the book needs a fresh snapshot
+    ChecksumMismatch,  // The book disagrees with the exchange checksum; needs a snapshot
+    AwaitingSnapshot   // Delta dropped because the book is not synchronized
+};
+
+/**
+ * @brief Orderbook maintained in place from snapshots and L2 deltas
+ *
+ * Deltas insert, modify or delete single levels (size 0 deletes), located by binary
+ * search in the sorted SoA arrays. Each side keeps running size and notional totals that
+ * are adjusted by the changed levels only, so the per-update cost is proportional to the
+ * number of changed levels rather than the book depth. The totals are recomputed exactly
+ * on snapshots and every kTotalsRecomputeInterval deltas to bound rounding drift.
+ *
+ * Sequence numbers detect gaps and the optional OKX-style CRC32 checksum detects
+ * divergence; either leaves the book unsynchronized until the next snapshot.
+ */
+class L2Book {
+public:
+    /**
+     * @brief Running aggregates of one side
+     */
+    struct SideTotals {
+        double size = 0.0;
+        double notional = 0.0;
+    };
+
+    /**
+     * @brief Apply a snapshot or a delta
+     * @param update Parsed update; for deltas its levels are the changed levels
+     * @return Outcome of the update
+     */
+    BookApplyResult apply(const OrderbookData& update);
+
+    /**
+     * @brief Discard the book and wait for the next snapshot
+     */
+    void reset();
+
+    /**
+     * @brief Check whether the book is synchronized with the exchange
+     * @return True after a snapshot and as long as no gap or mismatch was seen
+     */
+    bool isSynced() const { return synced_; }
+
+    const BookSide& asks() const { return asks_; }
+    const BookSide& bids() const { return bids_; }
+    const SideTotals& askTotals() const { return askTotals_; }
+    const SideTotals& bidTotals() const { return bidTotals_; }
+
+    /**
+     * @brief Get the size resting at a price
+     * @param isBid True for the bid side
+     * @param price Level price
+     * @return Size at the price, 0 if the side has no such level
+     */
+    double sizeAt(bool isBid, double price) const;
+
+    /**
+     * @brief Get the sequence number of the last applied update
+     * @return Sequence number, or -1 if the feed has none
+     */
+    int64_t lastSeqId() const { return lastSeqId_; }
+
+    /**
+     * @brief Get the number of levels changed by the last update
+     * @return Changed levels (all levels for a snapshot)
+     */
+    size_t lastChangedLevels() const { return lastChangedLevels_; }
+
+    /**
+     * @brief Get the first level of a side changed by the last update
+     *
+     * Levels before it are as they were before the update, prices and sizes alike.
+     *
+     * @param isBid True for the bid side
+     * @return Level index; 0 after a snapshot, kMaxBookDepth if the side did not change
+     */
+    size_t firstChangedLevel(bool isBid) const { return isBid ? firstChangedBid_ : firstChangedAsk_; }
+
+    /**
+     * @brief Compute the OKX-style checksum of the top of the book
+     *
+     * CRC32 over "bid1Price:bid1Size:ask1Price:ask1Size:..." for the top 25 levels. Values
+     * are formatted in their shortest round-trip form, which matches the exchange strings
+     * as long as the exchange does not send trailing zeros. For a venue quoting contracts,
+     * sizes are divided back into contracts and formatted to 15 significant digits, which
+     * absorbs the rounding of the conversion.
+     *
+     * @param sizeUnit Base units per size unit of the exchange checksum, 1 for base sizes
+     * @return Signed 32-bit checksum
+     */
+    int32_t checksum(double sizeUnit = 1.0) const;
+
+private:
+    static constexpr int kChecksumLevels = 25;
+    static constexpr uint64_t kTotalsRecomputeInterval = 1024;
+
+    BookSide asks_;
+    BookSide bids_;
+    SideTotals askTotals_;
+    SideTotals bidTotals_;
+
+    bool synced_ = false;
+    int64_t lastSeqId_ = -1;
+    size_t lastChangedLevels_ = 0;
+    size_t firstChangedAsk_ = 0;
+    size_t firstChangedBid_ = 0;
+    uint64_t deltasSinceRecompute_ = 0;
+
+    /**
+     * @brief Replace both sides with a snapshot
+     */
+    void applySnapshot(const OrderbookData& snapshot);
+
+    /**
+     * @brief Insert, modify or delete one level
+     * @param side Side to change
+     * @param totals Running totals of the side
+     * @param price Level price
+     * @param size New level size; 0 deletes the level
+     * @param ascending True if the side is sorted ascending (asks)
+     * @return Index of the first level changed, kMaxBookDepth if none was
+     */
+    static size_t applyLevel(BookSide& side, SideTotals& totals, double price, double size,
+                           bool ascending);
+
+    /**
+     * @brief Recompute the running totals of both sides exactly
+     */
+    void recomputeTotals();
+};
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string_view>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Single-pass parser for the GoQuant L2 orderbook message schema
+ *
+ * Messages are scanned once with a JsonCursor, without building a JSON DOM or creating
+ * per-level strings. Unknown fields are skipped, so the schema can grow without breaking
+ * the parser.
+ *
+ * Incremental feeds may add "action" ("snapshot" or "update"), "seqId", "prevSeqId" and
+ * "checksum"; messages without "action" are treated as snapshots.
+ */
+class L2Parser {
+public:
+    /**
+     * @brief Parse an L2 message into an orderbook
+     * @param message Raw JSON message, e.g. a view over the WebSocket read buffer
+     * @param orderbook Output orderbook; both sides are cleared first
+     * @throws std::runtime_error if the message is malformed or misses required fields
+     */
+    static void parse(std::string_view message, OrderbookData& orderbook);
+};
+
+} // namespace data
+} // namespace trade_simulator 
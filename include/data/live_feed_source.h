@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "data/feed_recorder.h"
+#include "data/feed_source.h"
+#include "data/websocket_client.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Feed source streaming the selected instrument from the GoQuant WebSocket feed
+ *
+ * Runs a WebSocketClient with a single I/O thread, so updates arrive from one thread.
+ * Optionally records every raw message of the selected instrument to a feed log.
+ */
+class LiveFeedSource : public FeedSource {
+public:
+    /**
+     * @brief Constructor
+     * @param callback Function to call with each update
+     * @param recordPath Feed log to record to, or empty to not record
+     * @param threadConfig CPU and busy polling of the I/O thread
+     * @param hotStandby Keep a second connection open to fail over to
+     * @throws std::runtime_error if the feed log cannot be created
+     */
+    explicit LiveFeedSource(OrderbookCallback callback, const std::string& recordPath = std::string(),
+                            const utils::ThreadConfig& threadConfig = utils::ThreadConfig(),
+                            bool hotStandby = false);
+
+    /**
+     * @brief Destructor
+     */
+    ~LiveFeedSource() override;
+
+    void start() override;
+    void stop() override;
+    void selectInstrument(const std::string& exchange, const std::string& instrument) override;
+    void resubscribe() override;
+    bool isConnected() const override;
+
+private:
+    OrderbookCallback callback_;
+    bool hotStandby_;
+    std::unique_ptr<FeedRecorder> recorder_;
+    WebSocketClient client_;
+
+    // Feed of the selected instrument; updates still in flight from others are dropped
+    std::atomic<FeedId> activeFeedId_{0};
+};
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "data/orderbook_processor.h"
+#include "data/orderbook_types.h"
+#include "data/spsc_ring.h"
+#include "utils/thread_affinity.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief What the producer does when the processing queue is full
+ */
+enum class OverflowPolicy {
+    ConflateLatest,  // Keep only the newest snapshot until a slot frees up; deltas block
+    Block            // Wait for the processing thread to free a slot
+};
+
+/**
+ * @brief Configuration of the orderbook dispatcher
+ */
+struct DispatcherConfig {
+    size_t queueCapacity = 64;  // Snapshots buffered between the threads
+    OverflowPolicy overflowPolicy = OverflowPolicy::ConflateLatest;
+    utils::ThreadConfig processingThread;  // CPU and idle spinning of the processing thread
+    bool dedicatedThread = true;           // False: the owner calls drain() on its own thread
+
+    // Default constructor
+    DispatcherConfig() = default;
+};
+
+/**
+ * @brief Counters of the processing queue
+ */
+struct DispatcherStats {
+    size_t queueDepth = 0;        // Snapshots waiting to be processed
+    size_t maxQueueDepth = 0;     // Highest depth observed on publish
+    uint64_t published = 0;       // Snapshots handed to the processing thread
+    uint64_t processed = 0;       // Snapshots processed
+    uint64_t conflated = 0;       // Snapshots replaced by a newer one while the queue was full
+    uint64_t blocked = 0;         // Times the producer had to wait for a free slot
+};
+
+/**
+ * @brief Hands orderbook snapshots from the network thread to a dedicated processing thread
+ *
+ * Snapshots are copied into preallocated slots of a lock-free SPSC ring, so the network
+ * thread never runs statistics or models and never allocates once the symbol strings
+ * have been seen. submit() must only be called from one thread at a time.
+ */
+class OrderbookDispatcher {
+public:
+    /**
+     * @brief Constructor
+     * @param processor Processor run on the processing thread
+     * @param config Queue configuration
+     */
+    explicit OrderbookDispatcher(std::shared_ptr<OrderbookProcessor> processor,
+                                 const DispatcherConfig& config = DispatcherConfig());
+
+    /**
+     * @brief Destructor
+     */
+    ~OrderbookDispatcher();
+
+    /**
+     * @brief Start accepting snapshots, and the processing thread if it has one
+     */
+    void start();
+
+    /**
+     * @brief Stop the processing thread; snapshots still queued are discarded
+     *
+     * Without a dedicated thread the owner must have stopped calling drain() first.
+     */
+    void stop();
+
+    /**
+     * @brief Process queued snapshots on the calling thread
+     *
+     * For dispatchers without a dedicated thread, e.g. many instruments sharing one
+     * worker; only one thread may drain a dispatcher.
+     *
+     * @param maxSnapshots Most snapshots to process in this call
+     * @return Snapshots processed
+     */
+    size_t drain(size_t maxSnapshots);
+
+    /**
+     * @brief Queue a snapshot for processing (producer thread only)
+     * @param data Snapshot to copy into the queue
+     */
+    void submit(const OrderbookData& data);
+
+    /**
+     * @brief Get the queue counters
+     * @return Current counters
+     */
+    DispatcherStats getStats() const;
+
+private:
+    // Idle loop tuning of the processing thread
+    static constexpr int kIdleSpinsBeforeSleep = 1000;
+    static constexpr int kIdleSleepMicros = 50;
+
+    std::shared_ptr<OrderbookProcessor> processor_;
+    OverflowPolicy overflowPolicy_;
+    utils::ThreadConfig threadConfig_;
+    bool dedicatedThread_;
+    SpscRing<OrderbookData> ring_;
+
+    // Producer-side state
+    bool hasStagedSnapshot_ = false;
+
+    // Processing thread
+    std::thread processingThread_;
+    std::atomic<bool> shouldRun_{false};
+
+    // Counters
+    std::atomic<size_t> maxQueueDepth_{0};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> blocked_{0};
+
+    /**
+     * @brief Processing thread body
+     */
+    void runProcessing();
+
+    /**
+     * @brief Publish the write slot, waiting for a free slot if the ring is full
+     * @return False if the dispatcher stopped first; the slot then stays staged
+     */
+    bool publishBlocking();
+
+    /**
+     * @brief Record a successful publish
+     */
+    void onPublished();
+};
+
+} // namespace data
+} // namespace trade_simulator 
@@ -1,13 +1,17 @@
 #pragma once
 
-#include <deque>
-#include <mutex>
 #include <vector>
 #include <functional>
 #include <chrono>
 #include <atomic>
 
+#include "data/depth_profile.h"
+#include "data/l2_book.h"
 #include "data/orderbook_types.h"
+#include "data/queue_tracker.h"
+#include "data/rolling_volatility.h"
+#include "utils/latency_histogram.h"
+#include "utils/seqlock.h"
 
 namespace trade_simulator {
 namespace data {
@@ -22,6 +26,14 @@ public:
      */
     using StatsCallback = std::function<void(const OrderbookStats&)>;
 
+    /**
+     * @brief Callback type for resynchronization requests
+     *
+     * Invoked once when a sequence gap or checksum mismatch leaves the book unsynchronized;
+     * the feed should deliver a fresh snapshot, e.g. by resubscribing.
+     */
+    using ResyncCallback = std::function<void()>;
+
     /**
      * @brief Constructor
      * @param statsCallback Function to call with updated orderbook statistics
@@ -29,67 +41,159 @@ public:
      */
     OrderbookProcessor(StatsCallback statsCallback, size_t historyWindowSize = 100);
 
+    /**
+     * @brief Constructor
+     * @param statsCallback Function to call with updated orderbook statistics
+     * @param volatilityConfig Window and estimator used for the price volatility
+     */
+    OrderbookProcessor(StatsCallback statsCallback, const VolatilityConfig& volatilityConfig);
+
+    /**
+     * @brief Set the function called when the book needs a fresh snapshot
+     * @param callback Resynchronization callback; must be set before processing starts
+     */
+    void setResyncCallback(ResyncCallback callback);
+    
+    /**
+     * @brief Record the feed, queue and statistics stages of every update
+     * @param latency Histograms to record into; must outlive the processor, nullptr to stop
+     */
+    void setLatencyRecorder(utils::PipelineLatency* latency);
+
+    /**
+     * @brief Advance the virtual orders of a queue tracker with every applied update
+     *
+     * The tracker sees each update right after the book and before the statistics
+     * callback, and is reset with the book.
+     *
+     * @param tracker Tracker to advance; must outlive the processor, nullptr to stop
+     */
+    void setQueueTracker(QueueTracker* tracker);
+    
     /**
      * @brief Process a new orderbook update
-     * @param data The new orderbook data
+     *
+     * The update is applied to the maintained book; statistics are only published while
+     * the book is synchronized.
+     *
+     * @param data Snapshot or delta
      */
     void processOrderbook(const OrderbookData& data);
 
+    /**
+     * @brief Discard the history and latest statistics, e.g. when switching instruments
+     */
+    void reset();
+
     /**
      * @brief Get the latest orderbook statistics
+     *
+     * Wait-free for the processing thread; safe to call from any thread.
+     *
      * @return The latest orderbook statistics
      */
     OrderbookStats getLatestStats() const;
 
+    /**
+     * @brief Get the cumulative depth of the current book
+     *
+     * Only valid on the processing thread, e.g. inside the statistics callback; it follows
+     * the book and catches up with the next update on its first query after it.
+     *
+     * @return Depth profile matching the statistics just published
+     */
+    const DepthProfile& getDepthProfile() const { return depthProfile_; }
+    
+    /**
+     * @brief Get the maintained book
+     *
+     * Only valid on the processing thread, like getDepthProfile().
+     *
+     * @return Book the statistics just published were computed from
+     */
+    const L2Book& getBook() const { return book_; }
+
     /**
      * @brief Get the average processing latency in microseconds
      * @return Average processing latency
      */
     double getAverageLatency() const;
 
+    /**
+     * @brief Get the number of sequence gaps detected
+     * @return Sequence gaps
+     */
+    uint64_t getSequenceGaps() const { return sequenceGaps_.load(); }
+
+    /**
+     * @brief Get the number of checksum mismatches detected
+     * @return Checksum mismatches
+     */
+    uint64_t getChecksumMismatches() const { return checksumMismatches_.load(); }
+
 private:
+    // Levels included in the weighted prices
+    static constexpr size_t kVwapLevels = 10;
+    
     // Callback for statistics updates
     StatsCallback statsCallback_;
+    ResyncCallback resyncCallback_;
+    utils::PipelineLatency* latency_ = nullptr;
+    QueueTracker* queueTracker_ = nullptr;
+    
+    // Book maintained from snapshots and deltas (processing thread only); reset()
+    // flags the book, the volatility window and the latest statistics for clearing
+    L2Book book_;
+    std::atomic<bool> bookResetPending_{false};
+    
+    // Prefix sums of the book for fill queries (processing thread only)
+    DepthProfile depthProfile_;
     
-    // History of orderbook data and statistics
-    size_t historyWindowSize_;
-    std::deque<OrderbookData> orderbookHistory_;
-    mutable std::mutex historyMutex_;
+    // Rolling midprice return statistics (processing thread only)
+    RollingVolatility volatility_;
     
-    // Latest statistics
-    OrderbookStats latestStats_;
-    mutable std::mutex statsMutex_;
+    // Latest statistics, published by the processing thread
+    utils::SeqLock<OrderbookStats> latestStats_;
     
     // Performance metrics
     std::atomic<uint64_t> totalProcessingTime_{0};
     std::atomic<uint64_t> processedUpdates_{0};
+    std::atomic<uint64_t> sequenceGaps_{0};
+    std::atomic<uint64_t> checksumMismatches_{0};
 
     /**
-     * @brief Calculate orderbook statistics from the given data
-     * @param data The orderbook data
+     * @brief Calculate orderbook statistics from the maintained book
+     * @param book The synchronized book
      * @return Calculated statistics
      */
-    OrderbookStats calculateStats(const OrderbookData& data);
+    OrderbookStats calculateStats(const L2Book& book);
 
     /**
-     * @brief Calculate price volatility from historical data
-     * @return Price volatility
+     * @brief Get the number of leading levels the per-update summary has to cover
+     * @param side Non-empty book side
+     * @param isAsk True for the ask side
+     * @return Levels within the widest depth band, at least kVwapLevels
      */
-    double calculateVolatility() const;
+    static size_t topLevels(const BookSide& side, bool isAsk);
 
     /**
-     * @brief Calculate volume-weighted average price
-     * @param priceLevels Price levels to use
-     * @param maxLevels Maximum number of levels to include (0 = all)
-     * @return Volume-weighted average price
+     * @brief Report a lost book and ask the feed for a snapshot
+     * @param reason Cause, for the log
      */
-    double calculateVWAP(const PriceLevels& priceLevels, size_t maxLevels = 0) const;
+    void requestResync(const char* reason);
+
+    /**
+     * @brief Get the price volatility of the rolling window
+     * @return Price volatility
+     */
+    double calculateVolatility() const;
 
     /**
-     * @brief Update the history with new orderbook data
-     * @param data New orderbook data to add to history
+     * @brief Update the history with the book after an update
+     * @param book Book whose midprice enters the rolling window
+     * @param receivedTime Arrival time of the update
      */
-    void updateHistory(const OrderbookData& data);
+    void updateHistory(const L2Book& book, std::chrono::steady_clock::time_point receivedTime);
 };
 
 } // namespace data
@@ -1,38 +1,301 @@
 #pragma once
 
-#include <vector>
-#include <string>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <chrono>
-#include <utility>
+
+#include "data/symbol_table.h"
 
 namespace trade_simulator {
 namespace data {
 
 /**
- * @brief Price and size pair used in orderbook levels
+ * @brief Maximum number of levels kept per side of a book (OKX full depth is 400)
+ */
+constexpr size_t kMaxBookDepth = 400;
+
+/**
+ * @brief Number of depth-at-distance bands computed per side
+ */
+constexpr size_t kDepthBandCount = 4;
+
+/**
+ * @brief Distance of each depth band from the best price, in basis points
+ */
+constexpr std::array<double, kDepthBandCount> kDepthBandsBps = {5.0, 10.0, 25.0, 50.0};
+
+/**
+ * @brief One side of an orderbook as separate contiguous price and size arrays
+ *
+ * Structure-of-arrays layout with a compile-time maximum depth: the side never allocates,
+ * and kernels over prices or sizes stream through one cache-aligned array each. Only the
+ * first size() entries are meaningful; copies only move those.
+ *
+ * @tparam T Value type, double for prices/sizes or int64_t for ticks/lots
+ * @tparam MaxDepth Maximum number of levels
+ */
+template <typename T, size_t MaxDepth>
+struct BasicBookSide {
+    static constexpr size_t kMaxDepth = MaxDepth;
+
+    alignas(64) std::array<T, MaxDepth> prices;
+    alignas(64) std::array<T, MaxDepth> sizes;
+    size_t count = 0;
+
+    // Constructors; the arrays are deliberately left uninitialized
+    BasicBookSide() {}
+
+    BasicBookSide(const BasicBookSide& other) : count(other.count) {
+        copyLevels(other);
+    }
+
+    BasicBookSide& operator=(const BasicBookSide& other) {
+        if (this != &other) {
+            count = other.count;
+            copyLevels(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Get the number of levels
+     * @return Number of levels
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Check whether the side has no levels
+     * @return True if empty
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Check whether the side holds the maximum number of levels
+     * @return True if full
+     */
+    bool full() const { return count == MaxDepth; }
+
+    /**
+     * @brief Remove all levels
+     */
+    void clear() { count = 0; }
+
+    /**
+     * @brief Append a level behind the existing ones
+     * @param price Level price
+     * @param size Level size
+     * @return False if the side is full and the level was dropped
+     */
+    bool push(T price, T size) {
+        if (count == MaxDepth) {
+            return false;
+        }
+        prices[count] = price;
+        sizes[count] = size;
+        ++count;
+        return true;
+    }
+
+private:
+    void copyLevels(const BasicBookSide& other) {
+        std::copy_n(other.prices.data(), other.count, prices.data());
+        std::copy_n(other.sizes.data(), other.count, sizes.data());
+    }
+};
+
+/**
+ * @brief Book side with real-valued prices and sizes
+ */
+using BookSide = BasicBookSide<double, kMaxBookDepth>;
+
+/**
+ * @brief Book side with integer prices in ticks and sizes in lots
+ */
+using TickBookSide = BasicBookSide<int64_t, kMaxBookDepth>;
+
+/**
+ * @brief Unit of the level sizes a venue sends
+ */
+enum class SizeUnit : uint8_t {
+    Base,       // Base currency, e.g. BTC
+    Contracts,  // Contracts of InstrumentSpec::contractValue base units each
+    Quote       // Quote currency, e.g. USD for inverse perpetuals; divided by the price
+};
+
+/**
+ * @brief Tick and lot size of an instrument, used for the integer book representation,
+ *        and the unit its venue quotes sizes in
+ *
+ * Books are normalized to base-currency sizes when decoded, so tickSize and lotSize
+ * describe the normalized book.
  */
-using PriceLevel = std::pair<double, double>;
+struct InstrumentSpec {
+    double tickSize = 0.1;    // Price increment
+    double lotSize = 0.01;    // Size increment, in base units
+    SizeUnit sizeUnit = SizeUnit::Base;
+    double contractValue = 1.0;  // Base units per contract, for SizeUnit::Contracts
+
+    // Default constructor
+    InstrumentSpec() = default;
+
+    // Constructor with tick and lot sizes
+    InstrumentSpec(double tick, double lot) : tickSize(tick), lotSize(lot) {}
+
+    // Constructor with tick and lot sizes and the venue's size unit
+    InstrumentSpec(double tick, double lot, SizeUnit unit, double contract = 1.0)
+        : tickSize(tick), lotSize(lot), sizeUnit(unit), contractValue(contract) {}
+
+    /**
+     * @brief Check whether venue sizes are already in base units
+     * @return True if decoding leaves sizes unchanged
+     */
+    bool hasBaseSizes() const {
+        return sizeUnit == SizeUnit::Base || (sizeUnit == SizeUnit::Contracts && contractValue == 1.0);
+    }
+};
+
+/**
+ * @brief Convert a side's sizes from the venue's unit to base units in place
+ * @param side Decoded side
+ * @param spec Size unit of the venue
+ */
+inline void normalizeSizes(BookSide& side, const InstrumentSpec& spec) {
+    if (spec.sizeUnit == SizeUnit::Contracts) {
+        for (size_t i = 0; i < side.count; ++i) {
+            side.sizes[i] *= spec.contractValue;
+        }
+    } else if (spec.sizeUnit == SizeUnit::Quote) {
+        for (size_t i = 0; i < side.count; ++i) {
+            side.sizes[i] = side.prices[i] > 0.0 ? side.sizes[i] / side.prices[i] : 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Convert a book side to integer ticks and lots
+ * @param side Real-valued side
+ * @param spec Tick and lot size of the instrument
+ * @param out Integer side
+ */
+inline void toTicks(const BookSide& side, const InstrumentSpec& spec, TickBookSide& out) {
+    out.count = side.count;
+    for (size_t i = 0; i < side.count; ++i) {
+        out.prices[i] = static_cast<int64_t>(std::llround(side.prices[i] / spec.tickSize));
+        out.sizes[i] = static_cast<int64_t>(std::llround(side.sizes[i] / spec.lotSize));
+    }
+}
+
+/**
+ * @brief Convert an integer book side back to prices and sizes
+ * @param side Integer side
+ * @param spec Tick and lot size of the instrument
+ * @param out Real-valued side
+ */
+inline void fromTicks(const TickBookSide& side, const InstrumentSpec& spec, BookSide& out) {
+    out.count = side.count;
+    for (size_t i = 0; i < side.count; ++i) {
+        out.prices[i] = static_cast<double>(side.prices[i]) * spec.tickSize;
+        out.sizes[i] = static_cast<double>(side.sizes[i]) * spec.lotSize;
+    }
+}
+
+/**
+ * @brief Short text stored inline, for per-message strings such as timestamps
+ *
+ * Copying or assigning it never allocates; text beyond the capacity is cut off.
+ *
+ * @tparam Capacity Maximum length in characters
+ */
+template <size_t Capacity>
+class InlineString {
+public:
+    static constexpr size_t kCapacity = Capacity;
+
+    // Default constructor: empty
+    InlineString() = default;
+
+    /**
+     * @brief Replace the text
+     * @param text New text, truncated to the capacity
+     */
+    void assign(std::string_view text) {
+        length_ = std::min(text.size(), Capacity);
+        std::copy_n(text.data(), length_, chars_.data());
+    }
+
+    /**
+     * @brief Get the text
+     * @return View valid until the next assign()
+     */
+    std::string_view view() const { return std::string_view(chars_.data(), length_); }
+
+    size_t size() const { return length_; }
+    bool empty() const { return length_ == 0; }
+    void clear() { length_ = 0; }
+
+private:
+    std::array<char, Capacity> chars_;
+    size_t length_ = 0;
+};
 
 /**
- * @brief Collection of price levels (price, size) for one side of the orderbook
+ * @brief Longest exchange timestamp kept in an OrderbookData, e.g. "2025-05-04T10:39:13.123456789Z"
  */
-using PriceLevels = std::vector<PriceLevel>;
+constexpr size_t kMaxTimestampLength = 32;
+
+/**
+ * @brief Whether an orderbook message carries the full book or only changed levels
+ */
+enum class BookUpdateType : uint8_t {
+    Snapshot,  // asks/bids are the full book
+    Delta      // asks/bids are the changed levels; size 0 deletes a level
+};
+
+/**
+ * @brief Pipeline timestamps of one update, in utils::nowNanoseconds() time; 0 if not stamped
+ */
+struct LatencyTrace {
+    int64_t readNs = 0;        // Read completed
+    int64_t parseStartNs = 0;  // Parsing started
+    int64_t parsedNs = 0;      // Parsing finished
+    int64_t enqueuedNs = 0;    // Copied into the processing queue
+    int64_t disconnectedNs = 0;  // Feed connection lost, on the first update after it
+    int64_t readWallNs = 0;      // Read completed, in Unix time; live feeds only
+};
 
 /**
  * @brief Structure representing the full order book data
+ *
+ * Holds no heap-owned fields: names are interned ids and the timestamp is stored inline,
+ * so copying an update into a queue slot never allocates.
  */
 struct OrderbookData {
-    std::string timestamp;
-    std::string exchange;
-    std::string symbol;
-    PriceLevels asks;  // Sorted ascending by price
-    PriceLevels bids;  // Sorted descending by price
+    InlineString<kMaxTimestampLength> timestamp;  // Exchange timestamp as sent
+    int64_t exchange_time_ns = 0;                 // The timestamp in Unix nanoseconds, 0 if unparsed
+    SymbolId exchange = kNoSymbol;                // symbolName() gives the names
+    SymbolId symbol = kNoSymbol;
+    BookSide asks;  // Sorted ascending by price
+    BookSide bids;  // Sorted descending by price
     std::chrono::steady_clock::time_point received_time;
 
+    // Incremental feed metadata; feeds without it send snapshots only
+    BookUpdateType update_type = BookUpdateType::Snapshot;
+    int64_t seq_id = -1;       // Sequence number of this update, -1 if none
+    int64_t prev_seq_id = -1;  // Sequence number of the previous update, -1 if none
+    bool has_checksum = false;
+    int32_t checksum = 0;      // CRC32 of the top of the book after this update
+    double checksum_size_unit = 1.0;  // Base units per size unit the checksum covers
+    
+    // Latency instrumentation
+    LatencyTrace trace;
+
     // Constructor
     OrderbookData()
-        : timestamp{}, exchange{}, symbol{}, asks{}, bids{},
-          received_time{std::chrono::steady_clock::now()} {}
+        : asks{}, bids{}, received_time{std::chrono::steady_clock::now()} {}
 };
 
 /**
@@ -49,10 +312,20 @@ struct OrderbookStats {
     double total_bid_size = 0.0;
     double order_imbalance = 0.0;     // Ratio of bid vs ask volume
     double price_volatility = 0.0;    // Recent price changes
+    size_t ask_depth = 0;             // Number of ask levels
+    size_t bid_depth = 0;             // Number of bid levels
+    double total_ask_notional = 0.0;  // Sum of price * size over all ask levels
+    double total_bid_notional = 0.0;  // Sum of price * size over all bid levels
     
+    // Size resting within kDepthBandsBps of the best price on each side
+    std::array<double, kDepthBandCount> ask_band_size{};
+    std::array<double, kDepthBandCount> bid_band_size{};
+
     // Performance metrics
     std::chrono::microseconds processing_latency{0};
+    int64_t read_ns = 0;              // LatencyTrace::readNs of the update, 0 if not stamped
+    int64_t exchange_lag_ns = -1;     // Exchange timestamp to read, -1 if unknown (replays)
 };
 
 } // namespace data
-} // namespace trade_simulator 
\ No newline at end of file
+} // namespace trade_simulator
\ No newline at end of file
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data/l2_book.h"
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Capacity and queue dynamics of a QueueTracker
+ */
+struct QueueTrackerConfig {
+    size_t maxOrders = 1024;         // Orders tracked at once; storage is allocated up front
+    double touchTradeShare = 0.5;    // Share of a decrease at or through the touch taken as trades
+    double cancelPower = 2.0;        // Cancels ahead of an order: d * a^p / (a^p + b^p)
+    double rateHalfLifeMs = 5000.0;  // Half-life of the depletion rate of each level
+
+    // Default constructor
+    QueueTrackerConfig() = default;
+};
+
+/**
+ * @brief Handle of a virtual order; handles of removed orders are never reused
+ */
+using VirtualOrderId = uint64_t;
+
+constexpr VirtualOrderId kNoVirtualOrder = ~VirtualOrderId(0);
+
+/**
+ * @brief Where a virtual order stands
+ */
+struct VirtualOrderState {
+    bool valid = false;       // False for a removed or unknown handle
+    bool isBid = true;
+    bool filled = false;      // The whole size has filled; the order no longer rests
+    double price = 0.0;
+    double size = 0.0;
+    double filledSize = 0.0;
+    double queueAhead = 0.0;  // Size resting in front of the order at its price
+};
+
+/**
+ * @brief Expected fill of a virtual order over a horizon
+ */
+struct FillForecast {
+    double fillProbability = 0.0;    // Of the whole order having filled by the horizon
+    double makerProportion = 0.0;    // Expected share of the size filled passively by then
+    double expectedTimeToFill = -1;  // Seconds until the rest fills, -1 while the level has not moved
+    double queueAhead = 0.0;
+};
+
+/**
+ * @brief Queue position of passive virtual orders, advanced by the book's level changes
+ *
+ * A virtual order joins the back of the queue at its price and does not change the book.
+ * When the size of its level falls by d, the tracker splits the decrease: at or through
+ * the touch a share touchTradeShare is taken as traded volume, which consumes the queue
+ * from the front, first the size ahead of the order and then the order itself; the rest
+ * is taken as cancellations, of which a^p / (a^p + b^p) fall ahead of the order, with a
+ * ahead and b behind it. Increases join behind every order. An opposite best price at or
+ * through the order's price fills what is left of it.
+ *
+ * Orders at one price share a level, and each level links its orders through an intrusive
+ * list. Levels are found by price in an open-addressed table, so a changed level costs a
+ * hash probe plus the orders resting at it, whatever the depth of the book; a snapshot
+ * costs a binary search per tracked level. Each level keeps an exponentially decaying
+ * rate of its decreases, from which forecast() derives the time to fill.
+ *
+ * Meant for the processing thread: orders are placed, read and removed in the statistics
+ * callback, which runs right after the processor has applied the update to the tracker.
+ */
+class QueueTracker {
+public:
+    /**
+     * @brief Constructor
+     * @param config Capacity and queue dynamics
+     */
+    explicit QueueTracker(const QueueTrackerConfig& config = QueueTrackerConfig());
+
+    /**
+     * @brief Rest a virtual order at the back of the queue at a price
+     * @param isBid True for a buy resting on the bids
+     * @param price Limit price
+     * @param size Order size in base units
+     * @param queueAhead Size resting at the price when the order arrives, e.g. L2Book::sizeAt()
+     * @return Handle, or kNoVirtualOrder if maxOrders orders are tracked already
+     */
+    VirtualOrderId place(bool isBid, double price, double size, double queueAhead);
+
+    /**
+     * @brief Stop tracking an order, resting or filled
+     * @param id Handle from place()
+     * @return False if the handle was not tracked
+     */
+    bool remove(VirtualOrderId id);
+
+    /**
+     * @brief Get the state of an order
+     * @param id Handle from place()
+     * @return State; not valid if the handle is not tracked
+     */
+    VirtualOrderState order(VirtualOrderId id) const;
+
+    /**
+     * @brief Forecast the fill of an order
+     *
+     * The rest of the order fills once the queue ahead and the rest itself have been
+     * depleted. With the level's decaying rate r of decreases, that takes
+     * (queueAhead + rest) / r seconds; the fill probability over the horizon takes the time
+     * to fill to be exponentially distributed with that mean.
+     *
+     * @param id Handle from place()
+     * @param horizonSeconds Time the order is left to rest
+     * @return Forecast; all zero for an unknown handle
+     */
+    FillForecast forecast(VirtualOrderId id, double horizonSeconds) const;
+
+    /**
+     * @brief Advance the orders by an update the book has just applied
+     * @param update Snapshot or delta, as passed to L2Book::apply()
+     * @param book Book after the update
+     */
+    void apply(const OrderbookData& update, const L2Book& book);
+
+    /**
+     * @brief Drop every order, e.g. when the book is discarded
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of orders tracked, resting or filled
+     * @return Orders
+     */
+    size_t orderCount() const { return liveOrders_; }
+
+private:
+    static constexpr uint32_t kNil = ~uint32_t(0);
+
+    struct Order {
+        uint32_t generation = 0;
+        uint32_t level = kNil;  // kNil once filled
+        uint32_t prev = kNil;
+        uint32_t next = kNil;   // Next order at the level, or next free slot
+        bool live = false;
+        bool isBid = true;
+        double price = 0.0;
+        double size = 0.0;
+        double filledSize = 0.0;
+        double queueAhead = 0.0;
+    };
+
+    struct Level {
+        bool isBid = true;
+        double price = 0.0;
+        double size = 0.0;      // Size at the price as of the last update
+        double rate = 0.0;      // Decaying rate of decreases, base units per second
+        int64_t rateNs = 0;     // When the rate was last decayed
+        uint32_t head = kNil;
+        uint32_t tail = kNil;
+        uint32_t active = kNil; // Position in activeLevels_, or next free slot
+    };
+
+    QueueTrackerConfig config_;
+    double rateTauSeconds_;
+
+    std::vector<Order> orders_;
+    std::vector<Level> levels_;
+    std::vector<uint32_t> table_;          // Open-addressed level index by price and side
+    std::vector<uint32_t> activeLevels_;   // Levels with resting orders
+    size_t tableMask_;
+    uint32_t freeOrder_ = kNil;
+    uint32_t freeLevel_ = kNil;
+    size_t liveOrders_ = 0;
+    int64_t lastUpdateNs_ = 0;
+
+    // Best tracked prices, for the O(1) check whether the opposite side crossed them
+    double highestBid_;
+    double lowestAsk_;
+
+    /**
+     * @brief Find the slot of a level in the table
+     * @return Slot holding the level, or the empty slot where it would go
+     */
+    size_t findSlot(bool isBid, double price) const;
+
+    uint32_t findLevel(bool isBid, double price) const;
+    uint32_t acquireLevel(bool isBid, double price, double size);
+    void releaseLevel(uint32_t index);
+    void unlink(uint32_t index);
+
+    /**
+     * @brief Apply a new size of a level to its orders
+     * @param atTouch True if the level is at or through the best price of its side
+     */
+    void updateLevel(uint32_t index, double size, bool atTouch, int64_t nowNs);
+
+    /**
+     * @brief Fill every order of each level crossed by the opposite best prices
+     */
+    void fillCrossed(const L2Book& book);
+
+    /**
+     * @brief Mark an order filled and take it off its level
+     */
+    void completeOrder(uint32_t index);
+
+    void recomputeBestPrices();
+    double queueWeight(double size) const;
+    double decayedRate(const Level& level, int64_t nowNs) const;
+    const Order* lookup(VirtualOrderId id) const;
+};
+
+} // namespace data
+} // namespace trade_simulator
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "data/book_store.h"
+#include "data/feed_adapter.h"
+#include "data/feed_log_reader.h"
+#include "data/feed_source.h"
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Pacing of a replay
+ */
+enum class ReplayMode {
+    RealTime,         // Keep the recorded gaps between messages (scaled by the speed)
+    AsFastAsPossible  // Deliver messages back to back
+};
+
+/**
+ * @brief Configuration of a replay
+ */
+struct ReplayConfig {
+    std::string path;                      // Feed log (FeedRecorder) or book store (BookStoreWriter)
+    ReplayMode mode = ReplayMode::RealTime;
+    double speed = 1.0;                    // RealTime only: 2.0 replays twice as fast
+    int cpu = -1;                          // Pin the replay thread to this CPU; -1 does not
+
+    // Default constructor
+    ReplayConfig() = default;
+
+    // Constructor with log and mode
+    ReplayConfig(std::string logPath, ReplayMode replayMode)
+        : path(std::move(logPath)), mode(replayMode) {}
+};
+
+/**
+ * @brief Feed source that replays a recorded feed log or a book store
+ *
+ * Feed log messages are parsed straight out of the memory-mapped log on a replay thread;
+ * book stores skip parsing and decode the books from their columns. Each update's
+ * received_time is the recorded receive time rather than the current time, so replaying
+ * the same file yields identical statistics on every run. Each start() replays the file
+ * from the beginning.
+ */
+class ReplayFeedSource : public FeedSource {
+public:
+    /**
+     * @brief Constructor
+     * @param callback Function to call with each update
+     * @param config Log and pacing
+     * @throws std::runtime_error if the log cannot be opened
+     */
+    ReplayFeedSource(OrderbookCallback callback, const ReplayConfig& config);
+
+    /**
+     * @brief Destructor
+     */
+    ~ReplayFeedSource() override;
+
+    void start() override;
+    void stop() override;
+
+    /**
+     * @brief Only deliver messages of an instrument; an empty instrument delivers all
+     */
+    void selectInstrument(const std::string& exchange, const std::string& instrument) override;
+
+    /**
+     * @brief No-op: a log cannot be asked for a snapshot, the book resyncs at the next one
+     */
+    void resubscribe() override;
+
+    bool isConnected() const override;
+
+    /**
+     * @brief Check whether the whole log has been replayed
+     * @return True once the last message was delivered
+     */
+    bool isFinished() const { return finished_; }
+
+    /**
+     * @brief Get the number of messages delivered by the current replay
+     * @return Delivered messages
+     */
+    uint64_t replayedMessages() const { return replayedMessages_; }
+
+private:
+    OrderbookCallback callback_;
+    ReplayConfig config_;
+    std::unique_ptr<FeedLogReader> logReader_;     // Set for feed logs
+    std::unique_ptr<BookStoreReader> storeReader_; // Set for book stores
+    FeedDecoder decoder_;                          // Recognizes the venue of the log
+
+    // Replay thread
+    std::thread replayThread_;
+    std::atomic<bool> shouldRun_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<uint64_t> replayedMessages_{0};
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    // Selected instrument; the replay thread picks up changes by version
+    std::string exchange_;
+    std::string instrument_;
+    std::atomic<uint64_t> selectionVersion_{0};
+    mutable std::mutex selectionMutex_;
+
+    /**
+     * @brief Replay thread body
+     */
+    void runReplay();
+
+    /**
+     * @brief Read the next update of the file
+     * @param orderbook Output update
+     * @return False at the end of the file
+     */
+    bool readNext(OrderbookData& orderbook);
+
+    /**
+     * @brief Wait until a point in time or until stopped
+     * @return False if stopped
+     */
+    bool waitUntil(std::chrono::steady_clock::time_point deadline);
+};
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Estimator used for the price volatility
+ */
+enum class VolatilityMethod {
+    RollingWindow,  // Standard deviation of the returns in a sliding window
+    Ewma            // Exponentially weighted moving average of squared returns
+};
+
+/**
+ * @brief Configuration of the rolling volatility estimator
+ */
+struct VolatilityConfig {
+    VolatilityMethod method = VolatilityMethod::RollingWindow;
+    size_t windowSize = 100;                // Midprices in the window (returns = windowSize - 1)
+    std::chrono::nanoseconds timeWindow{0}; // Also drop returns older than this (0 = off)
+    double ewmaLambda = 0.94;               // Decay of the EWMA variant (RiskMetrics default)
+
+    // Default constructor
+    VolatilityConfig() = default;
+
+    // Constructor with window size
+    explicit VolatilityConfig(size_t window) : windowSize(window) {}
+};
+
+/**
+ * @brief O(1) rolling estimator of midprice return volatility
+ *
+ * Keeps a fixed-capacity ring of returns with a running mean and second moment, updated
+ * with Welford's add/remove steps as returns enter and leave the window. The moments are
+ * recomputed from the ring once per window length to stop rounding drift from building up.
+ * Memory is two values per return, allocated once.
+ */
+class RollingVolatility {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    /**
+     * @brief Constructor
+     * @param config Window and estimator settings
+     */
+    explicit RollingVolatility(const VolatilityConfig& config = VolatilityConfig());
+
+    /**
+     * @brief Add the midprice of a new orderbook update
+     * @param midprice Midprice of the update; non-positive values are ignored
+     * @param time Time of the update, used by the time-based window
+     */
+    void addMidprice(double midprice, TimePoint time);
+
+    /**
+     * @brief Get the current volatility estimate
+     * @return Standard deviation of returns (population), 0 with fewer than one return
+     */
+    double volatility() const;
+
+    /**
+     * @brief Get the number of returns the estimate is based on
+     * @return Returns in the window, or seen so far for the EWMA variant
+     */
+    size_t count() const;
+
+    /**
+     * @brief Discard all state
+     */
+    void reset();
+
+private:
+    VolatilityConfig config_;
+
+    // Ring of returns and their times
+    std::vector<double> returns_;
+    std::vector<TimePoint> times_;
+    size_t head_ = 0;   // Index of the oldest return
+    size_t size_ = 0;
+
+    // Running moments of the window (Welford)
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    size_t updatesSinceRecompute_ = 0;
+
+    // EWMA state
+    double ewmaVariance_ = 0.0;
+    size_t ewmaCount_ = 0;
+
+    // Previous midprice
+    double lastMidprice_ = 0.0;
+
+    /**
+     * @brief Add a return to the window
+     */
+    void push(double ret, TimePoint time);
+
+    /**
+     * @brief Remove the oldest return from the window
+     */
+    void popOldest();
+
+    /**
+     * @brief Recompute the moments from the ring
+     */
+    void recompute();
+};
+
+} // namespace data
+} // namespace trade_simulator 
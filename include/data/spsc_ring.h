@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring of preallocated slots
+ *
+ * Elements are never constructed or destroyed after the ring is built: the producer fills
+ * the slot returned by writeSlot() in place and then publishes it, the consumer reads the
+ * slot returned by front() in place and then pops it. Slots keep whatever capacity their
+ * members grew to, so steady-state traffic does not allocate.
+ *
+ * The write slot is always owned by the producer, even when the ring is full, which lets
+ * the producer keep overwriting it with newer data until a slot frees up.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of published elements the ring can hold
+     * @param prototype Value every slot is initialized from, e.g. with reserved vectors
+     */
+    explicit SpscRing(size_t capacity, const T& prototype = T()) {
+        // One extra slot for the producer's write slot, rounded up to a power of two
+        size_t slots = 2;
+        while (slots < capacity + 1) {
+            slots <<= 1;
+        }
+        slots_.assign(slots, prototype);
+        mask_ = slots - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Producer: get the slot to fill before publishing
+     * @return Slot owned by the producer until it is published
+     */
+    T& writeSlot() {
+        return slots_[head_.load(std::memory_order_relaxed) & mask_];
+    }
+
+    /**
+     * @brief Producer: publish the write slot to the consumer
+     * @return False if the ring is full; the write slot then stays with the producer
+     */
+    bool tryPublish() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ >= capacity()) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ >= capacity()) {
+                return false;
+            }
+        }
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: get the oldest published element
+     * @return Pointer to the element, or nullptr if the ring is empty
+     */
+    T* front() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cachedHead_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail == cachedHead_) {
+                return nullptr;
+            }
+        }
+        return &slots_[tail & mask_];
+    }
+
+    /**
+     * @brief Consumer: release the element returned by front() back to the producer
+     */
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the number of published elements not yet popped
+     * @return Queue depth; approximate while both sides are running
+     */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the maximum number of published elements
+     * @return Capacity of the ring
+     */
+    size_t capacity() const {
+        return mask_;
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    // Producer side: next slot to publish, and the last tail it observed
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Consumer side: next slot to read, and the last head it observed
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
+
+} // namespace data
+} // namespace trade_simulator
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace trade_simulator {
+namespace data {
+
+/**
+ * @brief Small integer standing for an interned exchange or instrument name
+ */
+using SymbolId = uint32_t;
+
+/**
+ * @brief Id of no name; the value of unset symbol fields
+ */
+constexpr SymbolId kNoSymbol = 0;
+
+/**
+ * @brief Process-wide table of interned exchange and instrument names
+ *
+ * Names are stored once in fixed, preallocated storage and never removed, so an id and
+ * the view returned for it stay valid for the life of the process. Looking up a name that
+ * is already interned is a lock-free probe of an open-addressing table with no allocation;
+ * only the first sighting of a name takes the insertion lock. Feeds carry a handful of
+ * venues and at most a few thousand instruments, well inside the fixed capacity.
+ */
+class SymbolTable {
+public:
+    static constexpr size_t kCapacity = 4096;      // Names, including kNoSymbol
+    static constexpr size_t kMaxNameLength = 47;   // Longer names are rejected
+
+    /**
+     * @brief Get the table shared by the whole process
+     * @return Symbol table
+     */
+    static SymbolTable& instance();
+
+    /**
+     * @brief Get the id of a name, interning it on its first use
+     * @param name Exchange or instrument name; empty names map to kNoSymbol
+     * @return Id of the name
+     * @throws std::runtime_error if the name is too long or the table is full
+     */
+    SymbolId intern(std::string_view name);
+
+    /**
+     * @brief Get the id of a name without interning it
+     * @param name Exchange or instrument name
+     * @return Id of the name, or kNoSymbol if it was never interned
+     */
+    SymbolId find(std::string_view name) const;
+
+    /**
+     * @brief Get the name of an id
+     * @param id Id returned by intern()
+     * @return Name, empty for kNoSymbol and unknown ids
+     */
+    std::string_view name(SymbolId id) const;
+
+    /**
+     * @brief Get the number of names interned
+     * @return Names, not counting kNoSymbol
+     */
+    size_t size() const { return count_.load(std::memory_order_acquire) - 1; }
+
+private:
+    static constexpr size_t kSlots = 2 * kCapacity;  // Power of two, at most half full
+
+    struct Name {
+        std::array<char, kMaxNameLength> chars;
+        uint8_t length = 0;
+    };
+
+    // Interned names by id, written once before their id is published
+    std::array<Name, kCapacity> names_;
+    std::atomic<size_t> count_{1};
+
+    // Ids by hash of the name, 0 if the slot is free
+    std::array<std::atomic<SymbolId>, kSlots> slots_{};
+    std::mutex insertMutex_;
+
+    SymbolTable() = default;
+
+    static size_t hash(std::string_view name);
+
+    /**
+     * @brief Probe for a name
+     * @param name Name to look for
+     * @param slot Receives the slot holding the name, or the free slot ending the probe
+     * @return Id of the name, or kNoSymbol if it is not in the table
+     */
+    SymbolId probe(std::string_view name, size_t& slot) const;
+};
+
+/**
+ * @brief Intern a name in the process-wide table
+ * @param name Exchange or instrument name
+ * @return Id of the name
+ */
+inline SymbolId internSymbol(std::string_view name) {
+    return SymbolTable::instance().intern(name);
+}
+
+/**
+ * @brief Get the name of an id from the process-wide table
+ * @param id Interned id
+ * @return Name, empty for kNoSymbol
+ */
+inline std::string_view symbolName(SymbolId id) {
+    return SymbolTable::instance().name(id);
+}
+
+} // namespace data
+} // namespace trade_simulator
@@ -1,19 +1,27 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <vector>
 #include <chrono>
 #include <atomic>
+#include <cstdint>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/ssl/stream.hpp>
-#include <boost/asio/strand.hpp>
+#include <boost/asio/ssl/context.hpp>
 
+#include "data/feed_adapter.h"
 #include "data/orderbook_types.h"
+#include "utils/thread_affinity.h"
 
 namespace trade_simulator {
 namespace data {
@@ -26,26 +34,160 @@ namespace ssl = boost::asio::ssl;
 using tcp = boost::asio::ip::tcp;
 
 /**
- * @brief WebSocket client for connecting to L2 orderbook data stream
+ * @brief Identifier of a feed registered with a WebSocketClient
+ */
+using FeedId = uint32_t;
+
+/**
+ * @brief Compression of binary WebSocket frames
+ */
+enum class FrameCompression {
+    None,       // Binary frames carry the message as is
+    RawDeflate  // Binary frames carry a raw deflate stream of the message
+};
+
+/**
+ * @brief Endpoint and reconnect settings of one L2 orderbook feed
+ */
+struct FeedConfig {
+    std::string host = "ws.gomarket-cpp.goquant.io";
+    std::string port = "443";
+    std::string target = "/ws/l2-orderbook/okx/BTC-USDT-SWAP";
+
+    // Message schema, and the sizes of the instrument's levels
+    Venue venue = Venue::GoQuant;
+    InstrumentSpec spec;
+
+    // Message sent after every handshake to subscribe, if any
+    std::string subscription;
+
+    // Compression: the permessage-deflate extension, and deflated binary frames
+    bool permessageDeflate = false;
+    FrameCompression binaryFrames = FrameCompression::None;
+
+    // Reconnect backoff: the first attempts after a drop go out right away, then the delay
+    // doubles from the initial delay up to the maximum, each drawn at random from the
+    // upper (1 - jitter) to 1 of its range so that feeds dropped together spread out
+    int reconnectImmediateAttempts = 1;
+    int reconnectInitialDelayMs = 250;
+    int reconnectMaxDelayMs = 10000;
+    double reconnectJitter = 0.5;
+
+    // Resolved addresses are reused by reconnects and refreshed in the background once
+    // they are this old
+    int dnsRefreshSeconds = 300;
+
+    // Keep a second connection open and switch to it the moment the first one drops
+    bool hotStandby = false;
+
+    // Keepalive: the stream pings after half the idle timeout without traffic and drops
+    // the connection if nothing arrives within it; 0 disables
+    int idleTimeoutMs = 10000;
+
+    // Application-level ping some venues require on top, sent every interval
+    std::string heartbeat;
+    int heartbeatIntervalMs = 0;
+
+    // Default constructor
+    FeedConfig() = default;
+
+    // Constructor with endpoint
+    FeedConfig(std::string feedHost, std::string feedPort, std::string feedTarget)
+        : host(std::move(feedHost)), port(std::move(feedPort)), target(std::move(feedTarget)) {}
+
+    /**
+     * @brief Build the L2 feed of an instrument
+     *
+     * OKX instruments stream through the GoQuant gateway; Binance, Bybit and Deribit are
+     * read from the venue directly (see forVenue()).
+     *
+     * @param exchange Exchange name, e.g. "OKX"
+     * @param instrument Venue instrument name, e.g. "BTC-USDT-SWAP"
+     * @return Feed configuration for the instrument
+     */
+    static FeedConfig forInstrument(const std::string& exchange, const std::string& instrument);
+
+    /**
+     * @brief Build a venue's own public L2 feed of an instrument
+     * @param venue Venue to connect to directly; GoQuant builds the gateway feed
+     * @param instrument Venue instrument name, e.g. "BTCUSDT" on Binance
+     * @return Feed configuration with the venue's endpoint, subscription and spec
+     */
+    static FeedConfig forVenue(Venue venue, const std::string& instrument);
+};
+
+/**
+ * @brief Asynchronous WebSocket client for L2 orderbook data streams
+ *
+ * All feeds are multiplexed over one io_context served by a small pool of threads. Each
+ * feed runs its own connect/read/reconnect cycle on a strand, so a feed never delivers
+ * two messages concurrently, but different feeds may run on different pool threads.
  */
 class WebSocketClient {
 public:
     /**
      * @brief Callback type for orderbook data updates
+     *
+     * The book passed to the callback is reused for the next message; copy it to keep it.
+     * With more than one I/O thread the callback can be invoked concurrently for
+     * different feeds.
+     */
+    using OrderbookCallback = std::function<void(FeedId feedId, const OrderbookData&)>;
+
+    /**
+     * @brief Callback type for raw messages, invoked before parsing
+     *
+     * The view is only valid during the call.
      */
-    using OrderbookCallback = std::function<void(const OrderbookData&)>;
+    using RawMessageCallback = std::function<void(FeedId feedId, std::string_view message,
+                                                  std::chrono::steady_clock::time_point receivedTime)>;
 
     /**
      * @brief Constructor
      * @param callback Function to call with each new orderbook update
+     * @param ioThreads Number of threads serving the io_context
+     * @param threadConfig CPU of the I/O threads, and whether they poll the sockets in a
+     *                     loop instead of blocking in the kernel between messages
      */
-    WebSocketClient(OrderbookCallback callback);
+    explicit WebSocketClient(OrderbookCallback callback, size_t ioThreads = 1,
+                             const utils::ThreadConfig& threadConfig = utils::ThreadConfig());
 
     /**
      * @brief Destructor
      */
     ~WebSocketClient();
 
+    /**
+     * @brief Set a function that sees every raw message, e.g. to record the feed
+     * @param callback Raw message callback; must be set before start()
+     */
+    void setRawMessageCallback(RawMessageCallback callback);
+
+    /**
+     * @brief Register a feed; it connects right away if the client is running
+     * @param config Endpoint of the feed
+     * @return Identifier of the new feed
+     */
+    FeedId addFeed(const FeedConfig& config);
+
+    /**
+     * @brief Unregister a feed and close its connection
+     * @param feedId Identifier returned by addFeed
+     * @return True if the feed existed
+     */
+    bool removeFeed(FeedId feedId);
+
+    /**
+     * @brief Reconnect a feed right away so that it starts over with a snapshot
+     *
+     * Used when an incremental book lost sync. Safe to call from any thread; a feed that
+     * is not connected at the moment starts with a snapshot anyway and is left alone.
+     *
+     * @param feedId Identifier returned by addFeed
+     * @return True if the feed exists
+     */
+    bool resubscribe(FeedId feedId);
+
     /**
      * @brief Start the WebSocket client
      */
@@ -58,71 +200,66 @@ public:
 
     /**
      * @brief Check if the client is connected
-     * @return True if connected, false otherwise
+     * @return True if at least one feed is connected, false otherwise
      */
     bool isConnected() const;
 
     /**
-     * @brief Check if the connection is healthy
-     * @param maxIdleSeconds Maximum seconds without a message before connection is unhealthy
-     * @return True if healthy, false otherwise
+     * @brief Check if the connection is healthy; lock-free per feed, so cheap to poll
+     * @param maxIdle Longest time without a message before a feed is unhealthy
+     * @return True if there is at least one feed and all feeds are healthy
      */
-    bool isHealthy(int maxIdleSeconds = 10) const;
+    bool isHealthy(std::chrono::nanoseconds maxIdle = std::chrono::seconds(10)) const;
 
 private:
-    // WebSocket endpoint
-    const std::string kHost = "ws.gomarket-cpp.goquant.io";
-    const std::string kPort = "443";
-    const std::string kTarget = "/ws/l2-orderbook/okx/BTC-USDT-SWAP";
-    
-    // Connection parameters
-    const int kReconnectInitialDelayMs = 1000;
-    const int kReconnectMaxDelayMs = 60000;
-    
-    // Callback for orderbook updates
+    class FeedSession;
+
+    class FeedArbiter;
+
+    /**
+     * @brief A registered feed and its live sessions, if running: the primary connection
+     *        and, with FeedConfig::hotStandby, the standby
+     */
+    struct Feed {
+        FeedConfig config;
+        std::shared_ptr<FeedArbiter> arbiter;
+        std::vector<std::shared_ptr<FeedSession>> sessions;
+    };
+
+    // Read buffer sizing; it grows on demand and then keeps its capacity
+    static constexpr size_t kInitialReadBufferBytes = 64 * 1024;
+
+    // Callbacks for orderbook updates and raw messages
     OrderbookCallback callback_;
-    
+    RawMessageCallback rawMessageCallback_;
+
     // Asio
+    size_t ioThreadCount_;
+    utils::ThreadConfig threadConfig_;
     net::io_context ioc_;
-    std::unique_ptr<std::thread> ioThread_;
-    
-    // Connection state
-    std::atomic<bool> isConnected_{false};
+    std::optional<net::executor_work_guard<net::io_context::executor_type>> work_;
+    std::vector<std::thread> ioThreads_;
+    // Shared by every connection; each session keeps its TLS session for resumption
+    ssl::context sslContext_{ssl::context::tls_client};
+
+    // Feeds and running state
+    std::map<FeedId, Feed> feeds_;
+    FeedId nextFeedId_{1};
     std::atomic<bool> shouldRun_{false};
-    std::chrono::steady_clock::time_point lastMessageTime_;
     mutable std::mutex stateMutex_;
-    
-    // Reconnect logic
-    int reconnectDelayMs_{kReconnectInitialDelayMs};
-    
+
     /**
-     * @brief Run the IO service on a separate thread
+     * @brief Run the IO service on a pool thread
      */
     void runIoService();
-    
-    /**
-     * @brief Connect to the WebSocket
-     */
-    void connect();
-    
-    /**
-     * @brief Process a received message
-     * @param message The message received from the WebSocket
-     */
-    void processMessage(const std::string& message);
-    
-    /**
-     * @brief Parse orderbook data from JSON message
-     * @param jsonMessage The JSON message from the WebSocket
-     * @return OrderbookData structure with parsed data
-     */
-    OrderbookData parseOrderbookData(const std::string& jsonMessage);
-    
+
     /**
-     * @brief Reconnect to the WebSocket with exponential backoff
+     * @brief Create and start the sessions of a feed
+     * @param feedId Identifier of the feed
+     * @param feed Feed to start
      */
-    void reconnect();
+    void startSession(FeedId feedId, Feed& feed);
 };
 
 } // namespace data
-} // namespace trade_simulator 
\ No newline at end of file
+} // namespace trade_simulator
\ No newline at end of file
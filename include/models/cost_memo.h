@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "data/depth_profile.h"
+#include "data/orderbook_types.h"
+#include "models/transaction_cost.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Resolution and size of a CostMemo
+ *
+ * Inputs are quantized relative to their own magnitude: a value resolves to 2^-bits of
+ * itself, so 10 bits keep about 0.1% and 16 bits about 0.15 bps.
+ */
+struct CostMemoConfig {
+    int midpriceBits = 16;  // Midprice, which scales the fees
+    int valueBits = 10;     // Spread, side depths, imbalance, volatility, order size and slippage
+    size_t capacity = 64;   // Entries, rounded up to a power of two
+
+    // Default constructor
+    CostMemoConfig() = default;
+};
+
+/**
+ * @brief Costs of one order, as calculateTotalCost() and predictMakerProportion() return them
+ */
+struct MemoizedCost {
+    double slippage = 0.0;
+    double marketImpact = 0.0;
+    double fees = 0.0;
+    double totalCost = 0.0;
+    double makerProportion = 0.0;
+    bool changed = true;  // False if the inputs fell into the same buckets as the last call's
+};
+
+/**
+ * @brief Hit and miss counters of a CostMemo
+ */
+struct CostMemoStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t unchanged = 0;       // Evaluations whose inputs matched the previous one's
+    uint64_t invalidations = 0;   // Parameter version changes that cleared the entries
+
+    // Default constructor
+    CostMemoStats() = default;
+};
+
+/**
+ * @brief Memo of TransactionCostModel::calculateTotalCost keyed on quantized inputs
+ *
+ * Between consecutive ticks the statistics the cost model reads often barely move. The
+ * key quantizes them, with the order size and side and the distance of the order's walked
+ * fill from the midprice, so an update whose inputs land in the buckets of an earlier one
+ * gets that update's costs back without evaluating the slippage, impact, maker proportion
+ * and fee models. The fill covers the book's shape, which the statistics do not; a fill the
+ * book cannot complete is keyed on its full slippage estimate instead, which also covers
+ * the calibrated coefficients. A miss hands that slippage on rather than computing it again.
+ *
+ * Entries are direct-mapped by a hash of the key and tagged with the parameter version
+ * of the caller: a new version (impact parameters, fee tier) clears them all. Costs come
+ * back at most one quantum away from a fresh evaluation.
+ *
+ * evaluate() and invalidate() are meant for one thread, the processing thread; stats()
+ * is safe from any thread.
+ */
+class CostMemo {
+public:
+    /**
+     * @brief Constructor
+     * @param costModel Model evaluated on misses
+     * @param config Resolution and size
+     */
+    explicit CostMemo(std::shared_ptr<const TransactionCostModel> costModel,
+                      const CostMemoConfig& config = CostMemoConfig());
+
+    /**
+     * @brief Get the costs of an order, from the memo if an equivalent update was seen
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Orderbook statistics of the book the fill was walked on
+     * @param fill Result of DepthProfile::walk for the order
+     * @param parametersVersion Version of the model parameters; a new one clears the memo
+     * @return Costs, and whether the inputs changed materially since the previous call
+     */
+    MemoizedCost evaluate(double orderSize, bool orderSide, const data::OrderbookStats& stats,
+                          const data::FillEstimate& fill, uint64_t parametersVersion);
+
+    /**
+     * @brief Drop every entry, e.g. after switching instruments
+     */
+    void invalidate();
+
+    /**
+     * @brief Get the counters
+     * @return Hits, misses and invalidations since construction
+     */
+    CostMemoStats stats() const;
+
+private:
+    using Key = std::array<uint64_t, 9>;
+
+    struct Entry {
+        Key key{};
+        MemoizedCost cost;
+        bool valid = false;
+    };
+
+    std::shared_ptr<const TransactionCostModel> costModel_;
+    CostMemoConfig config_;
+    std::vector<Entry> entries_;
+    size_t mask_;
+    uint64_t version_ = 0;
+    Key lastKey_{};
+    bool hasLast_ = false;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> unchanged_{0};
+    std::atomic<uint64_t> invalidations_{0};
+};
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Expected costs of a range of order sizes on one side, as parallel arrays
+ *
+ * Entry i of every array belongs to sizes[i]. All costs are in the same units as
+ * TransactionCostModel::calculateTotalCost.
+ */
+struct CostCurve {
+    std::vector<double> sizes;            // Order sizes in base units
+    std::vector<double> slippage;
+    std::vector<double> marketImpact;
+    std::vector<double> fees;
+    std::vector<double> totalCost;
+    std::vector<double> makerProportion;
+
+    /**
+     * @brief Get the number of points on the curve
+     * @return Number of points
+     */
+    size_t size() const { return sizes.size(); }
+
+    /**
+     * @brief Set the number of points; storage is kept when shrinking
+     * @param count Number of points
+     */
+    void resize(size_t count) {
+        sizes.resize(count);
+        slippage.resize(count);
+        marketImpact.resize(count);
+        fees.resize(count);
+        totalCost.resize(count);
+        makerProportion.resize(count);
+    }
+};
+
+/**
+ * @brief Cost curves of both sides computed from one orderbook update
+ */
+struct CostSurface {
+    static constexpr size_t kMaxPoints = 1024;
+
+    CostCurve buy;
+    CostCurve sell;
+    double midprice = 0.0;   // Midprice the curves were computed at
+};
+
+} // namespace models
+} // namespace trade_simulator 
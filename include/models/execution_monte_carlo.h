@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "models/optimal_execution.h"
+#include "utils/work_stealing_pool.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Size, seeding and scheduling of a Monte Carlo execution simulation
+ */
+struct MonteCarloConfig {
+    size_t paths = 100000;         // Price paths per simulation
+    uint64_t seed = 0x5eed;        // Same seed, schedule and problem give the same distribution
+    double confidence = 0.99;      // Level of the value at risk and expected shortfall
+    size_t pathsPerTask = 2048;    // Paths simulated together by one pool task; rounded up to even
+    size_t threads = 0;            // Workers of a pool the owner creates; 0 uses one per hardware thread
+    int intervalMs = 250;          // How often the simulator re-runs it on the latest book
+    int executionSteps = 10;       // Steps of the schedule the simulator simulates
+
+    // Default constructor
+    MonteCarloConfig() = default;
+};
+
+/**
+ * @brief Distribution of the implementation shortfall of an execution schedule
+ *
+ * Costs are in the units of FrontierPoint::expectedCost, for a buy; a sell has the same
+ * distribution, as the price shocks are symmetric.
+ */
+struct CostDistribution {
+    size_t paths = 0;                // Paths simulated; 0 before the first simulation
+    double expectedCost = 0.0;       // Mean over the paths
+    double costStdDev = 0.0;
+    double medianCost = 0.0;
+    double percentile95 = 0.0;
+    double confidence = 0.0;         // Level of the two tail measures
+    double valueAtRisk = 0.0;        // Cost exceeded on a 1 - confidence fraction of the paths
+    double expectedShortfall = 0.0;  // Mean cost of the paths at or beyond the value at risk
+    double worstCost = 0.0;
+
+    // Default constructor
+    CostDistribution() = default;
+};
+
+/**
+ * @brief Executes a schedule against simulated price paths under Almgren-Chriss dynamics
+ *
+ * Each path starts at the arrival price S_0. Trade k of size n_k fills at
+ * S_{k-1} + eta * n_k / tau, after which the price moves by sigma * sqrt(tau) * xi_k plus the
+ * permanent impact gamma * n_k, xi_k standard normal. A path costs sum n_k * (fill_k - S_0);
+ * mean and variance converge to OptimalExecutionEngine::evaluate() for the same problem,
+ * and the simulation adds the tail of the distribution.
+ *
+ * Paths are simulated in blocks of pathsPerTask, one pool task per block, step by step
+ * across the block, so the inner loops run over contiguous arrays the compiler can
+ * vectorize. The shocks come from a counter-based generator: the normal of (path, step)
+ * is a hash of the seed and its index, so the result does not depend on the thread count
+ * or on which worker ran which block.
+ */
+class ExecutionMonteCarlo {
+public:
+    /**
+     * @brief Constructor
+     * @param config Paths and seeding
+     */
+    explicit ExecutionMonteCarlo(const MonteCarloConfig& config = MonteCarloConfig());
+
+    /**
+     * @brief Simulate the costs of a schedule
+     *
+     * Calls must not overlap; buffers are kept between calls, so repeated simulations of
+     * the same size do not allocate.
+     *
+     * @param tradeSizes Trade size of each step, e.g. MarketImpactModel::calculateOptimalExecution()
+     * @param problem Impact, volatility and horizon; numSteps is taken from tradeSizes
+     * @param pool Workers to run on
+     * @return Cost distribution; empty for an empty schedule or no paths
+     */
+    CostDistribution simulate(const std::vector<double>& tradeSizes, const ExecutionProblem& problem,
+                              utils::WorkStealingPool& pool);
+
+    /**
+     * @brief Get the configuration
+     * @return Paths and seeding
+     */
+    const MonteCarloConfig& config() const { return config_; }
+
+private:
+    MonteCarloConfig config_;
+    std::vector<double> costs_;    // One per path
+    std::vector<double> scratch_;  // Per worker: price drift and shocks of one block
+};
+
+} // namespace models
+} // namespace trade_simulator
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <string>
 #include "data/orderbook_types.h"
+#include "models/optimal_execution.h"
+#include "utils/seqlock.h"
 
 namespace trade_simulator {
 namespace models {
@@ -40,6 +43,28 @@ struct AlmgrenChrissParams {
  */
 class MarketImpactModel {
 public:
+    /**
+     * @brief Size-independent coefficients of the impact components for one set of stats
+     *
+     * permanent(q) = permanentCoefficient * (1 + min(1, q * inverseDepth)) * q
+     * temporary(q) = temporaryCoefficient * sqrt(q)
+     */
+    struct ImpactCoefficients {
+        double permanentCoefficient = 0.0;
+        double inverseDepth = 0.0;
+        double temporaryCoefficient = 0.0;
+        
+        /**
+         * @brief Evaluate the impact of a buy
+         * @param size Order size in base units
+         * @return Permanent plus temporary impact
+         */
+        double impact(double size) const {
+            double depthScale = 1.0 + std::min(1.0, size * inverseDepth);
+            return permanentCoefficient * depthScale * size + temporaryCoefficient * std::sqrt(size);
+        }
+    };
+    
     /**
      * @brief Constructor
      * @param params Initial parameters for the Almgren-Chriss model
@@ -68,8 +93,28 @@ public:
     double calculateMarketImpact(double orderSize, bool orderSide, 
                                  const data::OrderbookStats& stats) const;
     
+    /**
+     * @brief Calculate the expected market impact for many order sizes at once
+     *
+     * The terms that depend only on the statistics are computed once, leaving a
+     * branch-free loop over the sizes that the compiler can vectorize.
+     *
+     * @param orderSizes Sizes of the orders in base units
+     * @param count Number of sizes
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @param impacts Output, one estimated market impact in price units per size
+     */
+    void calculateMarketImpactBatch(const double* orderSizes, size_t count, bool orderSide,
+                                    const data::OrderbookStats& stats, double* impacts) const;
+    
     /**
      * @brief Calculate the optimal execution schedule according to Almgren-Chriss
+     *
+     * Closed-form sinh trajectory (see OptimalExecutionEngine), with the impact factors as
+     * the linear impact coefficients and the configured volatility, or the market
+     * volatility if none is configured.
+     *
      * @param orderSize Total size to execute
      * @param orderSide True for buy, false for sell
      * @param stats Current orderbook statistics
@@ -80,24 +125,39 @@ public:
                                                   const data::OrderbookStats& stats, 
                                                   int numSteps = 10) const;
     
-private:
-    AlmgrenChrissParams params_;
+    /**
+     * @brief Calculate the efficient frontier of optimal schedules over risk aversions
+     * @param orderSize Total size to execute
+     * @param stats Current orderbook statistics
+     * @param riskAversions Risk aversions to evaluate
+     * @param numSteps Number of execution steps
+     * @return Expected cost and cost variance per risk aversion
+     */
+    std::vector<FrontierPoint> calculateEfficientFrontier(double orderSize,
+                                                          const data::OrderbookStats& stats,
+                                                          const std::vector<double>& riskAversions,
+                                                          int numSteps = 10) const;
     
     /**
-     * @brief Calculate the permanent impact component
-     * @param orderSize Size of the order
-     * @param stats Orderbook statistics
-     * @return Permanent impact
+     * @brief Build the execution problem of the current parameters, as the schedules solve it
+     * @param stats Orderbook statistics, for the market volatility
+     * @param numSteps Number of execution steps
+     * @return Execution problem
      */
-    double calculatePermanentImpact(double orderSize, const data::OrderbookStats& stats) const;
+    ExecutionProblem executionProblem(const data::OrderbookStats& stats, int numSteps) const;
     
     /**
-     * @brief Calculate the temporary impact component
-     * @param orderSize Size of the order
+     * @brief Calculate the coefficients of the permanent and temporary impact components
      * @param stats Orderbook statistics
-     * @return Temporary impact
+     * @return Coefficients shared by all order sizes, e.g. to price one venue's share of an order
      */
-    double calculateTemporaryImpact(double orderSize, const data::OrderbookStats& stats) const;
+    ImpactCoefficients calculateCoefficients(const data::OrderbookStats& stats) const;
+    
+private:
+    utils::SeqLock<AlmgrenChrissParams> params_;
+    
+    // Cached optimal trajectories; thread-safe on its own
+    mutable OptimalExecutionEngine executionEngine_;
 };
 
 } // namespace models
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Inputs of the Almgren-Chriss optimal execution problem
+ */
+struct ExecutionProblem {
+    double permanentImpact = 0.1;  // gamma: linear permanent impact per unit traded
+    double temporaryImpact = 0.1;  // eta: linear temporary impact per unit of trading rate
+    double volatility = 0.0;       // sigma: price volatility per unit of time
+    double timeHorizon = 1.0;      // T: time to complete the order
+    double riskAversion = 1.0;     // lambda: weight of the cost variance
+    int numSteps = 10;             // N: number of trades
+
+    // Default constructor
+    ExecutionProblem() = default;
+};
+
+/**
+ * @brief Expected cost and cost variance of an execution schedule
+ */
+struct FrontierPoint {
+    double riskAversion = 0.0;
+    double expectedCost = 0.0;
+    double costVariance = 0.0;
+};
+
+/**
+ * @brief Closed-form Almgren-Chriss optimal execution schedules
+ *
+ * The optimal holdings are x_j = X * sinh(kappa * (T - t_j)) / sinh(kappa * T) with
+ * t_j = j * T / N, where the urgency kappa solves
+ * cosh(kappa * tau) = 1 + lambda * sigma^2 * tau^2 / (2 * eta_tilde),
+ * tau = T / N and eta_tilde = eta - gamma * tau / 2. A schedule costs O(N).
+ *
+ * The normalized trajectory (fractions of the order per step) depends only on
+ * (kappa, T, N), so it is cached under that key and re-pricing another order size just
+ * rescales it. All methods are thread-safe.
+ */
+class OptimalExecutionEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param cacheCapacity Maximum number of cached trajectories
+     */
+    explicit OptimalExecutionEngine(size_t cacheCapacity = 256);
+
+    /**
+     * @brief Calculate the urgency of the optimal trajectory
+     * @param problem Execution problem
+     * @return kappa; 0 means the schedule is linear (TWAP)
+     */
+    static double urgency(const ExecutionProblem& problem);
+
+    /**
+     * @brief Calculate the optimal trade sizes
+     * @param orderSize Total size to execute
+     * @param problem Execution problem
+     * @param tradeSizes Output, numSteps trade sizes summing to orderSize
+     */
+    void schedule(double orderSize, const ExecutionProblem& problem,
+                  std::vector<double>& tradeSizes);
+
+    /**
+     * @brief Calculate the expected cost and variance of the optimal schedule
+     * @param orderSize Total size to execute
+     * @param problem Execution problem
+     * @return Frontier point of the problem's risk aversion
+     */
+    FrontierPoint evaluate(double orderSize, const ExecutionProblem& problem);
+
+    /**
+     * @brief Calculate the efficient frontier over many risk aversions at once
+     * @param orderSize Total size to execute
+     * @param problem Execution problem; its riskAversion is ignored
+     * @param riskAversions Risk aversions to evaluate
+     * @param count Number of risk aversions
+     * @param points Output, one point per risk aversion
+     */
+    void frontier(double orderSize, const ExecutionProblem& problem,
+                  const double* riskAversions, size_t count, FrontierPoint* points);
+
+    /**
+     * @brief Get the number of cached trajectories
+     * @return Cache size
+     */
+    size_t cacheSize() const;
+
+private:
+    /**
+     * @brief Trajectory of a unit order
+     */
+    struct Trajectory {
+        std::vector<double> tradeFractions;  // n_j / X, j = 1..N
+        double sumSquaredTrades = 0.0;       // Sum of (n_j / X)^2
+        double sumSquaredHoldings = 0.0;     // Sum of (x_j / X)^2, j = 1..N
+    };
+
+    using Key = std::tuple<double, double, int>;
+
+    size_t cacheCapacity_;
+    std::map<Key, std::shared_ptr<const Trajectory>> cache_;
+    mutable std::mutex cacheMutex_;
+
+    /**
+     * @brief Look up or build the normalized trajectory of (kappa, T, N)
+     */
+    std::shared_ptr<const Trajectory> trajectory(double kappa, double timeHorizon, int numSteps);
+
+    /**
+     * @brief Build the normalized trajectory of (kappa, T, N)
+     */
+    static std::shared_ptr<const Trajectory> buildTrajectory(double kappa, double timeHorizon,
+                                                             int numSteps);
+
+    /**
+     * @brief Price a normalized trajectory for an order
+     */
+    static FrontierPoint price(double orderSize, const ExecutionProblem& problem,
+                               const Trajectory& trajectory);
+};
+
+} // namespace models
+} // namespace trade_simulator 
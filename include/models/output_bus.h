@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "data/orderbook_types.h"
+#include "models/simulator.h"
+#include "utils/broadcast_ring.h"
+#include "utils/shared_memory.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief One update on the output bus: the simulator output and the statistics it priced
+ */
+struct OutputBusRecord {
+    SimulatorOutput output;
+    data::OrderbookStats stats;
+};
+
+/**
+ * @brief Layout version of OutputBusRecord; bump it whenever either struct changes
+ */
+constexpr uint32_t kOutputBusLayoutVersion = 4;
+
+/**
+ * @brief Publishes simulator outputs to other processes through a shared-memory ring
+ *
+ * Creates the POSIX shared-memory object and broadcasts one OutputBusRecord per update.
+ * Publishing copies the record into the ring without locks or system calls, so it adds
+ * well under a microsecond to the processing thread; readers in other processes only map
+ * the object read-only and can never stall it. The object is removed with the publisher.
+ */
+class OutputBusPublisher {
+public:
+    /**
+     * @brief Constructor
+     * @param name Shared-memory object name, e.g. "/trade_simulator"
+     * @param capacity Records kept for lagging readers; rounded up to a power of two
+     * @throws std::runtime_error if the object cannot be created
+     */
+    explicit OutputBusPublisher(const std::string& name, size_t capacity = 1024);
+
+    /**
+     * @brief Broadcast one update (one thread at a time)
+     * @param output Simulator output
+     * @param stats Statistics the output was computed from
+     */
+    void publish(const SimulatorOutput& output, const data::OrderbookStats& stats);
+
+    /**
+     * @brief Get the number of records published
+     * @return Records since the bus was created
+     */
+    uint64_t published() const { return ring_->published(); }
+
+private:
+    utils::SharedMemoryRegion region_;
+    std::unique_ptr<utils::BroadcastRingWriter<OutputBusRecord>> ring_;
+};
+
+/**
+ * @brief Reads the output bus of a simulator running in another process
+ */
+class OutputBusReader {
+public:
+    /**
+     * @brief Attach to a bus; the first next() returns the next new record
+     * @param name Shared-memory object name the publisher was created with
+     * @throws std::runtime_error if there is no bus of this layout under the name
+     */
+    explicit OutputBusReader(const std::string& name);
+
+    /**
+     * @brief Read the next unread record; after lagging a full ring, the newest one
+     * @param record Receives the record
+     * @return False if nothing new has been published
+     */
+    bool next(OutputBusRecord& record) { return ring_->next(record); }
+
+    /**
+     * @brief Read the newest record
+     * @param record Receives the record
+     * @return False if nothing has been published yet
+     */
+    bool latest(OutputBusRecord& record) const { return ring_->latest(record); }
+
+    /**
+     * @brief Get the number of records skipped because the reader lagged
+     * @return Records lost to being lapped
+     */
+    uint64_t missed() const { return ring_->missed(); }
+
+    /**
+     * @brief Check if the publisher has gone away
+     * @return True once the publisher was destroyed
+     */
+    bool isClosed() const { return ring_->isClosed(); }
+
+private:
+    utils::SharedMemoryRegion region_;
+    std::unique_ptr<utils::BroadcastRingReader<OutputBusRecord>> ring_;
+};
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "models/simulator.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Destination of simulator outputs in headless runs
+ *
+ * publish() runs on the processing thread for every output, so implementations format
+ * into a fixed buffer and never allocate or block on the consumer. Sinks are not
+ * thread-safe; callers publishing from several threads serialize the calls.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Write one output
+     * @param output Simulator output
+     * @param instrument Value of the leading instrument column, if the sink has one
+     */
+    virtual void publish(const SimulatorOutput& output, const char* instrument = nullptr) = 0;
+
+    /**
+     * @brief Push buffered outputs to the destination
+     */
+    virtual void flush() {}
+};
+
+/**
+ * @brief Column names of formatOutputCsv, without a trailing newline
+ */
+extern const char* const kOutputCsvHeader;
+
+/**
+ * @brief Column name of the optional leading instrument column, with its separator
+ */
+extern const char* const kInstrumentCsvColumn;
+
+/**
+ * @brief Format an output as one CSV row
+ * @param output Simulator output
+ * @param buffer Destination
+ * @param capacity Size of the destination
+ * @param instrument Leading instrument column; none if null
+ * @return Length of the row including its newline, or 0 if it does not fit
+ */
+size_t formatOutputCsv(const SimulatorOutput& output, char* buffer, size_t capacity,
+                       const char* instrument = nullptr);
+
+/**
+ * @brief Create the sink for a target
+ *
+ * "-" writes CSV rows to stdout, "udp://host:port" sends one CSV row per datagram, and
+ * anything else is a CSV file to create.
+ *
+ * @param target Output target
+ * @param instrumentColumn Start every row with the instrument passed to publish()
+ * @return Sink
+ * @throws std::runtime_error if the target cannot be opened or resolved
+ */
+std::unique_ptr<OutputSink> createOutputSink(const std::string& target, bool instrumentColumn = false);
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "data/depth_profile.h"
+#include "data/orderbook_types.h"
+#include "data/rolling_volatility.h"
+#include "models/market_impact.h"
+#include "models/transaction_cost.h"
+#include "utils/work_stealing_pool.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief A recorded session decoded once into per-update statistics and book fills
+ *
+ * Holds everything a cost configuration needs from the book: the statistics of every
+ * update and, for each sweep quantity, the fill of a buy order walked against that book.
+ * None of it depends on the model parameters, so a sweep reads it concurrently from all
+ * workers without copying or locking.
+ */
+class SweepSession {
+public:
+    /**
+     * @brief Decode a recorded session
+     *
+     * Runs the recording through an OrderbookProcessor, with its recorded receive times,
+     * and keeps every update the book was synchronized for.
+     *
+     * @param path Feed log (FeedRecorder) or book store (BookStoreWriter)
+     * @param quantities Order sizes to evaluate, in USD equivalent
+     * @param volatilityConfig Window and estimator used for the price volatility
+     * @param symbol Instrument to keep, e.g. "BTC-USDT-SWAP"; empty keeps the first one
+     * @return The decoded session
+     * @throws std::runtime_error if the recording cannot be read
+     */
+    static SweepSession load(const std::string& path, const std::vector<double>& quantities,
+                             const data::VolatilityConfig& volatilityConfig = data::VolatilityConfig(),
+                             const std::string& symbol = "");
+
+    /**
+     * @brief Get the order sizes of the session
+     * @return Sizes in USD equivalent
+     */
+    const std::vector<double>& quantities() const { return quantities_; }
+
+    /**
+     * @brief Get the number of updates
+     * @return Updates with statistics
+     */
+    size_t tickCount() const { return stats_.size(); }
+
+    /**
+     * @brief Get the statistics of an update
+     * @param tick Update index
+     * @return Statistics published for the update
+     */
+    const data::OrderbookStats& stats(size_t tick) const { return stats_[tick]; }
+
+    /**
+     * @brief Get the fill of one quantity against the book of an update
+     * @param tick Update index
+     * @param quantity Index into quantities()
+     * @return Buy fill of the quantity in base units
+     */
+    const data::FillEstimate& fill(size_t tick, size_t quantity) const {
+        return fills_[tick * quantities_.size() + quantity];
+    }
+
+    /**
+     * @brief Get the instrument of the session
+     * @return Symbol of the kept updates
+     */
+    const std::string& symbol() const { return symbol_; }
+
+private:
+    std::vector<double> quantities_;
+    std::vector<data::OrderbookStats> stats_;
+    std::vector<data::FillEstimate> fills_;  // tickCount() x quantities().size(), row-major
+    std::string symbol_;
+};
+
+/**
+ * @brief Values of each model parameter to sweep; the sweep runs their Cartesian product
+ */
+struct SweepGrid {
+    std::vector<double> permanentImpactFactors{AlmgrenChrissParams().permanentImpactFactor};
+    std::vector<double> temporaryImpactFactors{AlmgrenChrissParams().temporaryImpactFactor};
+    std::vector<double> riskAversions{AlmgrenChrissParams().riskAversion};
+    std::vector<int> feeTiers{0};
+    std::vector<double> slippageVolumeFactors{SlippageCoefficients().volumeFactor};
+    std::vector<double> slippageVolatilityFactors{SlippageCoefficients().volatilityFactor};
+    std::vector<double> slippageImbalanceFactors{SlippageCoefficients().imbalanceFactor};
+
+    // Parameters shared by every configuration
+    double volatility = 0.0;       // Almgren-Chriss volatility; 0 uses the market volatility
+    double timeHorizon = AlmgrenChrissParams().timeHorizon;
+    int executionSteps = 10;       // Steps of the optimal execution schedule
+
+    /**
+     * @brief Get the number of configurations
+     * @return Product of the value counts
+     */
+    size_t configurationCount() const;
+};
+
+/**
+ * @brief One point of a sweep grid
+ */
+struct SweepConfiguration {
+    AlmgrenChrissParams impact;
+    FeeModel fees;
+    SlippageCoefficients slippage;
+    int executionSteps = 10;
+};
+
+/**
+ * @brief Cost metrics of one configuration and quantity, averaged over a session
+ *
+ * Costs are in price units, as in SimulatorOutput; the order is a buy, as in the simulator.
+ */
+struct SweepResult {
+    SweepConfiguration configuration;
+    double quantity = 0.0;             // Order size in USD equivalent
+    uint64_t ticks = 0;                // Updates evaluated
+    double meanSlippage = 0.0;         // Regression estimate
+    double meanWalkedSlippage = 0.0;   // Fill against the book, regression for the residual
+    double slippageRmse = 0.0;         // Regression estimate against the walked fill
+    double meanMarketImpact = 0.0;
+    double meanFees = 0.0;
+    double meanTotalCost = 0.0;        // Walked slippage + market impact + fees
+    double meanExecutionCost = 0.0;    // Expected cost of the optimal execution schedule
+    double meanExecutionVariance = 0.0;
+};
+
+/**
+ * @brief Get a configuration of a grid
+ * @param grid Sweep grid
+ * @param index Configuration index, below grid.configurationCount()
+ * @return The configuration; the last parameter of the grid varies fastest
+ */
+SweepConfiguration sweepConfiguration(const SweepGrid& grid, size_t index);
+
+/**
+ * @brief Evaluate every configuration of a grid over a session
+ *
+ * The work is split into (configuration, block of updates) tasks run on the pool. Each
+ * task sums into its own slot, so workers never share mutable state; the slots are then
+ * reduced in a fixed order, which makes the results independent of the thread count and
+ * of which worker ran which task.
+ *
+ * @param session Decoded session, shared read-only by all workers
+ * @param grid Parameter values to sweep
+ * @param pool Workers to run on
+ * @return One result per configuration and quantity, configuration-major
+ */
+std::vector<SweepResult> runParameterSweep(const SweepSession& session, const SweepGrid& grid,
+                                           utils::WorkStealingPool& pool);
+
+/**
+ * @brief Write sweep results as a CSV table with a header row
+ * @param out Output stream
+ * @param results Results of runParameterSweep
+ */
+void writeSweepCsv(std::ostream& out, const std::vector<SweepResult>& results);
+
+} // namespace models
+} // namespace trade_simulator 
\ No newline at end of file
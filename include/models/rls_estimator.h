@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Recursive least squares estimator of a linear model with a forgetting factor
+ *
+ * Fits y = theta . x online, weighting an observation n updates old by lambda^n. Each
+ * update is O(K^2) on fixed-size arrays and never allocates. The covariance trace is
+ * capped, so long stretches of uninformative inputs (e.g. a constant order size) cannot
+ * wind it up until the next informative observation throws the coefficients off.
+ *
+ * @tparam K Number of coefficients
+ */
+template <size_t K>
+class RlsEstimator {
+public:
+    using Vector = std::array<double, K>;
+
+    /**
+     * @brief Constructor
+     * @param initial Initial coefficients
+     * @param forgettingFactor lambda in (0, 1]; the memory is about 1 / (1 - lambda) updates
+     * @param initialCovariance Initial diagonal covariance; larger adapts faster at first
+     * @param maxCovarianceTrace Cap on the covariance trace
+     */
+    explicit RlsEstimator(const Vector& initial = Vector{}, double forgettingFactor = 0.999,
+                          double initialCovariance = 1.0, double maxCovarianceTrace = 1e6)
+        : lambda_(forgettingFactor), initialCovariance_(initialCovariance),
+          maxTrace_(maxCovarianceTrace) {
+        reset(initial);
+    }
+
+    /**
+     * @brief Restart the fit from the given coefficients
+     * @param initial Initial coefficients
+     */
+    void reset(const Vector& initial) {
+        theta_ = initial;
+        covariance_.fill(0.0);
+        for (size_t i = 0; i < K; ++i) {
+            covariance_[i * K + i] = initialCovariance_;
+        }
+        updates_ = 0;
+    }
+
+    /**
+     * @brief Add an observation
+     * @param x Regressors
+     * @param y Observed value
+     * @return Prediction error of the coefficients before the update
+     */
+    double update(const Vector& x, double y) {
+        // Px = P * x, denominator = lambda + x' P x
+        Vector px{};
+        for (size_t i = 0; i < K; ++i) {
+            double sum = 0.0;
+            for (size_t j = 0; j < K; ++j) {
+                sum += covariance_[i * K + j] * x[j];
+            }
+            px[i] = sum;
+        }
+        double denominator = lambda_;
+        for (size_t i = 0; i < K; ++i) {
+            denominator += x[i] * px[i];
+        }
+
+        double error = y - predict(x);
+        if (!(denominator > 0.0)) {
+            return error;
+        }
+
+        // Gain k = Px / denominator; theta += k * error; P = (P - k Px') / lambda
+        double inverseDenominator = 1.0 / denominator;
+        double inverseLambda = 1.0 / lambda_;
+        double trace = 0.0;
+        for (size_t i = 0; i < K; ++i) {
+            double gain = px[i] * inverseDenominator;
+            theta_[i] += gain * error;
+            for (size_t j = 0; j < K; ++j) {
+                covariance_[i * K + j] = (covariance_[i * K + j] - gain * px[j]) * inverseLambda;
+            }
+            trace += covariance_[i * K + i];
+        }
+        if (trace > maxTrace_) {
+            double scale = maxTrace_ / trace;
+            for (double& value : covariance_) {
+                value *= scale;
+            }
+        }
+
+        ++updates_;
+        return error;
+    }
+
+    /**
+     * @brief Evaluate the model
+     * @param x Regressors
+     * @return theta . x
+     */
+    double predict(const Vector& x) const {
+        double sum = 0.0;
+        for (size_t i = 0; i < K; ++i) {
+            sum += theta_[i] * x[i];
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Get the current coefficients
+     * @return theta
+     */
+    const Vector& coefficients() const { return theta_; }
+
+    /**
+     * @brief Get the number of observations since the last reset
+     * @return Updates applied
+     */
+    uint64_t updateCount() const { return updates_; }
+
+private:
+    double lambda_;
+    double initialCovariance_;
+    double maxTrace_;
+    Vector theta_{};
+    std::array<double, K * K> covariance_{};
+    uint64_t updates_ = 0;
+};
+
+} // namespace models
+} // namespace trade_simulator
@@ -5,12 +5,26 @@
 #include <functional>
 #include <mutex>
 #include <atomic>
-#include <QMetaType>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 
-#include "data/websocket_client.h"
+#include "data/feed_source.h"
+#include "data/orderbook_dispatcher.h"
 #include "data/orderbook_processor.h"
+#include "data/queue_tracker.h"
+#include "data/replay_feed_source.h"
+#include "models/cost_memo.h"
+#include "models/cost_surface.h"
+#include "models/execution_monte_carlo.h"
 #include "models/market_impact.h"
+#include "models/slippage_calibrator.h"
+#include "models/staleness_breaker.h"
 #include "models/transaction_cost.h"
+#include "utils/latency_histogram.h"
+#include "utils/seqlock.h"
+#include "utils/thread_affinity.h"
+#include "utils/work_stealing_pool.h"
 
 namespace trade_simulator {
 namespace models {
@@ -21,15 +35,93 @@ namespace models {
 struct SimulatorParams {
     std::string exchange = "OKX";
     std::string symbol = "BTC-USDT";
-    std::string orderType = "market";
+    std::string orderType = "market";  // Or "limit": rest at the touch, take the rest at the end
     double quantity = 100.0;  // In USD equivalent
     double volatility = 0.0;  // Market parameter (will be overridden by market data)
     int feeTier = 0;
     
+    // Cost curve evaluated on every update: order sizes spaced geometrically
+    // between the bounds (in USD equivalent), on both sides
+    int costCurvePoints = 64;            // 0 disables the curve
+    double costCurveMinQuantity = 10.0;
+    double costCurveMaxQuantity = 1000000.0;
+    
     // Default constructor
     SimulatorParams() = default;
 };
 
+/**
+ * @brief The numeric part of SimulatorParams read on every update
+ *
+ * Trivially copyable, so the processing thread can read it through a sequence lock
+ * without locking or allocating.
+ */
+struct PricingParams {
+    bool limitOrder = false;
+    double quantity = 100.0;
+    double volatility = 0.0;
+    int feeTier = 0;
+    int costCurvePoints = 64;
+    double costCurveMinQuantity = 10.0;
+    double costCurveMaxQuantity = 1000000.0;
+    
+    // Default constructor
+    PricingParams() = default;
+    
+    // Constructor from the full parameters
+    explicit PricingParams(const SimulatorParams& params)
+        : limitOrder(params.orderType == "limit"), quantity(params.quantity), volatility(params.volatility), feeTier(params.feeTier),
+          costCurvePoints(params.costCurvePoints),
+          costCurveMinQuantity(params.costCurveMinQuantity),
+          costCurveMaxQuantity(params.costCurveMaxQuantity) {}
+};
+
+/**
+ * @brief Threading and queueing configuration of the simulator
+ */
+struct SimulatorConfig {
+    // Queue between the network thread and the processing thread
+    data::DispatcherConfig dispatcher;
+    
+    // CPU and busy polling of the thread delivering updates (the CPU also applies to replays)
+    utils::ThreadConfig networkThread;
+    
+    // Feed: the live WebSocket feed, optionally recorded, or a replayed log
+    std::string recordPath;        // Live only: record raw messages to this feed log
+    bool hotStandby = false;       // Live only: keep a second connection to fail over to
+    std::string replayPath;        // Replay this feed log instead of connecting
+    data::ReplayMode replayMode = data::ReplayMode::RealTime;
+    double replaySpeed = 1.0;
+    
+    // Online calibration of the slippage regression against walked fills
+    bool calibrateSlippage = true;
+    SlippageCalibrationConfig slippageCalibration;
+    
+    // Reuse the costs of an earlier update whose inputs quantize the same (CostMemo)
+    bool memoizeCosts = true;
+    CostMemoConfig costMemo;
+    
+    // Shared-memory output bus (OutputBusPublisher) for other processes; empty disables it
+    std::string outputBusName;
+    size_t outputBusCapacity = 1024;
+    
+    // Staleness limits; past them outputs are flagged and, by default, not published
+    StalenessConfig staleness;
+    
+    // Monte Carlo cost distribution of the optimal execution schedule, re-run on the
+    // latest book every monteCarlo.intervalMs on a thread pool of its own
+    bool simulateExecutionRisk = false;
+    MonteCarloConfig monteCarlo;
+    
+    // Limit orders: queue position of the order resting at the touch, and how long it
+    // rests before the unfilled rest is taken at market
+    data::QueueTrackerConfig queueTracker;
+    double limitOrderHorizonSeconds = 10.0;
+    
+    // Default constructor
+    SimulatorConfig() = default;
+};
+
 /**
  * @brief Output metrics from the simulator
  */
@@ -41,8 +133,18 @@ struct SimulatorOutput {
     double netCost = 0.0;
     double makerProportion = 0.0;
     
+    // Fill of a limit order over SimulatorConfig::limitOrderHorizonSeconds; a market order
+    // fills at once
+    double fillProbability = 1.0;
+    double expectedTimeToFill = 0.0;  // Seconds, -1 while its level has not traded yet
+    double queueAhead = 0.0;          // Base units resting in front of the order
+    
     // Performance metrics
     double internalLatency = 0.0;  // In microseconds
+    int64_t readNs = 0;            // Read stamp of the update (utils::nowNanoseconds), 0 if none
+    int64_t publishedNs = 0;       // When the output was handed to the callback
+    bool stale = false;            // Priced from a stale book, or while the breaker was open
+    bool costsChanged = true;      // False if the cost inputs are those of the previous output
     
     // Market metrics
     double midprice = 0.0;
@@ -53,6 +155,8 @@ struct SimulatorOutput {
     SimulatorOutput() = default;
 };
 
+class OutputBusPublisher;
+
 /**
  * @brief Callback type for simulator output updates
  */
@@ -66,8 +170,9 @@ public:
     /**
      * @brief Constructor
      * @param callback Function to call with updated simulation results
+     * @param config Threading and queueing configuration
      */
-    explicit Simulator(SimulatorCallback callback);
+    explicit Simulator(SimulatorCallback callback, const SimulatorConfig& config = SimulatorConfig());
     
     /**
      * @brief Destructor
@@ -98,40 +203,140 @@ public:
     
     /**
      * @brief Get the latest simulator output
+     *
+     * Wait-free for the processing thread; safe to call from any thread.
+     *
      * @return Latest output
      */
     SimulatorOutput getLatestOutput() const;
     
+    /**
+     * @brief Get the cost curves computed from the latest update
+     * @return Costs over the configured range of order sizes, for both sides
+     */
+    CostSurface getLatestCostSurface() const;
+    
+    /**
+     * @brief Get the latest simulated cost distribution of the optimal execution schedule
+     * @return Distribution of a buy of the current quantity; empty if execution risk is
+     *         not simulated or no book has arrived yet
+     */
+    CostDistribution getLatestCostDistribution() const;
+    
     /**
      * @brief Check if the simulator is running
      * @return True if running, false otherwise
      */
     bool isRunning() const;
     
+    /**
+     * @brief Check if the feed is delivering updates
+     * @return True while connected, or while a replay has messages left
+     */
+    bool isFeedConnected() const;
+    
+    /**
+     * @brief Get the counters of the queue feeding the processing thread
+     * @return Queue depth and dropped/conflated snapshot counters
+     */
+    data::DispatcherStats getQueueStats() const;
+    
+    /**
+     * @brief Get the per-stage latency histograms
+     *
+     * The simulator records every stage up to its output; the receiver of the output
+     * records UiDispatch and EndToEnd from the output's stamps.
+     *
+     * @return Histograms, safe to record into and read from any thread
+     */
+    utils::PipelineLatency& getLatency() { return latency_; }
+    
+    /**
+     * @brief Get the counters of the cost memo
+     * @return Hits and misses; all zero if costs are not memoized
+     */
+    CostMemoStats getCostMemoStats() const;
+    
+    /**
+     * @brief Check whether the book being priced is stale
+     * @return True while the staleness breaker is open or the feed has been silent too long
+     */
+    bool isStale() const;
+    
 private:
     // Callback for output updates
     SimulatorCallback callback_;
+    SimulatorConfig config_;
     
-    // Parameters and output
+    // Parameters: the full set for updateParams/getParams, serialized by paramsMutex_,
+    // and the numeric part the processing thread reads on every update
     SimulatorParams params_;
-    SimulatorOutput latestOutput_;
     mutable std::mutex paramsMutex_;
-    mutable std::mutex outputMutex_;
+    utils::SeqLock<PricingParams> pricingParams_;
+    
+    // Latest output, published by the processing thread
+    utils::SeqLock<SimulatorOutput> latestOutput_;
+    
+    // Per-stage latency histograms
+    utils::PipelineLatency latency_;
+    
+    // Cost curves: filled on the processing thread, then swapped into the latest unless
+    // a reader holds it at that moment
+    CostSurface workingCostSurface_;
+    CostSurface latestCostSurface_;
+    std::vector<double> costCurveSizes_;
+    mutable std::mutex costSurfaceMutex_;
     
     // Running state
     std::atomic<bool> isRunning_{false};
     
     // Components
-    std::shared_ptr<data::WebSocketClient> webSocketClient_;
+    std::shared_ptr<data::FeedSource> feedSource_;
     std::shared_ptr<data::OrderbookProcessor> orderbookProcessor_;
+    std::shared_ptr<data::OrderbookDispatcher> orderbookDispatcher_;
     std::shared_ptr<MarketImpactModel> marketImpactModel_;
     std::shared_ptr<TransactionCostModel> transactionCostModel_;
     
+    // Slippage calibration (processing thread only); reset requested by instrument changes
+    std::unique_ptr<SlippageCalibrator> slippageCalibrator_;
+    std::atomic<bool> calibrationResetPending_{false};
+    
+    // Memoized costs (processing thread only), cleared whenever updateParams bumps the version
+    std::unique_ptr<CostMemo> costMemo_;
+    std::atomic<uint64_t> parametersVersion_{0};
+    
+    // Virtual limit order at the touch, advanced by the processor (processing thread only)
+    data::QueueTracker queueTracker_;
+    data::VirtualOrderId limitOrder_ = data::kNoVirtualOrder;
+    double limitOrderQuantity_ = 0.0;  // USD quantity the order was placed for
+    
+    // Staleness of the books priced, checked on the processing thread
+    StalenessBreaker stalenessBreaker_;
+    
+    // Shared-memory broadcast of every output, if configured
+    std::unique_ptr<OutputBusPublisher> outputBus_;
+    
+    // Execution risk: Monte Carlo runs on their own thread and pool, off the processing thread
+    std::unique_ptr<utils::WorkStealingPool> riskPool_;
+    std::unique_ptr<ExecutionMonteCarlo> monteCarlo_;
+    utils::SeqLock<CostDistribution> latestCostDistribution_;
+    std::thread riskThread_;
+    std::mutex riskMutex_;
+    std::condition_variable riskWakeup_;
+    bool riskStopRequested_ = false;
+    
     /**
      * @brief Initialize the simulator components
      */
     void initializeComponents();
     
+    /**
+     * @brief Get the instrument selected in the parameters
+     * @param params Simulator parameters
+     * @return Instrument name of the selected symbol
+     */
+    static std::string instrumentFor(const SimulatorParams& params);
+    
     /**
      * @brief Handle orderbook statistics updates
      * @param stats Updated orderbook statistics
@@ -141,12 +346,38 @@ private:
     /**
      * @brief Update simulation results based on current market conditions
      * @param stats Current orderbook statistics
+     * @param output Output to fill
      */
-    void updateSimulation(const data::OrderbookStats& stats);
+    void updateSimulation(const data::OrderbookStats& stats, SimulatorOutput& output);
+    
+    /**
+     * @brief Body of the risk thread: simulate the schedule on the latest book until stopped
+     */
+    void runExecutionRisk();
+    
+    /**
+     * @brief Price the order as a limit order resting at the touch
+     *
+     * Keeps one virtual order at the best price of its side, placed again once it filled,
+     * was outbid or the quantity changed, and takes its maker/taker split from the queue
+     * tracker's forecast.
+     *
+     * @param baseQuantity Order size in base units
+     * @param orderSide True for buy, false for sell
+     * @param params Current parameters
+     * @param stats Current orderbook statistics
+     * @param output Output to fill in
+     */
+    void priceLimitOrder(double baseQuantity, bool orderSide, const PricingParams& params,
+                         const data::OrderbookStats& stats, SimulatorOutput& output);
+    
+    /**
+     * @brief Evaluate the cost curves of both sides for the current update
+     * @param params Current parameters
+     * @param stats Current orderbook statistics
+     */
+    void updateCostSurface(const PricingParams& params, const data::OrderbookStats& stats);
 };
 
 } // namespace models
-} // namespace trade_simulator
-
-// Declare the metatype for SimulatorOutput globally after its definition
-Q_DECLARE_METATYPE(trade_simulator::models::SimulatorOutput) 
\ No newline at end of file
+} // namespace trade_simulator 
\ No newline at end of file
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "data/orderbook_dispatcher.h"
+#include "data/replay_feed_source.h"
+#include "data/websocket_client.h"
+#include "models/cost_memo.h"
+#include "models/simulator.h"
+#include "models/slippage_calibrator.h"
+#include "models/smart_order_router.h"
+#include "utils/arena.h"
+#include "utils/latency_histogram.h"
+#include "utils/thread_affinity.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief One instrument priced by the engine
+ */
+struct EngineInstrumentConfig {
+    std::string exchange = "OKX";
+    std::string instrument;     // Feed name, e.g. "BTC-USDT-SWAP"; a pair such as "BTC-USDT" means its perpetual
+    double quantity = 100.0;    // Order size in USD equivalent
+    double volatility = 0.0;    // Almgren-Chriss volatility; 0 uses the book's
+    int feeTier = 0;
+
+    // Default constructor
+    EngineInstrumentConfig() = default;
+
+    // Constructor with the instrument name
+    explicit EngineInstrumentConfig(std::string name) : instrument(std::move(name)) {}
+};
+
+/**
+ * @brief Instruments, shards and threads of a SimulatorEngine
+ */
+struct SimulatorEngineConfig {
+    std::vector<EngineInstrumentConfig> instruments;
+
+    // Workers; instruments are dealt out round-robin. shardCpus[i] pins shard i
+    size_t shards = 1;
+    std::vector<int> shardCpus;
+    bool busyPoll = false;                // Shards spin while idle instead of backing off
+    size_t maxUpdatesPerTurn = 4;         // Per instrument and pass, so a hot one cannot starve the rest
+
+    // Feed: live over a pool of ioThreads I/O threads, or a replay of all instruments
+    size_t ioThreads = 1;
+    utils::ThreadConfig networkThread;
+    bool hotStandby = false;  // Keep a second connection per instrument to fail over to
+    std::string replayPath;
+    data::ReplayMode replayMode = data::ReplayMode::RealTime;
+    double replaySpeed = 1.0;
+
+    // Per instrument
+    size_t queueCapacity = 16;
+    data::OverflowPolicy overflowPolicy = data::OverflowPolicy::ConflateLatest;
+    bool calibrateSlippage = true;
+    SlippageCalibrationConfig slippageCalibration;
+    bool memoizeCosts = true;
+    CostMemoConfig costMemo;
+    StalenessConfig staleness;
+
+    // One order routed across all instruments, each taken as a venue of the same asset
+    RouterConfig routing;
+
+    // Default constructor
+    SimulatorEngineConfig() = default;
+};
+
+/**
+ * @brief Totals over all instruments of an engine
+ */
+struct EngineAggregate {
+    size_t instruments = 0;
+    size_t pricedInstruments = 0;     // Instruments with at least one output
+    size_t staleInstruments = 0;      // Instruments whose book is stale now
+    uint64_t updates = 0;             // Outputs over all instruments
+    uint64_t conflated = 0;           // Snapshots superseded in the instruments' queues
+    uint64_t costMemoHits = 0;        // Outputs whose costs came from an instrument's memo
+    uint64_t costMemoMisses = 0;
+    double totalSlippage = 0.0;       // Sums of the latest output of each instrument
+    double totalFees = 0.0;
+    double totalMarketImpact = 0.0;
+    double totalNetCost = 0.0;
+    double maxInternalLatency = 0.0;  // Slowest latest model evaluation, in microseconds
+    size_t busiestShard = 0;          // Shard with the most updates
+    uint64_t busiestShardUpdates = 0;
+};
+
+/**
+ * @brief Callback with the instrument index and its new output, run on the shard's thread
+ */
+using EngineCallback = std::function<void(size_t instrument, const SimulatorOutput& output)>;
+
+/**
+ * @brief Prices many instruments at once, sharded across pinned worker threads
+ *
+ * Every instrument has its own book, statistics, cost models and calibration, fed through
+ * its own SPSC queue, so instruments never share mutable state. Each shard thread owns a
+ * fixed set of instruments, allocated together in the shard's arena, and visits them in
+ * turn, processing at most maxUpdatesPerTurn updates each: under a burst on one symbol the
+ * others still get a turn every pass, and conflation keeps the hot symbol's queue current.
+ * Outputs are published per instrument through sequence locks and read from any thread.
+ *
+ * With routing on, the instruments are taken as venues of one asset: each update also
+ * publishes the instrument's depth, fee and impact coefficients, then re-routes the
+ * configured order over the latest quotes of all venues, on the updating instrument's shard.
+ *
+ * The instrument set is fixed at construction.
+ */
+class SimulatorEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param callback Function to call with every output, on the shard threads; may be empty
+     * @param config Instruments, shards and feed
+     * @throws std::runtime_error if there are no instruments, a name repeats or routing is
+     *         on with more than data::kMaxVenues instruments
+     */
+    SimulatorEngine(EngineCallback callback, const SimulatorEngineConfig& config);
+
+    /**
+     * @brief Destructor
+     */
+    ~SimulatorEngine();
+
+    /**
+     * @brief Start the shards and the feed
+     */
+    void start();
+
+    /**
+     * @brief Stop the feed and the shards
+     */
+    void stop();
+
+    /**
+     * @brief Check if the engine is running
+     * @return True between start() and stop()
+     */
+    bool isRunning() const { return isRunning_; }
+
+    /**
+     * @brief Check if the feed is delivering updates
+     * @return True while connected, or while a replay has messages left
+     */
+    bool isFeedConnected() const;
+
+    /**
+     * @brief Get the number of instruments
+     * @return Instruments in configuration order
+     */
+    size_t instrumentCount() const { return instruments_.size(); }
+
+    /**
+     * @brief Get the name of an instrument
+     * @param instrument Instrument index
+     * @return Feed name
+     */
+    const std::string& instrumentName(size_t instrument) const;
+
+    /**
+     * @brief Get the shard an instrument runs on
+     * @param instrument Instrument index
+     * @return Shard index
+     */
+    size_t shardOf(size_t instrument) const { return instrument % shards_.size(); }
+
+    /**
+     * @brief Get the latest output of an instrument; wait-free, from any thread
+     * @param instrument Instrument index
+     * @return Latest output, default-constructed before the first update
+     */
+    SimulatorOutput getLatestOutput(size_t instrument) const;
+
+    /**
+     * @brief Get the queue counters of an instrument
+     * @param instrument Instrument index
+     * @return Queue depth and dropped/conflated snapshot counters
+     */
+    data::DispatcherStats getQueueStats(size_t instrument) const;
+
+    /**
+     * @brief Sum up the latest outputs of all instruments
+     * @return Cross-instrument totals
+     */
+    EngineAggregate getAggregate() const;
+
+    /**
+     * @brief Get the latest cross-venue route; wait-free, from any thread
+     * @return Newest allocation over the instruments in configuration order, default-constructed
+     *         before the first or with routing off
+     */
+    RouteAllocation getLatestRoute() const;
+
+    /**
+     * @brief Get the per-stage latency histograms, shared by all instruments
+     * @return Histograms
+     */
+    utils::PipelineLatency& getLatency() { return latency_; }
+
+private:
+    struct Instrument;
+    struct Shard;
+
+    SimulatorEngineConfig config_;
+    EngineCallback callback_;
+    std::atomic<bool> isRunning_{false};
+    utils::PipelineLatency latency_;
+
+    // Instruments in configuration order; owned by their shard's arena
+    std::vector<Instrument*> instruments_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    // Feed routing, read-only once constructed
+    std::unique_ptr<data::WebSocketClient> client_;
+    std::unique_ptr<data::ReplayFeedSource> replaySource_;
+    std::unordered_map<data::FeedId, size_t> instrumentByFeed_;
+    std::unordered_map<data::SymbolId, size_t> instrumentBySymbol_;
+
+    /**
+     * @brief Create the feed that routes updates to the instruments' queues
+     */
+    void initializeFeed();
+
+    /**
+     * @brief Shard thread body
+     * @param shard Shard to run
+     * @param index Shard index, for its CPU
+     */
+    void runShard(Shard& shard, size_t index);
+};
+
+} // namespace models
+} // namespace trade_simulator
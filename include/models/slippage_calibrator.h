@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "data/depth_profile.h"
+#include "data/orderbook_types.h"
+#include "models/rls_estimator.h"
+#include "models/transaction_cost.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Settings of the online slippage calibration
+ */
+struct SlippageCalibrationConfig {
+    double forgettingFactor = 0.999;      // Memory of about 1000 observations
+    double initialCovariance = 1.0;
+    uint64_t warmupObservations = 200;    // Observations before the first publication
+
+    // Default constructor
+    SlippageCalibrationConfig() = default;
+};
+
+/**
+ * @brief Online calibration of the slippage regression against fills walked on the book
+ *
+ * Each observation compares the regression's slippage for an order with the slippage of
+ * the same order filled against the book's levels, and updates the coefficients by
+ * recursive least squares. After the warm-up the coefficients are published to the cost
+ * model on every observation; the cost model hands them to readers through a sequence
+ * lock, so pricing never waits for calibration.
+ *
+ * Not thread-safe: observe() and reset() are meant to run on the processing thread.
+ */
+class SlippageCalibrator {
+public:
+    /**
+     * @brief Constructor
+     * @param costModel Model whose slippage coefficients are calibrated; its current
+     *                  coefficients are the starting point
+     * @param config Calibration settings
+     */
+    explicit SlippageCalibrator(std::shared_ptr<TransactionCostModel> costModel,
+                                const SlippageCalibrationConfig& config = SlippageCalibrationConfig());
+
+    /**
+     * @brief Add the walked fill of an order as an observation
+     *
+     * Fills the book could not complete are skipped, since their residual is priced by
+     * the regression itself.
+     *
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Orderbook statistics of the book the fill was walked on
+     * @param fill Result of DepthProfile::walk for the order
+     * @return True if the observation was used
+     */
+    bool observe(double orderSize, bool orderSide, const data::OrderbookStats& stats,
+                 const data::FillEstimate& fill);
+
+    /**
+     * @brief Restart from the initial coefficients and publish them, e.g. for a new instrument
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of observations used since the last reset
+     * @return Observations
+     */
+    uint64_t observationCount() const { return estimator_.updateCount(); }
+
+    /**
+     * @brief Get the prediction error of the last observation
+     * @return Realized minus predicted slippage, as a fraction of the midprice
+     */
+    double lastError() const { return lastError_; }
+
+private:
+    std::shared_ptr<TransactionCostModel> costModel_;
+    SlippageCalibrationConfig config_;
+    SlippageCoefficients initial_;
+    RlsEstimator<4> estimator_;
+    double lastError_ = 0.0;
+};
+
+} // namespace models
+} // namespace trade_simulator 
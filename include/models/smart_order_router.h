@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "data/consolidated_book.h"
+#include "models/market_impact.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief Order routed across the venues of a SimulatorEngine
+ */
+struct RouterConfig {
+    double quantity = 0.0;  // Order size in USD equivalent; 0 disables routing
+    bool buy = true;
+    size_t slices = 64;     // Parts of the order the greedy allocator hands out one at a time
+
+    // Default constructor
+    RouterConfig() = default;
+};
+
+/**
+ * @brief What the router needs of one venue: its depth, taker fee and impact coefficients
+ */
+struct VenueQuote {
+    data::VenueDepth depth;
+    double takerFeeRate = 0.0;
+    MarketImpactModel::ImpactCoefficients impact;
+    int64_t updatedNs = 0;  // When the venue's book was taken; 0 if it has none yet
+
+    // Default constructor
+    VenueQuote() = default;
+};
+
+/**
+ * @brief Share of a routed order sent to one venue; costs are in quote currency
+ */
+struct VenueAllocation {
+    double size = 0.0;          // Base units
+    double notional = 0.0;      // Walked against the venue's levels
+    double slippage = 0.0;      // Of the walked fill against the consolidated midprice
+    double fees = 0.0;          // At the venue's taker rate
+    double marketImpact = 0.0;  // Almgren-Chriss impact on the venue
+    double cost = 0.0;          // Sum of the three
+};
+
+/**
+ * @brief Split of an order across venues and its expected cost
+ */
+struct RouteAllocation {
+    size_t venues = 0;                                          // Venues considered
+    std::array<VenueAllocation, data::kMaxVenues> legs{};       // Per venue, in venue order
+    double quantity = 0.0;                                      // Base units requested
+    double routed = 0.0;                                        // Base units allocated; less if the depth ran out
+    double slippage = 0.0;
+    double fees = 0.0;
+    double marketImpact = 0.0;
+    double totalCost = 0.0;
+    double singleVenueCost = -1.0;                              // Cheapest venue taking it all, -1 if none can
+    data::ConsolidatedTop top;                                  // Of the consolidated book
+    int64_t publishedNs = 0;                                    // When the allocation was made; 0 before the first
+
+    // Default constructor
+    RouteAllocation() = default;
+};
+
+/**
+ * @brief Splits an order across venues to minimize its total expected cost
+ *
+ * Each venue's cost of a size q is the slippage of walking q through its levels against
+ * the consolidated midprice, the taker fee of its tier on the walked notional and its
+ * Almgren-Chriss impact. The allocator hands the order out in `slices` equal parts, each
+ * to the venue whose cost grows least per unit by taking it; a venue takes no more
+ * than its visible depth. Walking and fees are convex in q, so for them this greedy
+ * split converges to the optimum as the slices shrink. The square-root temporary impact
+ * is concave and favors concentrating the order, so the split is compared with the
+ * cheapest venue taking the whole order and the cheaper of the two is kept.
+ *
+ * Levels are looked up through per-venue prefix sums of size and notional, rebuilt from
+ * the venues' depth on every call together with the consolidated book, so a route costs
+ * a merge of the books plus slices binary searches. No call allocates.
+ */
+class SmartOrderRouter {
+public:
+    /**
+     * @brief Constructor
+     * @param slices Parts of the order the allocator hands out, at least 1
+     */
+    explicit SmartOrderRouter(size_t slices = 64);
+
+    /**
+     * @brief Consolidate the venues' books and split an order across them
+     * @param quotes Quote of each venue; venues without a book (updatedNs 0) take nothing
+     * @param count Venues, at most data::kMaxVenues
+     * @param quantity Order size in USD equivalent, converted at the consolidated midprice
+     * @param buy True for a buy, false for a sell
+     * @return Allocation, valid until the next call; empty if either side of the book is
+     */
+    const RouteAllocation& route(const VenueQuote* quotes, size_t count, double quantity, bool buy);
+
+    /**
+     * @brief Get the consolidated book of the last route() call
+     * @return Consolidated book
+     */
+    const data::ConsolidatedBook& book() const { return book_; }
+
+private:
+    // Prefix sums of one venue's side the order walks; entry i covers the best i levels
+    struct VenueCurve {
+        std::array<double, data::kVenueDepth + 1> cumSize;
+        std::array<double, data::kVenueDepth + 1> cumNotional;
+        const double* prices = nullptr;
+        size_t levels = 0;
+        double takerFeeRate = 0.0;
+        MarketImpactModel::ImpactCoefficients impact;
+    };
+
+    size_t slices_;
+    data::ConsolidatedBook book_;
+    std::array<VenueCurve, data::kMaxVenues> curves_;
+    RouteAllocation allocation_;
+
+    /**
+     * @brief Cost of routing a size to a venue
+     * @param curve Venue
+     * @param size Base units, at most the venue's visible depth
+     * @param midprice Consolidated midprice
+     * @param buy True for a buy
+     * @param leg Receives the cost components; may be nullptr
+     * @return Total cost
+     */
+    static double venueCost(const VenueCurve& curve, double size, double midprice, bool buy,
+                            VenueAllocation* leg);
+};
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "data/orderbook_types.h"
+
+namespace trade_simulator {
+namespace models {
+
+/**
+ * @brief When a book is too old to price from, and what happens to its output
+ */
+struct StalenessConfig {
+    int64_t maxExchangeLagMs = 2000;  // Exchange timestamp to read; live feeds only, 0 disables
+    int64_t maxQueueAgeMs = 500;      // Read to pricing, e.g. behind a backlog; 0 disables
+    int64_t maxSilenceMs = 2000;      // No update for this long makes the latest output stale
+    bool suppressStale = true;        // Publish nothing while the breaker is open
+    uint32_t recoveryUpdates = 3;     // Fresh updates in a row that close the breaker again
+
+    // Default constructor
+    StalenessConfig() = default;
+};
+
+/**
+ * @brief Circuit breaker that stops pricing from publishing on stale books
+ *
+ * Every update is checked against the lag limits. A stale update opens the breaker, and
+ * it stays open until recoveryUpdates fresh updates in a row have arrived, so a feed
+ * that flaps around the limit does not flicker between fresh and stale outputs. Feed
+ * silence is checked separately from the last update's time, which is kept in an atomic
+ * so any thread can poll it without locks.
+ *
+ * check() is meant for one thread, the one pricing the updates; the queries are safe
+ * from any thread.
+ */
+class StalenessBreaker {
+public:
+    /**
+     * @brief Constructor
+     * @param config Limits and recovery
+     */
+    explicit StalenessBreaker(const StalenessConfig& config = StalenessConfig());
+
+    /**
+     * @brief Check an update and move the breaker
+     * @param stats Statistics of the update
+     * @param nowNs utils::nowNanoseconds() at pricing
+     * @return True if the update is stale or the breaker is still open after it
+     */
+    bool check(const data::OrderbookStats& stats, int64_t nowNs);
+
+    /**
+     * @brief Check whether outputs should be withheld now
+     * @return True if the breaker is open and the config suppresses stale outputs
+     */
+    bool suppressing() const {
+        return config_.suppressStale && open_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check whether the latest output is stale now
+     * @param nowNs utils::nowNanoseconds()
+     * @return True if the breaker is open or no update arrived within the silence limit
+     */
+    bool isStale(int64_t nowNs) const;
+
+    /**
+     * @brief Get the number of times the breaker opened
+     * @return Trips since construction or the last reset
+     */
+    uint64_t trips() const { return trips_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Forget the state, e.g. after switching instruments
+     */
+    void reset();
+
+private:
+    StalenessConfig config_;
+    std::atomic<bool> open_{false};
+    std::atomic<int64_t> lastUpdateNs_{0};
+    std::atomic<uint64_t> trips_{0};
+    std::atomic<uint32_t> freshInRow_{0};  // Atomic only so reset() may run on another thread
+};
+
+} // namespace models
+} // namespace trade_simulator
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <memory>
+#include <tuple>
+#include "data/depth_profile.h"
 #include "data/orderbook_types.h"
+#include "models/cost_surface.h"
 #include "models/market_impact.h"
+#include "utils/seqlock.h"
 
 namespace trade_simulator {
 namespace models {
@@ -22,8 +27,41 @@ struct FeeModel {
     // Constructor with custom values
     FeeModel(double maker, double taker, int tier)
         : makerFeeRate(maker), takerFeeRate(taker), feeTier(tier) {}
+    
+    /**
+     * @brief Get the fee schedule of a tier
+     * @param tier Fee tier (0 = base, higher = better rates)
+     * @return Fee model of the tier
+     */
+    static FeeModel forTier(int tier);
+};
+
+/**
+ * @brief Coefficients of the slippage regression
+ */
+struct SlippageCoefficients {
+    double intercept = 0.0;
+    double volumeFactor = 0.1;       // Per unit of order size relative to the side's depth
+    double volatilityFactor = 0.2;   // Per unit of price volatility
+    double imbalanceFactor = -0.05;  // Per unit of (order imbalance - 1)
+    
+    // Default constructor
+    SlippageCoefficients() = default;
+    
+    // Constructor with custom values
+    SlippageCoefficients(double interceptValue, double volume, double volatility, double imbalance)
+        : intercept(interceptValue), volumeFactor(volume), volatilityFactor(volatility),
+          imbalanceFactor(imbalance) {}
 };
 
+/**
+ * @brief Regressors of the slippage regression, in the order of SlippageCoefficients
+ *
+ * (1, order size relative to the side's depth, price volatility, order imbalance - 1);
+ * the dot product with the coefficients is the slippage as a fraction of the midprice.
+ */
+using SlippageRegressors = std::array<double, 4>;
+
 /**
  * @brief Transaction cost model for estimating execution costs
  */
@@ -39,6 +77,10 @@ public:
     
     /**
      * @brief Set the fee model
+     *
+     * Published through a sequence lock like the slippage coefficients; only one thread
+     * may set the fee model at a time.
+     *
      * @param feeModel New fee model
      */
     void setFeeModel(const FeeModel& feeModel);
@@ -49,6 +91,32 @@ public:
      */
     FeeModel getFeeModel() const;
     
+    /**
+     * @brief Set the slippage regression coefficients
+     *
+     * Published through a sequence lock, so pricing on other threads never waits for
+     * it; only one thread may set the coefficients at a time.
+     *
+     * @param coefficients New coefficients
+     */
+    void setSlippageCoefficients(const SlippageCoefficients& coefficients);
+    
+    /**
+     * @brief Get the slippage regression coefficients
+     * @return Current coefficients
+     */
+    SlippageCoefficients getSlippageCoefficients() const;
+    
+    /**
+     * @brief Get the regressors of the slippage regression for an order
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @return Regressors for the order
+     */
+    static SlippageRegressors slippageRegressors(double orderSize, bool orderSide,
+                                                 const data::OrderbookStats& stats);
+    
     /**
      * @brief Calculate expected slippage for a market order
      * @param orderSize Size of the order in base units
@@ -59,6 +127,35 @@ public:
     double calculateSlippage(double orderSize, bool orderSide, 
                             const data::OrderbookStats& stats) const;
     
+    /**
+     * @brief Calculate slippage by filling the order against the book
+     *
+     * The order walks the levels of the depth profile; slippage is the distance of the fill
+     * VWAP from the midprice. Size the book cannot fill is priced at the worst level
+     * touched plus the regression estimate, so a thin book never looks cheap.
+     *
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @param profile Depth profile of the same book
+     * @return Expected slippage in price units
+     */
+    double calculateSlippage(double orderSize, bool orderSide,
+                            const data::OrderbookStats& stats,
+                            const data::DepthProfile& profile) const;
+    
+    /**
+     * @brief Calculate slippage from a fill already walked against the book
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Orderbook statistics of the book the fill was walked on
+     * @param fill Result of DepthProfile::walk for the order
+     * @return Expected slippage in price units
+     */
+    double calculateSlippage(double orderSize, bool orderSide,
+                            const data::OrderbookStats& stats,
+                            const data::FillEstimate& fill) const;
+    
     /**
      * @brief Calculate expected fees for a market order
      * @param orderSize Size of the order in base units
@@ -88,15 +185,91 @@ public:
     std::tuple<double, double, double, double> calculateTotalCost(
         double orderSize, bool orderSide, const data::OrderbookStats& stats) const;
     
+    /**
+     * @brief Calculate all transaction costs, with slippage from walking the book
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @param profile Depth profile of the same book
+     * @return Tuple of (slippage, marketImpact, fees, totalCost) in price units
+     */
+    std::tuple<double, double, double, double> calculateTotalCost(
+        double orderSize, bool orderSide, const data::OrderbookStats& stats,
+        const data::DepthProfile& profile) const;
+    
+    /**
+     * @brief Calculate all transaction costs, with slippage from a fill already walked
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Orderbook statistics of the book the fill was walked on
+     * @param fill Result of DepthProfile::walk for the order
+     * @return Tuple of (slippage, marketImpact, fees, totalCost) in price units
+     */
+    std::tuple<double, double, double, double> calculateTotalCost(
+        double orderSize, bool orderSide, const data::OrderbookStats& stats,
+        const data::FillEstimate& fill) const;
+    
+    /**
+     * @brief Calculate all transaction costs around a slippage already estimated
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @param slippage Expected slippage in price units, e.g. from calculateSlippage()
+     * @param makerProportion Receives the predicted maker proportion the fees used; may be nullptr
+     * @return Tuple of (slippage, marketImpact, fees, totalCost) in price units
+     */
+    std::tuple<double, double, double, double> calculateTotalCost(
+        double orderSize, bool orderSide, const data::OrderbookStats& stats, double slippage,
+        double* makerProportion = nullptr) const;
+    
+    /**
+     * @brief Calculate all transaction costs of a limit order resting at the touch
+     *
+     * The maker share fills passively at the best price of its own side, half the spread
+     * better than the midprice, and moves nothing; the rest is taken at the end as a market
+     * order, with the slippage of its walked fill and its market impact. Fees are charged
+     * on the whole order at the given maker/taker split.
+     *
+     * @param orderSize Size of the order in base units
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @param takerFill Result of DepthProfile::walk for the taker share of the order
+     * @param makerProportion Expected share of the order filled passively (0.0-1.0)
+     * @return Tuple of (slippage, marketImpact, fees, totalCost) in price units
+     */
+    std::tuple<double, double, double, double> calculateLimitOrderCost(
+        double orderSize, bool orderSide, const data::OrderbookStats& stats,
+        const data::FillEstimate& takerFill, double makerProportion) const;
+    
+    /**
+     * @brief Calculate all transaction costs for many order sizes on one side
+     *
+     * Terms that depend only on the statistics and fee model are computed once; the
+     * remaining per-size loops are branch-free so the compiler can vectorize them.
+     *
+     * @param orderSizes Sizes of the orders in base units
+     * @param count Number of sizes
+     * @param orderSide True for buy, false for sell
+     * @param stats Current orderbook statistics
+     * @param profile Depth profile of the same book, or nullptr for the regression slippage
+     * @param curve Output; resized to count
+     */
+    void calculateCostCurve(const double* orderSizes, size_t count, bool orderSide,
+                           const data::OrderbookStats& stats, const data::DepthProfile* profile,
+                           CostCurve& curve) const;
+    
 private:
     std::shared_ptr<MarketImpactModel> marketImpactModel_;
-    FeeModel feeModel_;
+    utils::SeqLock<FeeModel> feeModel_;
     
     // Regression coefficients for slippage model
-    double slippageIntercept_ = 0.0;
-    double slippageVolumeFactor_ = 0.1;
-    double slippageVolatilityFactor_ = 0.2;
-    double slippageImbalanceFactor_ = -0.05;
+    utils::SeqLock<SlippageCoefficients> slippage_;
+    
+    /**
+     * @brief Get the fraction of the visible depth on the side an order would consume
+     * @return Size-independent factor, 1 / total size of the side, or 0 if it is empty
+     */
+    static double inverseSideDepth(bool orderSide, const data::OrderbookStats& stats);
 };
 
 } // namespace models
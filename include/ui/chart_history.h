@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "ui/output_mailbox.h"
+
+namespace trade_simulator {
+namespace ui {
+
+/**
+ * @brief Fixed window of chart history in time buckets, rendered with min/max decimation
+ *
+ * Every bucket keeps the range of each series over its time slice, in a ring sized for
+ * the window, so adding a frame is O(1) and memory does not grow. Rendering merges
+ * adjacent buckets down to the requested point count and emits each group's minimum and
+ * maximum, so spikes stay visible however long the window. The maximum over the window
+ * is kept in a monotonic queue rather than rescanned.
+ */
+class ChartHistory {
+public:
+    /**
+     * @brief Constructor
+     * @param windowSeconds Time span kept
+     * @param bucketSeconds Time slice of one bucket
+     */
+    ChartHistory(double windowSeconds, double bucketSeconds);
+
+    /**
+     * @brief Add the outputs of a frame
+     * @param timeSeconds Time of the frame; must not decrease
+     * @param frame Outputs coalesced since the previous frame
+     */
+    void add(double timeSeconds, const OutputFrame& frame);
+
+    /**
+     * @brief Forget all history
+     */
+    void clear();
+
+    /**
+     * @brief Get the largest value of any series in the window
+     * @return Maximum, or 0 if the window is empty
+     */
+    double maximum() const;
+
+    /**
+     * @brief Get the end of the window
+     * @return Time of the newest bucket's end, or 0 if empty
+     */
+    double latestTime() const;
+
+    /**
+     * @brief Get the time span kept
+     * @return Window length in seconds
+     */
+    double windowSeconds() const { return static_cast<double>(capacity_) * bucketSeconds_; }
+
+    /**
+     * @brief Render one series for a QLineSeries::replace()
+     * @param series Series to render
+     * @param maxPoints Upper bound on the points, e.g. the chart's width in pixels
+     * @param points Receives the points; its capacity is reused between calls
+     */
+    void render(ChartSeries series, int maxPoints, QVector<QPointF>& points) const;
+
+private:
+    struct Bucket {
+        int64_t index = -1;  // Absolute bucket number, -1 if unused
+        std::array<ValueRange, kChartSeriesCount> ranges;
+    };
+
+    double bucketSeconds_;
+    size_t capacity_;
+    std::vector<Bucket> ring_;
+    int64_t oldest_ = 0;   // First bucket number in the window
+    int64_t newest_ = -1;  // Last bucket number written, -1 if empty
+
+    // Bucket numbers with decreasing maxima; the front is the maximum of the window
+    std::deque<std::pair<int64_t, double>> maxima_;
+};
+
+} // namespace ui
+} // namespace trade_simulator
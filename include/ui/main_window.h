@@ -8,6 +8,7 @@
 #include <QDoubleSpinBox>
 #include <QPushButton>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
@@ -15,9 +16,12 @@
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
+#include <array>
 #include <memory>
 
 #include "models/simulator.h"
+#include "ui/chart_history.h"
+#include "ui/output_mailbox.h"
 
 namespace trade_simulator {
 namespace ui {
@@ -37,15 +41,25 @@ class MainWindow : public QMainWindow {
 public:
     /**
      * @brief Constructor
+     * @param config Simulator configuration, e.g. to replay a recorded feed
+     * @param framesPerSecond Most frames drawn per second, however fast outputs arrive
      * @param parent Parent widget
      */
-    explicit MainWindow(QWidget *parent = nullptr);
+    explicit MainWindow(const models::SimulatorConfig& config = models::SimulatorConfig(),
+                        int framesPerSecond = 30, QWidget *parent = nullptr);
 
     /**
      * @brief Destructor
      */
     ~MainWindow();
 
+    /**
+     * @brief Write the per-stage latency histograms as CSV
+     * @param path Output file
+     * @return True if the file was written
+     */
+    bool exportLatency(const QString& path) const;
+
 private slots:
     /**
      * @brief Start or stop the simulator
@@ -58,15 +72,26 @@ private slots:
     void onParametersChanged();
 
     /**
-     * @brief Update UI with simulator output
-     * @param output Latest simulator output
+     * @brief Draw a frame now, or schedule one if the last frame was too recent
+     *
+     * Queued by the first output posted to the mailbox after a frame.
      */
-    void updateOutput(const models::SimulatorOutput& output);
+    void onOutputReady();
 
     /**
-     * @brief Update the chart with new data
+     * @brief Take the coalesced outputs from the mailbox and draw them
      */
-    void updateChart();
+    void renderFrame();
+
+    /**
+     * @brief Show the end-to-end latency percentiles
+     */
+    void updateLatencyLabel();
+
+    /**
+     * @brief Ask for a file and export the latency histograms to it
+     */
+    void onExportLatencyClicked();
 
 private:
     // UI components
@@ -89,7 +114,11 @@ private:
     QLabel *marketImpactLabel;
     QLabel *netCostLabel;
     QLabel *makerTakerLabel;
+    QLabel *fillProbabilityLabel;
     QLabel *latencyLabel;
+    QLabel *valueAtRiskLabel;
+    QLabel *expectedShortfallLabel;
+    QPushButton *exportLatencyButton;
 
     // Chart components
     QChart *chart;
@@ -100,8 +129,18 @@ private:
     QLineSeries *totalCostSeries;
     QValueAxis *axisX;
     QValueAxis *axisY;
-    int dataPointCounter;
-    static constexpr int kMaxDataPoints = 100;
+    std::array<QLineSeries*, kChartSeriesCount> chartSeries;
+    std::array<QVector<QPointF>, kChartSeriesCount> chartPoints;
+    ChartHistory chartHistory;
+    static constexpr double kChartWindowSeconds = 600.0;
+    static constexpr double kChartBucketSeconds = 0.1;
+
+    // Frames: outputs are coalesced in the mailbox and drawn at most framesPerSecond times
+    OutputMailbox mailbox;
+    QTimer frameTimer;
+    QElapsedTimer lastFrame;
+    QElapsedTimer chartClock;
+    int frameIntervalMs;
 
     // Simulator
     std::shared_ptr<models::Simulator> simulator;
@@ -139,6 +178,36 @@ private:
      */
     QString formatCurrency(double value) const;
 
+    /**
+     * @brief Update the result labels
+     * @param output Latest simulator output
+     * @param costsChanged False to only record the latency, the labels showing its costs already
+     */
+    void updateOutput(const models::SimulatorOutput& output, bool costsChanged = true);
+
+    /**
+     * @brief Record the dispatch and end-to-end latency of an output drawn by this frame
+     * @param output Latest simulator output
+     */
+    void recordUiLatency(const models::SimulatorOutput& output);
+
+    /**
+     * @brief Show the tail of the simulated execution cost distribution
+     */
+    void updateExecutionRisk();
+
+    /**
+     * @brief Redraw the chart from the history
+     */
+    void updateChart();
+
+    /**
+     * @brief Format a latency with a fitting unit
+     * @param nanoseconds Latency in nanoseconds
+     * @return Formatted string
+     */
+    QString formatLatency(uint64_t nanoseconds) const;
+
     /**
      * @brief Format a number as percentage
      * @param value Value to format (0.1 = 10%)
@@ -148,4 +217,4 @@ private:
 };
 
 } // namespace ui
-} // namespace trade_simulator 
\ No newline at end of file
+} // namespace trade_simulator
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+#include "models/simulator.h"
+
+namespace trade_simulator {
+namespace ui {
+
+/**
+ * @brief Cost series plotted by the main window
+ */
+enum class ChartSeries : size_t {
+    Slippage,
+    MarketImpact,
+    Fees,
+    TotalCost,
+    Count
+};
+
+constexpr size_t kChartSeriesCount = static_cast<size_t>(ChartSeries::Count);
+
+/**
+ * @brief Get the plotted values of an output
+ * @param output Simulator output
+ * @return Values indexed by ChartSeries
+ */
+inline std::array<double, kChartSeriesCount> chartValues(const models::SimulatorOutput& output) {
+    return {output.expectedSlippage, output.expectedMarketImpact, output.expectedFees, output.netCost};
+}
+
+/**
+ * @brief Minimum and maximum of a set of values
+ */
+struct ValueRange {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    bool empty() const { return min > max; }
+
+    void add(double value) {
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+
+    void merge(const ValueRange& other) {
+        min = other.min < min ? other.min : min;
+        max = other.max > max ? other.max : max;
+    }
+};
+
+/**
+ * @brief Outputs coalesced between two UI frames
+ */
+struct OutputFrame {
+    models::SimulatorOutput latest;                    // Newest output
+    uint64_t updates = 0;                              // Outputs coalesced into the frame
+    uint64_t changedUpdates = 0;                       // Those whose costs changed
+    std::array<ValueRange, kChartSeriesCount> ranges;  // Range of each series over them
+};
+
+/**
+ * @brief Coalesces simulator outputs from the processing thread until the UI takes them
+ *
+ * The processing thread posts every output; the UI thread takes everything posted since
+ * its last frame at once, as the latest output plus the range of each chart series. Only
+ * the first post after a take asks for a wake-up, so at most one queued event per frame
+ * reaches the UI thread however fast outputs arrive. Both sides hold the lock only to copy
+ * one frame.
+ */
+class OutputMailbox {
+public:
+    /**
+     * @brief Add an output to the pending frame (processing thread)
+     * @param output Simulator output
+     * @return True if the frame was empty, i.e. the UI thread needs a wake-up
+     */
+    bool post(const models::SimulatorOutput& output) {
+        std::array<double, kChartSeriesCount> values = chartValues(output);
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.latest = output;
+        pending_.changedUpdates += output.costsChanged ? 1 : 0;
+        for (size_t i = 0; i < kChartSeriesCount; ++i) {
+            pending_.ranges[i].add(values[i]);
+        }
+        return pending_.updates++ == 0;
+    }
+
+    /**
+     * @brief Take the pending frame and start a new one (UI thread)
+     * @param frame Receives the outputs posted since the last take
+     * @return False if nothing was posted since
+     */
+    bool take(OutputFrame& frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.updates == 0) {
+            return false;
+        }
+        frame = pending_;
+        pending_ = OutputFrame();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    OutputFrame pending_;
+};
+
+} // namespace ui
+} // namespace trade_simulator
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief Header at the start of a broadcast ring's memory
+ *
+ * The layout is fixed so that a ring in shared memory can be read by other processes
+ * built from the same record definition.
+ */
+struct BroadcastRingHeader {
+    static constexpr uint64_t kMagic = 0x474f515242524e47ull;  // "GNRBRQOG"
+
+    std::atomic<uint64_t> magic;      // Stored last by the writer once the ring is ready
+    uint32_t layoutVersion;           // Version of the record layout
+    uint32_t recordSize;              // sizeof the record type
+    uint64_t capacity;                // Slots, a power of two
+    std::atomic<uint64_t> closed;     // Set when the writer goes away
+    alignas(64) std::atomic<uint64_t> published;  // Records written so far
+};
+
+namespace detail {
+
+/**
+ * @brief One slot of a broadcast ring: a per-slot sequence lock around the record's words
+ */
+template <typename T>
+struct BroadcastSlot {
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence;  // 2n + 2 once record n is complete
+    std::array<std::atomic<uint64_t>, kWords> words;
+};
+
+inline size_t nextPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+} // namespace detail
+
+/**
+ * @brief Writer of a single-producer, many-reader broadcast ring in caller-provided memory
+ *
+ * Record n goes to slot n mod capacity under that slot's sequence lock, so the writer
+ * never waits for readers and readers never write: a reader that falls a full lap behind
+ * just loses the overwritten records. Each publish is a handful of relaxed stores and two
+ * release stores, with no system call.
+ *
+ * @tparam T Trivially copyable record type
+ */
+template <typename T>
+class BroadcastRingWriter {
+    static_assert(std::is_trivially_copyable<T>::value, "Broadcast records must be trivially copyable");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared rings need lock-free 64-bit atomics");
+
+public:
+    using Slot = detail::BroadcastSlot<T>;
+
+    /**
+     * @brief Bytes of memory needed for a ring
+     * @param capacity Requested number of slots; rounded up to a power of two
+     * @return Size of the header and slots
+     */
+    static size_t bytesFor(size_t capacity) {
+        return sizeof(BroadcastRingHeader) + detail::nextPowerOfTwo(capacity) * sizeof(Slot);
+    }
+
+    /**
+     * @brief Initialize a ring in zero-filled memory
+     * @param memory At least bytesFor(capacity) bytes, 64-byte aligned
+     * @param capacity Requested number of slots; rounded up to a power of two
+     * @param layoutVersion Version of the record layout, checked by readers
+     */
+    BroadcastRingWriter(void* memory, size_t capacity, uint32_t layoutVersion)
+        : capacity_(detail::nextPowerOfTwo(capacity)), mask_(capacity_ - 1) {
+        header_ = new (memory) BroadcastRingHeader;
+        header_->layoutVersion = layoutVersion;
+        header_->recordSize = static_cast<uint32_t>(sizeof(T));
+        header_->capacity = capacity_;
+        header_->closed.store(0, std::memory_order_relaxed);
+        header_->published.store(0, std::memory_order_relaxed);
+
+        slots_ = reinterpret_cast<Slot*>(static_cast<char*>(memory) + sizeof(BroadcastRingHeader));
+        for (size_t i = 0; i < capacity_; ++i) {
+            Slot* slot = new (&slots_[i]) Slot;
+            slot->sequence.store(0, std::memory_order_relaxed);
+            for (auto& word : slot->words) {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+        header_->magic.store(BroadcastRingHeader::kMagic, std::memory_order_release);
+    }
+
+    /**
+     * @brief Destructor; tells readers that no more records will come
+     */
+    ~BroadcastRingWriter() {
+        header_->closed.store(1, std::memory_order_release);
+    }
+
+    BroadcastRingWriter(const BroadcastRingWriter&) = delete;
+    BroadcastRingWriter& operator=(const BroadcastRingWriter&) = delete;
+
+    /**
+     * @brief Append a record; only one thread may publish at a time
+     * @param record Record to broadcast
+     */
+    void publish(const T& record) {
+        std::array<uint64_t, Slot::kWords> copy{};
+        std::memcpy(copy.data(), &record, sizeof(T));
+
+        Slot& slot = slots_[next_ & mask_];
+        slot.sequence.store(2 * next_ + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < Slot::kWords; ++i) {
+            slot.words[i].store(copy[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(2 * next_ + 2, std::memory_order_release);
+        header_->published.store(++next_, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the number of records published
+     * @return Records written since the ring was initialized
+     */
+    uint64_t published() const { return next_; }
+
+    /**
+     * @brief Get the number of slots
+     * @return Capacity, a power of two
+     */
+    size_t capacity() const { return capacity_; }
+
+private:
+    BroadcastRingHeader* header_;
+    Slot* slots_;
+    size_t capacity_;
+    size_t mask_;
+    uint64_t next_ = 0;
+};
+
+/**
+ * @brief Reader of a broadcast ring; any number of readers may read the same ring
+ *
+ * Only loads from the ring's memory, so it works on a read-only mapping. A reader that
+ * lags by more than the capacity skips ahead to the newest record and counts what it
+ * missed.
+ *
+ * @tparam T Record type of the writer
+ */
+template <typename T>
+class BroadcastRingReader {
+public:
+    using Slot = detail::BroadcastSlot<T>;
+
+    /**
+     * @brief Attach to an initialized ring; the first next() returns the next new record
+     * @param memory Ring memory
+     * @param size Size of the memory in bytes
+     * @param layoutVersion Record layout version the reader was built with
+     * @throws std::runtime_error if the memory does not hold a ring of this record layout
+     */
+    BroadcastRingReader(const void* memory, size_t size, uint32_t layoutVersion) {
+        if (size < sizeof(BroadcastRingHeader)) {
+            throw std::runtime_error("Broadcast ring too small");
+        }
+        header_ = static_cast<const BroadcastRingHeader*>(memory);
+        if (header_->magic.load(std::memory_order_acquire) != BroadcastRingHeader::kMagic) {
+            throw std::runtime_error("Not an initialized broadcast ring");
+        }
+        if (header_->layoutVersion != layoutVersion || header_->recordSize != sizeof(T)) {
+            throw std::runtime_error("Broadcast ring has a different record layout");
+        }
+        capacity_ = static_cast<size_t>(header_->capacity);
+        if (capacity_ == 0 || (capacity_ & (capacity_ - 1)) != 0 ||
+            size < sizeof(BroadcastRingHeader) + capacity_ * sizeof(Slot)) {
+            throw std::runtime_error("Broadcast ring truncated");
+        }
+        mask_ = capacity_ - 1;
+        slots_ = reinterpret_cast<const Slot*>(static_cast<const char*>(memory) + sizeof(BroadcastRingHeader));
+        next_ = header_->published.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Read the next unread record
+     * @param record Receives the record
+     * @return False if no new record has been published
+     */
+    bool next(T& record) {
+        uint64_t published = header_->published.load(std::memory_order_acquire);
+        while (next_ < published) {
+            if (published - next_ > capacity_) {
+                skipTo(published - 1);
+            }
+            if (readSlot(next_, record)) {
+                ++next_;
+                return true;
+            }
+            // Overwritten while reading: the writer lapped us, so catch up to the newest
+            published = header_->published.load(std::memory_order_acquire);
+            skipTo(published - 1);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Read the newest record without moving the read position
+     * @param record Receives the record
+     * @return False if nothing has been published yet
+     */
+    bool latest(T& record) const {
+        while (true) {
+            uint64_t published = header_->published.load(std::memory_order_acquire);
+            if (published == 0) {
+                return false;
+            }
+            if (readSlot(published - 1, record)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of records skipped because the reader lagged
+     * @return Records lost to being lapped
+     */
+    uint64_t missed() const { return missed_; }
+
+    /**
+     * @brief Check if the writer has gone away
+     * @return True once the writer was destroyed; remaining records can still be read
+     */
+    bool isClosed() const {
+        return header_->closed.load(std::memory_order_acquire) != 0;
+    }
+
+private:
+    const BroadcastRingHeader* header_;
+    const Slot* slots_;
+    size_t capacity_;
+    size_t mask_;
+    uint64_t next_ = 0;
+    uint64_t missed_ = 0;
+
+    void skipTo(uint64_t index) {
+        if (index > next_) {
+            missed_ += index - next_;
+            next_ = index;
+        }
+    }
+
+    bool readSlot(uint64_t index, T& record) const {
+        const Slot& slot = slots_[index & mask_];
+        std::array<uint64_t, Slot::kWords> copy;
+
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != 2 * index + 2) {
+            return false;
+        }
+        for (size_t i = 0; i < Slot::kWords; ++i) {
+            copy[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+
+        std::memcpy(static_cast<void*>(&record), copy.data(), sizeof(T));
+        return true;
+    }
+};
+
+} // namespace utils
+} // namespace trade_simulator
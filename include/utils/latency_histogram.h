@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief Current steady_clock time in nanoseconds, the timebase of all latency stamps
+ * @return Nanoseconds since the steady_clock epoch
+ */
+inline int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Percentiles of a latency histogram at one point in time
+ */
+struct LatencySnapshot {
+    uint64_t count = 0;
+    double mean = 0.0;   // All values in nanoseconds
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+/**
+ * @brief Lock-free log-linear histogram of nanosecond latencies
+ *
+ * HDR-style bucketing: values below 64 ns are exact, above that every power of two is
+ * split into 32 buckets, so a reported percentile is within about 3% of the true value.
+ * Values up to about 2^42 ns (73 minutes) have their own bucket; longer ones land in the
+ * last. Recording is one relaxed atomic increment plus a compare-and-swap when the
+ * maximum grows, so any number of threads can record concurrently without waiting. The
+ * buckets take under 10 KiB and are allocated with the histogram.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() {
+        reset();
+    }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one latency
+     * @param nanoseconds Latency; negative values (clock misuse) are recorded as 0
+     */
+    void record(int64_t nanoseconds) {
+        uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Record the time between two stamps of nowNanoseconds()
+     * @param startNs Earlier stamp; 0 means the stage was not stamped and is skipped
+     * @param endNs Later stamp
+     */
+    void recordInterval(int64_t startNs, int64_t endNs) {
+        if (startNs != 0) {
+            record(endNs - startNs);
+        }
+    }
+
+    /**
+     * @brief Compute the percentiles of everything recorded so far
+     *
+     * Safe while other threads record; values recorded meanwhile may be partly included.
+     *
+     * @return Count, mean, p50, p99, p99.9 and maximum
+     */
+    LatencySnapshot snapshot() const {
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        LatencySnapshot snapshot;
+        snapshot.count = total;
+        snapshot.max = max_.load(std::memory_order_relaxed);
+        if (total == 0) {
+            return snapshot;
+        }
+        snapshot.mean = static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                        static_cast<double>(count_.load(std::memory_order_relaxed));
+
+        // Smallest bucket whose cumulative count reaches each rank
+        const double quantiles[3] = {0.5, 0.99, 0.999};
+        uint64_t* outputs[3] = {&snapshot.p50, &snapshot.p99, &snapshot.p999};
+        size_t next = 0;
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < kBucketCount && next < 3; ++i) {
+            cumulative += counts[i];
+            while (next < 3 && static_cast<double>(cumulative) >= quantiles[next] * static_cast<double>(total)) {
+                *outputs[next] = std::min(bucketUpperBound(i), snapshot.max);
+                ++next;
+            }
+        }
+        return snapshot;
+    }
+
+    /**
+     * @brief Forget everything recorded; not atomic with respect to concurrent records
+     */
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+    static constexpr unsigned kMaxExponent = 42;
+    static constexpr size_t kBucketCount = kSubBuckets + (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        uint64_t mantissa = (value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+        return static_cast<size_t>(kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets + mantissa);
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        unsigned exponent = static_cast<unsigned>((index - kSubBuckets) / kSubBuckets) + kSubBucketBits;
+        uint64_t mantissa = (index - kSubBuckets) % kSubBuckets;
+        unsigned shift = exponent - kSubBucketBits;
+        uint64_t lower = (uint64_t{1} << exponent) | (mantissa << shift);
+        return lower + (uint64_t{1} << shift) - 1;
+    }
+};
+
+/**
+ * @brief Stages of the pipeline from the socket to the UI
+ */
+enum class LatencyStage : size_t {
+    SocketRead,   // Read completion to the start of parsing, including recording
+    Parse,        // JSON message to OrderbookData
+    Enqueue,      // Hand-off to the dispatcher and copy into the queue slot
+    Queue,        // Waiting in the queue for the processing thread
+    Stats,        // Applying the update to the book and computing statistics
+    Models,       // Cost models, calibration and cost curves
+    UiDispatch,   // Simulator output to the UI thread handling it
+    EndToEnd,     // Read completion to the UI thread handling the output
+    Reconnect,    // Feed connection lost to the first book read after reconnecting or failing over
+    ExchangeLag,  // Exchange timestamp to read completion, across clocks; live feeds only
+    Routing,      // Consolidating the venues' books and splitting the routed order
+    Count
+};
+
+/**
+ * @brief Get the display name of a stage
+ * @param stage Pipeline stage
+ * @return Lower-case name, e.g. "socket_read"
+ */
+inline const char* latencyStageName(LatencyStage stage) {
+    static constexpr const char* kNames[] = {
+        "socket_read", "parse", "enqueue", "queue", "stats", "models", "ui_dispatch", "end_to_end",
+        "reconnect", "exchange_lag", "routing"};
+    return kNames[static_cast<size_t>(stage)];
+}
+
+/**
+ * @brief One latency histogram per pipeline stage
+ */
+class PipelineLatency {
+public:
+    static constexpr size_t kStageCount = static_cast<size_t>(LatencyStage::Count);
+
+    /**
+     * @brief Get the histogram of a stage
+     * @param stage Pipeline stage
+     * @return Histogram to record into
+     */
+    LatencyHistogram& stage(LatencyStage stage) {
+        return stages_[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Get the histogram of a stage
+     * @param stage Pipeline stage
+     * @return Histogram to read
+     */
+    const LatencyHistogram& stage(LatencyStage stage) const {
+        return stages_[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Write the percentiles of every stage as CSV with a header row
+     * @param out Output stream; latencies are in nanoseconds
+     */
+    void writeCsv(std::ostream& out) const {
+        out << "stage,count,mean_ns,p50_ns,p99_ns,p999_ns,max_ns\n";
+        for (size_t i = 0; i < kStageCount; ++i) {
+            LatencySnapshot s = stages_[i].snapshot();
+            out << latencyStageName(static_cast<LatencyStage>(i)) << ',' << s.count << ','
+                << static_cast<uint64_t>(s.mean) << ',' << s.p50 << ',' << s.p99 << ','
+                << s.p999 << ',' << s.max << '\n';
+        }
+    }
+
+    /**
+     * @brief Forget everything recorded in all stages
+     */
+    void reset() {
+        for (auto& stage : stages_) {
+            stage.reset();
+        }
+    }
+
+private:
+    std::array<LatencyHistogram, kStageCount> stages_;
+};
+
+} // namespace utils
+} // namespace trade_simulator
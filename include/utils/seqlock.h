@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief Single-writer sequence lock publishing a small trivially copyable value
+ *
+ * The writer bumps the sequence to odd, stores the value and bumps it back to even;
+ * readers copy the value and retry if the sequence was odd or changed meanwhile. Readers
+ * never block the writer or each other, and the writer never waits. The value is kept in
+ * relaxed atomic words, so concurrent reads of a torn copy are well-defined and simply
+ * discarded.
+ *
+ * @tparam T Trivially copyable value type
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    /**
+     * @brief Constructor
+     * @param value Initial value
+     */
+    explicit SeqLock(const T& value = T()) {
+        writeWords(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value; only one thread may store at a time
+     * @param value Value to publish
+     */
+    void store(const T& value) {
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        writeWords(value);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read a consistent copy of the latest value
+     * @return The value of the last completed store
+     */
+    T load() const {
+        std::array<uint64_t, kWords> copy;
+        uint64_t before;
+        uint64_t after;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < kWords; ++i) {
+                copy[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), copy.data(), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Get the number of completed stores
+     * @return Version of the current value, 0 for the initial one
+     */
+    uint64_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, kWords> words_;
+
+    void writeWords(const T& value) {
+        std::array<uint64_t, kWords> copy{};
+        std::memcpy(copy.data(), &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(copy[i], std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace utils
+} // namespace trade_simulator
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief A mapped POSIX shared-memory object
+ *
+ * The creator maps the object read-write and unlinks it when destroyed; processes that
+ * open it map it read-only, so they can never write into the creator's memory. Readers
+ * that still have it mapped keep their mapping after the unlink.
+ */
+class SharedMemoryRegion {
+public:
+    /**
+     * @brief Create a zero-filled object, replacing any stale one of the same name
+     * @param name Object name, e.g. "/trade_simulator"
+     * @param size Size in bytes
+     * @return Read-write region
+     * @throws std::runtime_error if the object cannot be created or mapped
+     */
+    static SharedMemoryRegion create(const std::string& name, size_t size);
+
+    /**
+     * @brief Map an existing object read-only
+     * @param name Object name
+     * @return Read-only region spanning the whole object
+     * @throws std::runtime_error if the object does not exist or cannot be mapped
+     */
+    static SharedMemoryRegion open(const std::string& name);
+
+    SharedMemoryRegion(SharedMemoryRegion&& other) noexcept;
+    SharedMemoryRegion& operator=(SharedMemoryRegion&& other) noexcept;
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    /**
+     * @brief Destructor; unmaps, and unlinks the object if this process created it
+     */
+    ~SharedMemoryRegion();
+
+    void* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& name() const { return name_; }
+
+private:
+    SharedMemoryRegion(std::string name, void* data, size_t size, bool owner)
+        : name_(std::move(name)), data_(data), size_(size), owner_(owner) {}
+
+    void release();
+
+    std::string name_;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    bool owner_ = false;
+};
+
+} // namespace utils
+} // namespace trade_simulator
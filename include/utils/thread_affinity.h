@@ -0,0 +1,46 @@
+#pragma once
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief Placement and idle behaviour of a pipeline thread
+ */
+struct ThreadConfig {
+    int cpu = -1;           // Pin the thread to this CPU; -1 leaves it to the scheduler
+    bool busyPoll = false;  // Spin on the CPU while idle instead of sleeping in the kernel
+
+    // Default constructor
+    ThreadConfig() = default;
+};
+
+/**
+ * @brief Pin the calling thread to one CPU
+ * @param cpu CPU index; negative values leave the thread unpinned
+ * @return True if the thread is now pinned, false if unpinned or unsupported here
+ */
+bool pinCurrentThread(int cpu);
+
+/**
+ * @brief Apply the placement of a thread config to the calling thread
+ *
+ * Reports a failed pin on stderr and carries on unpinned.
+ *
+ * @param config Thread configuration
+ * @param threadName Name for the error message, e.g. "network"
+ */
+void applyThreadConfig(const ThreadConfig& config, const char* threadName);
+
+/**
+ * @brief Hint the CPU that the caller is spinning
+ */
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace utils
+} // namespace trade_simulator
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief Current wall-clock time, the timebase of exchange timestamps
+ * @return Nanoseconds since the Unix epoch
+ */
+inline int64_t wallClockNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Parse an exchange timestamp into Unix time
+ *
+ * Accepts the two forms venues send: ISO 8601 UTC such as "2025-05-04T10:39:13Z" or
+ * "2025-05-04T10:39:13.123456+00:00" (fractions to nanoseconds, numeric offsets applied,
+ * no offset taken as UTC),
+ * and integer epoch times, whose unit is taken from the number of digits: seconds up to
+ * 10 digits, then milliseconds, microseconds and nanoseconds. Nothing is allocated.
+ *
+ * @param text Timestamp as sent
+ * @return Nanoseconds since the Unix epoch, or 0 if the text is not a timestamp
+ */
+int64_t parseTimestampNs(std::string_view text);
+
+} // namespace utils
+} // namespace trade_simulator
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trade_simulator {
+namespace utils {
+
+/**
+ * @brief Fixed pool of worker threads running indexed tasks with work stealing
+ *
+ * parallelFor() deals the task indices out to per-worker deques; a worker pops tasks from
+ * the back of its own deque and, once it runs dry, steals from the front of the others,
+ * so uneven tasks still keep every core busy. Each deque has its own lock, which is only
+ * contended while stealing.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @brief Task body: task index and index of the worker running it
+     */
+    using TaskBody = std::function<void(size_t task, size_t worker)>;
+
+    /**
+     * @brief Constructor
+     * @param threads Number of workers; 0 uses one per hardware thread
+     */
+    explicit WorkStealingPool(size_t threads = 0);
+
+    /**
+     * @brief Destructor; waits for the workers to exit
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Get the number of workers
+     * @return Worker count; worker indices passed to tasks are below it
+     */
+    size_t threadCount() const { return workers_.size(); }
+
+    /**
+     * @brief Run tasks 0..taskCount-1 on the workers and wait for all of them
+     *
+     * Calls must not overlap. An exception thrown by a task is rethrown here once all
+     * tasks have finished.
+     *
+     * @param taskCount Number of tasks
+     * @param body Task body
+     */
+    void parallelFor(size_t taskCount, const TaskBody& body);
+
+private:
+    struct alignas(64) Worker {
+        std::deque<size_t> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    // Current job
+    const TaskBody* body_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t activeWorkers_ = 0;
+    bool shutdown_ = false;
+    std::exception_ptr error_;
+    std::mutex jobMutex_;
+    std::condition_variable jobStarted_;
+    std::condition_variable jobFinished_;
+
+    void runWorker(size_t index);
+    bool popOwn(size_t index, size_t& task);
+    bool steal(size_t thief, size_t& task);
+};
+
+} // namespace utils
+} // namespace trade_simulator 
@@ -0,0 +1,220 @@
+#include "data/book_kernels.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TRADE_SIMULATOR_HAVE_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define TRADE_SIMULATOR_HAVE_NEON_KERNELS 1
+#include <arm_neon.h>
+#endif
+
+namespace trade_simulator {
+namespace data {
+namespace kernels {
+
+namespace {
+
+/**
+ * @brief Band limits as price distances from the best price
+ *
+ * A level is inside band k when (price - best) * direction <= limits[k], with direction
+ * +1 for asks and -1 for bids.
+ */
+struct BandLimits {
+    double best;
+    double direction;
+    std::array<double, kDepthBandCount> limits;
+
+    BandLimits(double bestPrice, bool isAsk)
+        : best(bestPrice), direction(isAsk ? 1.0 : -1.0) {
+        for (size_t k = 0; k < kDepthBandCount; ++k) {
+            limits[k] = bestPrice * kDepthBandsBps[k] / 10000.0;
+        }
+    }
+};
+
+/**
+ * @brief Scalar accumulation of levels [begin, end) into a summary
+ */
+void accumulateScalar(const double* prices, const double* sizes, size_t begin, size_t end,
+                      const BandLimits& bands, SideSummary& summary) {
+    for (size_t i = begin; i < end; ++i) {
+        double size = sizes[i];
+        summary.totalSize += size;
+        summary.totalNotional += prices[i] * size;
+
+        double distance = (prices[i] - bands.best) * bands.direction;
+        for (size_t k = 0; k < kDepthBandCount; ++k) {
+            summary.bandSize[k] += distance <= bands.limits[k] ? size : 0.0;
+        }
+    }
+}
+
+#if TRADE_SIMULATOR_HAVE_AVX2_KERNELS
+
+__attribute__((target("avx2,fma")))
+double horizontalSum(__m256d v) {
+    __m128d low = _mm256_castpd256_pd128(v);
+    __m128d high = _mm256_extractf128_pd(v, 1);
+    low = _mm_add_pd(low, high);
+    return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+/**
+ * @brief AVX2 accumulation of levels [begin, end), four levels per step
+ */
+__attribute__((target("avx2,fma")))
+void accumulateAvx2(const double* prices, const double* sizes, size_t begin, size_t end,
+                    const BandLimits& bands, SideSummary& summary) {
+    const __m256d best = _mm256_set1_pd(bands.best);
+    const __m256d direction = _mm256_set1_pd(bands.direction);
+    __m256d limits[kDepthBandCount];
+    __m256d bandAcc[kDepthBandCount];
+    for (size_t k = 0; k < kDepthBandCount; ++k) {
+        limits[k] = _mm256_set1_pd(bands.limits[k]);
+        bandAcc[k] = _mm256_setzero_pd();
+    }
+    __m256d sizeAcc = _mm256_setzero_pd();
+    __m256d notionalAcc = _mm256_setzero_pd();
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d price = _mm256_loadu_pd(prices + i);
+        __m256d size = _mm256_loadu_pd(sizes + i);
+        sizeAcc = _mm256_add_pd(sizeAcc, size);
+        notionalAcc = _mm256_fmadd_pd(price, size, notionalAcc);
+
+        __m256d distance = _mm256_mul_pd(_mm256_sub_pd(price, best), direction);
+        for (size_t k = 0; k < kDepthBandCount; ++k) {
+            __m256d inside = _mm256_cmp_pd(distance, limits[k], _CMP_LE_OQ);
+            bandAcc[k] = _mm256_add_pd(bandAcc[k], _mm256_and_pd(inside, size));
+        }
+    }
+
+    summary.totalSize += horizontalSum(sizeAcc);
+    summary.totalNotional += horizontalSum(notionalAcc);
+    for (size_t k = 0; k < kDepthBandCount; ++k) {
+        summary.bandSize[k] += horizontalSum(bandAcc[k]);
+    }
+
+    accumulateScalar(prices, sizes, i, end, bands, summary);
+}
+
+#endif
+
+#if TRADE_SIMULATOR_HAVE_NEON_KERNELS
+
+/**
+ * @brief NEON accumulation of levels [begin, end), two levels per step
+ */
+void accumulateNeon(const double* prices, const double* sizes, size_t begin, size_t end,
+                    const BandLimits& bands, SideSummary& summary) {
+    const float64x2_t best = vdupq_n_f64(bands.best);
+    const float64x2_t direction = vdupq_n_f64(bands.direction);
+    float64x2_t limits[kDepthBandCount];
+    float64x2_t bandAcc[kDepthBandCount];
+    for (size_t k = 0; k < kDepthBandCount; ++k) {
+        limits[k] = vdupq_n_f64(bands.limits[k]);
+        bandAcc[k] = vdupq_n_f64(0.0);
+    }
+    float64x2_t sizeAcc = vdupq_n_f64(0.0);
+    float64x2_t notionalAcc = vdupq_n_f64(0.0);
+
+    size_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        float64x2_t price = vld1q_f64(prices + i);
+        float64x2_t size = vld1q_f64(sizes + i);
+        sizeAcc = vaddq_f64(sizeAcc, size);
+        notionalAcc = vfmaq_f64(notionalAcc, price, size);
+
+        float64x2_t distance = vmulq_f64(vsubq_f64(price, best), direction);
+        for (size_t k = 0; k < kDepthBandCount; ++k) {
+            uint64x2_t inside = vcleq_f64(distance, limits[k]);
+            float64x2_t masked = vreinterpretq_f64_u64(
+                vandq_u64(inside, vreinterpretq_u64_f64(size)));
+            bandAcc[k] = vaddq_f64(bandAcc[k], masked);
+        }
+    }
+
+    summary.totalSize += vaddvq_f64(sizeAcc);
+    summary.totalNotional += vaddvq_f64(notionalAcc);
+    for (size_t k = 0; k < kDepthBandCount; ++k) {
+        summary.bandSize[k] += vaddvq_f64(bandAcc[k]);
+    }
+
+    accumulateScalar(prices, sizes, i, end, bands, summary);
+}
+
+#endif
+
+using AccumulateFn = void (*)(const double*, const double*, size_t, size_t,
+                              const BandLimits&, SideSummary&);
+
+/**
+ * @brief One pass split at the top-N boundary, snapshotting the running totals there
+ */
+SideSummary summarize(AccumulateFn accumulate, const double* prices, const double* sizes,
+                      size_t count, size_t topLevels, bool isAsk) {
+    SideSummary summary;
+    if (count == 0) {
+        return summary;
+    }
+
+    BandLimits bands(prices[0], isAsk);
+    size_t topEnd = std::min(topLevels, count);
+
+    accumulate(prices, sizes, 0, topEnd, bands, summary);
+    summary.topSize = summary.totalSize;
+    summary.topNotional = summary.totalNotional;
+    accumulate(prices, sizes, topEnd, count, bands, summary);
+
+    return summary;
+}
+
+struct Dispatch {
+    AccumulateFn accumulate;
+    const char* name;
+};
+
+Dispatch selectImplementation() {
+#if TRADE_SIMULATOR_HAVE_AVX2_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {accumulateAvx2, "avx2"};
+    }
+#endif
+#if TRADE_SIMULATOR_HAVE_NEON_KERNELS
+    return {accumulateNeon, "neon"};
+#else
+    return {accumulateScalar, "scalar"};
+#endif
+}
+
+const Dispatch& implementation() {
+    static const Dispatch dispatch = selectImplementation();
+    return dispatch;
+}
+
+} // namespace
+
+SideSummary summarizeSide(const double* prices, const double* sizes, size_t count,
+                          size_t topLevels, bool isAsk) {
+    return summarize(implementation().accumulate, prices, sizes, count, topLevels, isAsk);
+}
+
+SideSummary summarizeSideScalar(const double* prices, const double* sizes, size_t count,
+                                size_t topLevels, bool isAsk) {
+    return summarize(accumulateScalar, prices, sizes, count, topLevels, isAsk);
+}
+
+const char* summarizeSideImplementation() {
+    return implementation().name;
+}
+
+} // namespace kernels
+} // namespace data
+} // namespace trade_simulator 
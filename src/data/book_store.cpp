@@ -0,0 +1,678 @@
+#include "data/book_store.h"
+#include "data/feed_adapter.h"
+#include "data/feed_log_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__BYTE_ORDER__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Book store files are read and written in place as little-endian");
+#endif
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'Q', 'B', 'O', 'O', 'K', '0', '1'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t encoding;
+    double tickSize;
+    double lotSize;
+    uint64_t blockCount;
+    uint64_t bookCount;
+    uint64_t indexOffset;
+    uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == 64, "Unexpected file header layout");
+
+struct BlockHeader {
+    uint32_t bookCount;
+    uint32_t reserved;
+    uint64_t payloadBytes;
+    int64_t firstNs;
+    int64_t lastNs;
+};
+static_assert(sizeof(BlockHeader) == 32, "Unexpected block header layout");
+
+struct IndexRecord {
+    int64_t firstNs;
+    int64_t lastNs;
+    uint64_t offset;
+    uint64_t bookCount;
+};
+static_assert(sizeof(IndexRecord) == 32, "Unexpected index layout");
+
+// Raw encoding: this header, then ask ticks, ask lots, bid ticks and bid lots as int64
+constexpr size_t kRawTimestampBytes = 29;
+struct RawBookHeader {
+    int64_t receivedNs;
+    int64_t seqId;
+    int64_t prevSeqId;
+    int32_t checksum;
+    uint16_t askCount;
+    uint16_t bidCount;
+    uint8_t updateType;
+    uint8_t hasChecksum;
+    uint8_t timestampLength;
+    char timestamp[kRawTimestampBytes];
+};
+static_assert(sizeof(RawBookHeader) == 64, "Unexpected raw book layout");
+
+// Delta encoding flags
+constexpr uint8_t kDeltaUpdateFlag = 1u << 0;
+constexpr uint8_t kChecksumFlag = 1u << 1;
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putSigned(std::vector<uint8_t>& out, int64_t value) {
+    putVarint(out, zigzag(value));
+}
+
+void putBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void padTo8(std::vector<uint8_t>& out) {
+    out.resize((out.size() + 7) & ~size_t(7), 0);
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("Corrupt book store block");
+}
+
+uint64_t getVarint(const uint8_t*& cursor, const uint8_t* end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor == end) {
+            corrupt();
+        }
+        uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    corrupt();
+}
+
+int64_t getSigned(const uint8_t*& cursor, const uint8_t* end) {
+    return unzigzag(getVarint(cursor, end));
+}
+
+std::string_view getString(const uint8_t*& cursor, const uint8_t* end) {
+    uint64_t length = getVarint(cursor, end);
+    if (static_cast<uint64_t>(end - cursor) < length) {
+        corrupt();
+    }
+    std::string_view text(reinterpret_cast<const char*>(cursor), length);
+    cursor += length;
+    return text;
+}
+
+void putString(std::vector<uint8_t>& out, std::string_view text) {
+    putVarint(out, text.size());
+    putBytes(out, text.data(), text.size());
+}
+
+/**
+ * @brief Converts ticks or lots back to a value
+ *
+ * For decimal grids such as 0.1 or 0.01 dividing by the integer inverse reproduces the
+ * value the parser read from the decimal string exactly, where multiplying by the step
+ * would be off by an ulp about half of the time.
+ */
+struct GridScale {
+    double step;
+    double inverse;
+    bool integralInverse;
+
+    explicit GridScale(double gridStep)
+        : step(gridStep),
+          inverse(std::round(1.0 / gridStep)),
+          integralInverse(gridStep < 1.0 && std::abs(1.0 / gridStep - inverse) < 1e-9) {}
+
+    double operator()(int64_t units) const {
+        return integralInverse ? static_cast<double>(units) / inverse
+                               : static_cast<double>(units) * step;
+    }
+};
+
+int64_t nanosOf(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// The store does not record the contract value, so only checksums over base sizes are kept
+bool storesChecksum(const OrderbookData& book) {
+    return book.has_checksum && book.checksum_size_unit == 1.0;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// BookStoreWriter
+
+BookStoreWriter::BookStoreWriter(const std::string& path, const BookStoreConfig& config)
+    : config_(config),
+      file_(std::fopen(path.c_str(), "wb")) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open book store for writing: " + path);
+    }
+    config_.booksPerBlock = std::max<size_t>(1, config_.booksPerBlock);
+
+    // Placeholder header, completed by close()
+    FileHeader header{};
+    write(&header, sizeof(header));
+}
+
+BookStoreWriter::~BookStoreWriter() {
+    try {
+        close();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error closing book store: " << e.what() << std::endl;
+    }
+}
+
+void BookStoreWriter::append(const OrderbookData& book) {
+    if (blockBooks_ > 0 && (blockBooks_ >= config_.booksPerBlock ||
+                            book.exchange != blockExchange_ || book.symbol != blockSymbol_)) {
+        flushBlock();
+    }
+    if (blockBooks_ == 0) {
+        startBlock(book);
+    }
+
+    int64_t receivedNs = nanosOf(book.received_time);
+    if (config_.encoding == BookStoreEncoding::Raw) {
+        appendRaw(book, receivedNs);
+    } else {
+        appendDelta(book, receivedNs);
+    }
+
+    blockLastNs_ = receivedNs;
+    ++blockBooks_;
+    ++bookCount_;
+}
+
+void BookStoreWriter::close() {
+    if (!file_) {
+        return;
+    }
+    flushBlock();
+
+    // Index, then the completed header
+    uint64_t indexOffset = fileOffset_;
+    for (const IndexEntry& entry : index_) {
+        IndexRecord record{entry.firstNs, entry.lastNs, entry.offset, entry.bookCount};
+        write(&record, sizeof(record));
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.encoding = static_cast<uint32_t>(config_.encoding);
+    header.tickSize = config_.spec.tickSize;
+    header.lotSize = config_.spec.lotSize;
+    header.blockCount = index_.size();
+    header.bookCount = bookCount_;
+    header.indexOffset = indexOffset;
+
+    bool ok = std::fseek(file_, 0, SEEK_SET) == 0 &&
+              std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    if (!ok) {
+        throw std::runtime_error("Error writing book store");
+    }
+}
+
+void BookStoreWriter::startBlock(const OrderbookData& book) {
+    block_.clear();
+    blockExchange_ = book.exchange;
+    blockSymbol_ = book.symbol;
+    blockFirstNs_ = nanosOf(book.received_time);
+
+    putString(block_, symbolName(blockExchange_));
+    putString(block_, symbolName(blockSymbol_));
+    padTo8(block_);
+
+    previousNs_ = 0;
+    previousSeqId_ = 0;
+    previousAskTop_ = 0;
+    previousBidTop_ = 0;
+}
+
+void BookStoreWriter::flushBlock() {
+    if (blockBooks_ == 0) {
+        return;
+    }
+    padTo8(block_);
+
+    index_.push_back({blockFirstNs_, blockLastNs_, fileOffset_, blockBooks_});
+
+    BlockHeader header{blockBooks_, 0, block_.size(), blockFirstNs_, blockLastNs_};
+    write(&header, sizeof(header));
+    write(block_.data(), block_.size());
+
+    blockBooks_ = 0;
+    block_.clear();
+}
+
+void BookStoreWriter::appendDelta(const OrderbookData& book, int64_t receivedNs) {
+    convert(book.asks, askTicks_);
+    convert(book.bids, bidTicks_);
+
+    uint8_t flags = 0;
+    if (book.update_type == BookUpdateType::Delta) {
+        flags |= kDeltaUpdateFlag;
+    }
+    if (storesChecksum(book)) {
+        flags |= kChecksumFlag;
+    }
+
+    putSigned(block_, receivedNs - previousNs_);
+    block_.push_back(flags);
+    putSigned(block_, book.seq_id - previousSeqId_);
+    putSigned(block_, book.prev_seq_id - previousSeqId_);
+    if (storesChecksum(book)) {
+        putSigned(block_, book.checksum);
+    }
+    putString(block_, book.timestamp.view());
+    previousNs_ = receivedNs;
+    previousSeqId_ = book.seq_id;
+
+    putVarint(block_, askTicks_.size());
+    putVarint(block_, bidTicks_.size());
+
+    // Asks ascend and bids descend, so consecutive price deltas are small and positive
+    int64_t previous = previousAskTop_;
+    for (size_t i = 0; i < askTicks_.size(); ++i) {
+        putSigned(block_, askTicks_.prices[i] - previous);
+        putSigned(block_, askTicks_.sizes[i]);
+        previous = askTicks_.prices[i];
+    }
+    previous = previousBidTop_;
+    for (size_t i = 0; i < bidTicks_.size(); ++i) {
+        putSigned(block_, previous - bidTicks_.prices[i]);
+        putSigned(block_, bidTicks_.sizes[i]);
+        previous = bidTicks_.prices[i];
+    }
+
+    if (!askTicks_.empty()) {
+        previousAskTop_ = askTicks_.prices[0];
+    }
+    if (!bidTicks_.empty()) {
+        previousBidTop_ = bidTicks_.prices[0];
+    }
+}
+
+void BookStoreWriter::appendRaw(const OrderbookData& book, int64_t receivedNs) {
+    convert(book.asks, askTicks_);
+    convert(book.bids, bidTicks_);
+
+    RawBookHeader header{};
+    header.receivedNs = receivedNs;
+    header.seqId = book.seq_id;
+    header.prevSeqId = book.prev_seq_id;
+    header.checksum = book.checksum;
+    header.askCount = static_cast<uint16_t>(askTicks_.size());
+    header.bidCount = static_cast<uint16_t>(bidTicks_.size());
+    header.updateType = static_cast<uint8_t>(book.update_type);
+    header.hasChecksum = storesChecksum(book) ? 1 : 0;
+    header.timestampLength = static_cast<uint8_t>(std::min(book.timestamp.size(), kRawTimestampBytes));
+    std::memcpy(header.timestamp, book.timestamp.view().data(), header.timestampLength);
+
+    putBytes(block_, &header, sizeof(header));
+    putBytes(block_, askTicks_.prices.data(), askTicks_.size() * sizeof(int64_t));
+    putBytes(block_, askTicks_.sizes.data(), askTicks_.size() * sizeof(int64_t));
+    putBytes(block_, bidTicks_.prices.data(), bidTicks_.size() * sizeof(int64_t));
+    putBytes(block_, bidTicks_.sizes.data(), bidTicks_.size() * sizeof(int64_t));
+}
+
+void BookStoreWriter::convert(const BookSide& side, TickBookSide& out) {
+    toTicks(side, config_.spec, out);
+
+    // Count values the grid cannot represent exactly
+    for (size_t i = 0; i < side.size(); ++i) {
+        double price = static_cast<double>(out.prices[i]) * config_.spec.tickSize;
+        double size = static_cast<double>(out.sizes[i]) * config_.spec.lotSize;
+        if (std::abs(price - side.prices[i]) > 1e-9 * std::abs(side.prices[i])) {
+            ++roundedValues_;
+        }
+        if (std::abs(size - side.sizes[i]) > 1e-9 * std::abs(side.sizes[i])) {
+            ++roundedValues_;
+        }
+    }
+}
+
+void BookStoreWriter::write(const void* data, size_t size) {
+    if (std::fwrite(data, 1, size, file_) != size) {
+        throw std::runtime_error("Error writing book store");
+    }
+    fileOffset_ += size;
+}
+
+// ---------------------------------------------------------------------------------------
+// BookStoreReader
+
+BookStoreReader::BookStoreReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open book store: " + path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a book store: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map book store: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                 header.version == kVersion &&
+                 header.indexOffset <= size_ &&
+                 (size_ - header.indexOffset) / sizeof(IndexRecord) >= header.blockCount;
+    if (!valid) {
+        ::munmap(mapping, size_);
+        throw std::runtime_error("Not a book store or not closed properly: " + path);
+    }
+
+    encoding_ = static_cast<BookStoreEncoding>(header.encoding);
+    spec_ = InstrumentSpec(header.tickSize, header.lotSize);
+    bookCount_ = header.bookCount;
+    blockCount_ = static_cast<size_t>(header.blockCount);
+    index_ = data_ + header.indexOffset;
+    rewind();
+}
+
+BookStoreReader::~BookStoreReader() {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+bool BookStoreReader::isBookStore(const std::string& path) {
+    char magic[sizeof(kMagic)] = {};
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    bool match = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                 std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+    std::fclose(file);
+    return match;
+}
+
+bool BookStoreReader::next(OrderbookData& book) {
+    if (booksLeft_ == 0 && !enterNextBlock()) {
+        return false;
+    }
+
+    if (encoding_ == BookStoreEncoding::Delta) {
+        readDelta(book);
+    } else {
+        BookView view;
+        readRawView(view);
+
+        book.timestamp.assign(view.timestamp);
+        book.update_type = view.updateType;
+        book.seq_id = view.seqId;
+        book.prev_seq_id = view.prevSeqId;
+        book.has_checksum = view.hasChecksum;
+        book.checksum = view.checksum;
+        book.received_time = std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::nanoseconds(view.receivedTimeNs)));
+
+        GridScale price(spec_.tickSize);
+        GridScale size(spec_.lotSize);
+        book.asks.count = view.askCount;
+        book.bids.count = view.bidCount;
+        for (size_t i = 0; i < view.askCount; ++i) {
+            book.asks.prices[i] = price(view.askTicks[i]);
+            book.asks.sizes[i] = size(view.askLots[i]);
+        }
+        for (size_t i = 0; i < view.bidCount; ++i) {
+            book.bids.prices[i] = price(view.bidTicks[i]);
+            book.bids.sizes[i] = size(view.bidLots[i]);
+        }
+    }
+
+    book.exchange = exchangeId_;
+    book.symbol = symbolId_;
+    --booksLeft_;
+    return true;
+}
+
+bool BookStoreReader::nextView(BookView& view) {
+    if (encoding_ != BookStoreEncoding::Raw) {
+        throw std::logic_error("Book views need a Raw-encoded book store");
+    }
+    if (booksLeft_ == 0 && !enterNextBlock()) {
+        return false;
+    }
+
+    readRawView(view);
+    view.exchange = exchange_;
+    view.symbol = symbol_;
+    --booksLeft_;
+    return true;
+}
+
+void BookStoreReader::seek(int64_t receivedTimeNs) {
+    // Index entries are in time order; find the first block that ends at or after the time
+    size_t low = 0;
+    size_t high = blockCount_;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        IndexRecord record;
+        std::memcpy(&record, index_ + middle * sizeof(IndexRecord), sizeof(record));
+        if (record.lastNs < receivedTimeNs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    block_ = low;
+    booksLeft_ = 0;
+}
+
+void BookStoreReader::rewind() {
+    block_ = 0;
+    booksLeft_ = 0;
+}
+
+bool BookStoreReader::enterNextBlock() {
+    while (block_ < blockCount_) {
+        IndexRecord record;
+        std::memcpy(&record, index_ + block_ * sizeof(IndexRecord), sizeof(record));
+        ++block_;
+
+        if (record.offset > size_ || size_ - record.offset < sizeof(BlockHeader)) {
+            corrupt();
+        }
+        BlockHeader header;
+        std::memcpy(&header, data_ + record.offset, sizeof(header));
+        const uint8_t* payload = data_ + record.offset + sizeof(BlockHeader);
+        if (header.payloadBytes > size_ - record.offset - sizeof(BlockHeader)) {
+            corrupt();
+        }
+
+        cursor_ = payload;
+        blockEnd_ = payload + header.payloadBytes;
+        exchange_ = getString(cursor_, blockEnd_);
+        symbol_ = getString(cursor_, blockEnd_);
+        exchangeId_ = internSymbol(exchange_);
+        symbolId_ = internSymbol(symbol_);
+        cursor_ = payload + ((static_cast<size_t>(cursor_ - payload) + 7) & ~size_t(7));
+
+        booksLeft_ = header.bookCount;
+        previousNs_ = 0;
+        previousSeqId_ = 0;
+        previousAskTop_ = 0;
+        previousBidTop_ = 0;
+
+        if (booksLeft_ > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BookStoreReader::readDelta(OrderbookData& book) {
+    int64_t receivedNs = previousNs_ + getSigned(cursor_, blockEnd_);
+    if (cursor_ == blockEnd_) {
+        corrupt();
+    }
+    uint8_t flags = *cursor_++;
+    book.seq_id = previousSeqId_ + getSigned(cursor_, blockEnd_);
+    book.prev_seq_id = previousSeqId_ + getSigned(cursor_, blockEnd_);
+    book.has_checksum = (flags & kChecksumFlag) != 0;
+    book.checksum = book.has_checksum ? static_cast<int32_t>(getSigned(cursor_, blockEnd_)) : 0;
+    book.update_type = (flags & kDeltaUpdateFlag) ? BookUpdateType::Delta : BookUpdateType::Snapshot;
+    book.timestamp.assign(getString(cursor_, blockEnd_));
+    book.received_time = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(receivedNs)));
+    previousNs_ = receivedNs;
+    previousSeqId_ = book.seq_id;
+
+    uint64_t askCount = getVarint(cursor_, blockEnd_);
+    uint64_t bidCount = getVarint(cursor_, blockEnd_);
+    if (askCount > kMaxBookDepth || bidCount > kMaxBookDepth) {
+        corrupt();
+    }
+
+    GridScale priceScale(spec_.tickSize);
+    GridScale sizeScale(spec_.lotSize);
+
+    book.asks.count = askCount;
+    int64_t price = previousAskTop_;
+    for (size_t i = 0; i < askCount; ++i) {
+        price += getSigned(cursor_, blockEnd_);
+        book.asks.prices[i] = priceScale(price);
+        book.asks.sizes[i] = sizeScale(getSigned(cursor_, blockEnd_));
+        if (i == 0) {
+            previousAskTop_ = price;
+        }
+    }
+
+    book.bids.count = bidCount;
+    price = previousBidTop_;
+    for (size_t i = 0; i < bidCount; ++i) {
+        price -= getSigned(cursor_, blockEnd_);
+        book.bids.prices[i] = priceScale(price);
+        book.bids.sizes[i] = sizeScale(getSigned(cursor_, blockEnd_));
+        if (i == 0) {
+            previousBidTop_ = price;
+        }
+    }
+}
+
+void BookStoreReader::readRawView(BookView& view) {
+    if (static_cast<size_t>(blockEnd_ - cursor_) < sizeof(RawBookHeader)) {
+        corrupt();
+    }
+    const RawBookHeader* header = reinterpret_cast<const RawBookHeader*>(cursor_);
+    size_t levelBytes = (static_cast<size_t>(header->askCount) + header->bidCount) * 2 * sizeof(int64_t);
+    if (static_cast<size_t>(blockEnd_ - cursor_) - sizeof(RawBookHeader) < levelBytes ||
+        header->askCount > kMaxBookDepth || header->bidCount > kMaxBookDepth) {
+        corrupt();
+    }
+
+    view.receivedTimeNs = header->receivedNs;
+    view.seqId = header->seqId;
+    view.prevSeqId = header->prevSeqId;
+    view.checksum = header->checksum;
+    view.hasChecksum = header->hasChecksum != 0;
+    view.updateType = static_cast<BookUpdateType>(header->updateType);
+    view.timestamp = std::string_view(header->timestamp,
+                                      std::min<size_t>(header->timestampLength, kRawTimestampBytes));
+
+    const int64_t* levels = reinterpret_cast<const int64_t*>(cursor_ + sizeof(RawBookHeader));
+    view.askCount = header->askCount;
+    view.bidCount = header->bidCount;
+    view.askTicks = levels;
+    view.askLots = levels + view.askCount;
+    view.bidTicks = levels + 2 * view.askCount;
+    view.bidLots = levels + 2 * view.askCount + view.bidCount;
+
+    cursor_ += sizeof(RawBookHeader) + levelBytes;
+}
+
+// ---------------------------------------------------------------------------------------
+
+uint64_t convertFeedLog(const std::string& feedLogPath, const std::string& storePath,
+                        const BookStoreConfig& config) {
+    FeedLogReader log(feedLogPath);
+    BookStoreWriter writer(storePath, config);
+
+    FeedDecoder decoder;
+    OrderbookData book;
+    FeedLogRecord record;
+    uint64_t skipped = 0;
+    while (log.next(record)) {
+        try {
+            if (decoder.decode(record.message, book) == DecodeResult::Ignored) {
+                continue;
+            }
+        }
+        catch (const std::exception&) {
+            ++skipped;
+            continue;
+        }
+        book.received_time = std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(record.receivedTime));
+        writer.append(book);
+    }
+    writer.close();
+
+    if (skipped > 0) {
+        std::cerr << "Skipped " << skipped << " unparsable messages" << std::endl;
+    }
+    if (writer.roundedValues() > 0) {
+        std::cerr << writer.roundedValues() << " prices or sizes were not on the tick/lot grid "
+                  << "and were rounded" << std::endl;
+    }
+    return writer.bookCount();
+}
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,95 @@
+#include "data/consolidated_book.h"
+
+#include <algorithm>
+
+namespace trade_simulator {
+namespace data {
+
+void VenueDepth::assign(const BookSide& asks, const BookSide& bids) {
+    askCount = std::min(asks.size(), kVenueDepth);
+    bidCount = std::min(bids.size(), kVenueDepth);
+    std::copy_n(asks.prices.data(), askCount, askPrices.data());
+    std::copy_n(asks.sizes.data(), askCount, askSizes.data());
+    std::copy_n(bids.prices.data(), bidCount, bidPrices.data());
+    std::copy_n(bids.sizes.data(), bidCount, bidSizes.data());
+}
+
+void ConsolidatedBook::merge(const VenueDepth* const* venues, size_t count) {
+    count = std::min(count, kMaxVenues);
+    mergeSide(venues, count, true, asks_);
+    mergeSide(venues, count, false, bids_);
+
+    // Size at the best price, over every venue quoting it
+    top_ = ConsolidatedTop();
+    if (!asks_.empty()) {
+        top_.bestAsk = asks_.prices[0];
+        top_.askVenue = asks_.venues[0];
+        for (size_t i = 0; i < asks_.count && asks_.prices[i] == top_.bestAsk; ++i) {
+            top_.askSize += asks_.sizes[i];
+        }
+    }
+    if (!bids_.empty()) {
+        top_.bestBid = bids_.prices[0];
+        top_.bidVenue = bids_.venues[0];
+        for (size_t i = 0; i < bids_.count && bids_.prices[i] == top_.bestBid; ++i) {
+            top_.bidSize += bids_.sizes[i];
+        }
+    }
+}
+
+void ConsolidatedBook::mergeSide(const VenueDepth* const* venues, size_t count, bool ascending,
+                                 ConsolidatedSide& side) {
+    // Cursor and end of each venue's side; venues that ran out are dropped from the scan
+    const double* prices[kMaxVenues];
+    const double* sizes[kMaxVenues];
+    size_t remaining[kMaxVenues];
+    uint8_t venueOf[kMaxVenues];
+    size_t active = 0;
+    for (size_t v = 0; v < count; ++v) {
+        if (!venues[v]) {
+            continue;
+        }
+        const VenueDepth& depth = *venues[v];
+        size_t levels = ascending ? depth.askCount : depth.bidCount;
+        if (levels == 0) {
+            continue;
+        }
+        prices[active] = ascending ? depth.askPrices.data() : depth.bidPrices.data();
+        sizes[active] = ascending ? depth.askSizes.data() : depth.bidSizes.data();
+        remaining[active] = levels;
+        venueOf[active] = static_cast<uint8_t>(v);
+        ++active;
+    }
+
+    double* outPrices = side.prices.data();
+    double* outSizes = side.sizes.data();
+    uint8_t* outVenues = side.venues.data();
+    size_t out = 0;
+    while (active > 0) {
+        // Best head; ties go to the lower venue index, so the merge is stable
+        size_t best = 0;
+        for (size_t i = 1; i < active; ++i) {
+            bool better = ascending ? *prices[i] < *prices[best] : *prices[i] > *prices[best];
+            best = better ? i : best;
+        }
+        outPrices[out] = *prices[best]++;
+        outSizes[out] = *sizes[best]++;
+        outVenues[out] = venueOf[best];
+        ++out;
+
+        if (--remaining[best] == 0) {
+            // Keep the cursors in venue order so ties stay stable
+            for (size_t i = best + 1; i < active; ++i) {
+                prices[i - 1] = prices[i];
+                sizes[i - 1] = sizes[i];
+                remaining[i - 1] = remaining[i];
+                venueOf[i - 1] = venueOf[i];
+            }
+            --active;
+        }
+    }
+    side.count = out;
+}
+
+} // namespace data
+} // namespace trade_simulator
@@ -0,0 +1,109 @@
+#include "data/depth_profile.h"
+
+#include <algorithm>
+
+namespace trade_simulator {
+namespace data {
+
+DepthProfile::DepthProfile(const DepthProfile& other) {
+    *this = other;
+}
+
+DepthProfile& DepthProfile::operator=(const DepthProfile& other) {
+    if (this != &other) {
+        asks_ = other.current(true);
+        bids_ = other.current(false);
+        asks_.source = nullptr;
+        bids_.source = nullptr;
+        midprice_ = other.midprice_;
+    }
+    return *this;
+}
+
+void DepthProfile::rebuild(const BookSide& asks, const BookSide& bids) {
+    asks_.source = nullptr;
+    bids_.source = nullptr;
+    rebuildSide(asks, 0, asks_);
+    rebuildSide(bids, 0, bids_);
+
+    midprice_ = (asks.empty() || bids.empty()) ? 0.0 : (asks.prices[0] + bids.prices[0]) / 2.0;
+}
+
+void DepthProfile::update(const BookSide& asks, const BookSide& bids, size_t firstAsk, size_t firstBid) {
+    // A different book invalidates every level, and changes accumulate until a query
+    asks_.staleFrom = std::min(asks_.source == &asks ? asks_.staleFrom : 0, firstAsk);
+    bids_.staleFrom = std::min(bids_.source == &bids ? bids_.staleFrom : 0, firstBid);
+    asks_.source = &asks;
+    bids_.source = &bids;
+
+    midprice_ = (asks.empty() || bids.empty()) ? 0.0 : (asks.prices[0] + bids.prices[0]) / 2.0;
+}
+
+FillEstimate DepthProfile::walk(double quantity, bool isBuy) const {
+    return walkSide(current(isBuy), quantity);
+}
+
+double DepthProfile::totalSize(bool isBuy) const {
+    const SideProfile& profile = current(isBuy);
+    return profile.cumSize[profile.count];
+}
+
+const DepthProfile::SideProfile& DepthProfile::current(bool isBuy) const {
+    SideProfile& profile = isBuy ? asks_ : bids_;
+    if (profile.source && profile.staleFrom < kMaxBookDepth) {
+        rebuildSide(*profile.source, profile.staleFrom, profile);
+    }
+    return profile;
+}
+
+void DepthProfile::rebuildSide(const BookSide& side, size_t from, SideProfile& profile) {
+    // Levels before `from` and their prefix sums are unchanged
+    from = std::min(from, side.size());
+    profile.count = side.size();
+    profile.staleFrom = kMaxBookDepth;
+    std::copy(side.prices.data() + from, side.prices.data() + side.size(), profile.prices.data() + from);
+
+    double size = profile.cumSize[from];
+    double notional = profile.cumNotional[from];
+    for (size_t i = from; i < side.size(); ++i) {
+        size += side.sizes[i];
+        notional += side.prices[i] * side.sizes[i];
+        profile.cumSize[i + 1] = size;
+        profile.cumNotional[i + 1] = notional;
+    }
+}
+
+FillEstimate DepthProfile::walkSide(const SideProfile& profile, double quantity) {
+    FillEstimate fill;
+    if (quantity <= 0.0 || profile.count == 0) {
+        fill.residualSize = std::max(quantity, 0.0);
+        return fill;
+    }
+
+    // First level whose cumulative size reaches the quantity
+    const double* cumBegin = profile.cumSize.data() + 1;
+    const double* cumEnd = cumBegin + profile.count;
+    size_t level = static_cast<size_t>(std::lower_bound(cumBegin, cumEnd, quantity) - cumBegin);
+
+    if (level == profile.count) {
+        // The whole side is consumed
+        fill.filledSize = profile.cumSize[profile.count];
+        fill.notional = profile.cumNotional[profile.count];
+        fill.residualSize = quantity - fill.filledSize;
+        fill.levelsConsumed = profile.count;
+        fill.worstPrice = profile.prices[profile.count - 1];
+    } else {
+        // Full levels before it plus a partial fill of it
+        double partial = quantity - profile.cumSize[level];
+        fill.filledSize = quantity;
+        fill.notional = profile.cumNotional[level] + partial * profile.prices[level];
+        fill.levelsConsumed = level + 1;
+        fill.worstPrice = profile.prices[level];
+    }
+
+    fill.vwap = fill.filledSize > 0.0 ? fill.notional / fill.filledSize : 0.0;
+    return fill;
+}
+
+} // namespace data
+} // namespace trade_simulator 
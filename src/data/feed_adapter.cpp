@@ -0,0 +1,468 @@
+#include "data/feed_adapter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "data/json_cursor.h"
+#include "data/l2_parser.h"
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+// Bytes of a message searched by detectVenue()
+constexpr size_t kDetectPrefixBytes = 512;
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+/**
+ * @brief Parse an array of levels, taking the price and size from fixed positions
+ *
+ * Instantiated once per venue layout, so the position tests fold into straight-line code.
+ *
+ * @tparam PriceIndex Position of the price in a level
+ * @tparam SizeIndex Position of the size in a level
+ * @param cursor Cursor positioned at the array
+ * @param side Output side, appended to; levels beyond its maximum depth are dropped
+ */
+template <size_t PriceIndex, size_t SizeIndex>
+void readLevels(JsonCursor& cursor, BookSide& side) {
+    static_assert(PriceIndex < SizeIndex, "The size follows the price");
+    for (bool more = cursor.beginArray(); more; more = cursor.nextElement()) {
+        if (!cursor.beginArray()) {
+            continue;  // Empty level
+        }
+        double price = 0.0;
+        double size = 0.0;
+        bool complete = false;
+        size_t index = 0;
+        for (bool field = true; field; field = cursor.nextElement(), ++index) {
+            if (index == PriceIndex) {
+                price = cursor.readNumber();
+            } else if (index == SizeIndex) {
+                size = cursor.readNumber();
+                complete = true;
+            } else {
+                cursor.skipValue();  // Order counts, Deribit's level action, ...
+            }
+        }
+        if (complete) {
+            side.push(price, size);
+        }
+    }
+}
+
+// [price, size, ...] as sent by OKX, Binance and Bybit
+void readPriceSizeLevels(JsonCursor& cursor, BookSide& side) {
+    readLevels<0, 1>(cursor, side);
+}
+
+} // namespace
+
+const char* venueName(Venue venue) {
+    switch (venue) {
+        case Venue::GoQuant:
+            return "GoQuant";
+        case Venue::Okx:
+            return "OKX";
+        case Venue::Binance:
+            return "Binance";
+        case Venue::Bybit:
+            return "Bybit";
+        case Venue::Deribit:
+            return "Deribit";
+    }
+    return "Unknown";
+}
+
+std::optional<Venue> parseVenue(std::string_view name) {
+    for (Venue venue : {Venue::GoQuant, Venue::Okx, Venue::Binance, Venue::Bybit, Venue::Deribit}) {
+        if (equalsIgnoreCase(name, venueName(venue))) {
+            return venue;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Venue> detectVenue(std::string_view message) {
+    std::string_view head = message.substr(0, kDetectPrefixBytes);
+    auto contains = [head](std::string_view text) {
+        return head.find(text) != std::string_view::npos;
+    };
+
+    if (contains("\"jsonrpc\"")) {
+        return Venue::Deribit;
+    }
+    if (contains("\"topic\":\"orderbook.")) {
+        return Venue::Bybit;
+    }
+    if (contains("\"arg\":")) {
+        return Venue::Okx;
+    }
+    if (contains("\"e\":\"depthUpdate\"")) {
+        return Venue::Binance;
+    }
+    if (contains("\"exchange\":") && contains("\"symbol\":")) {
+        return Venue::GoQuant;
+    }
+    return std::nullopt;
+}
+
+InstrumentSpec defaultInstrumentSpec(Venue venue, std::string_view instrument) {
+    switch (venue) {
+        case Venue::GoQuant:
+            return InstrumentSpec();
+        case Venue::Okx:
+            // Swap sizes are contracts of a fixed face value; lots are 0.01 contracts
+            if (instrument == "BTC-USDT-SWAP") {
+                return InstrumentSpec(0.1, 0.0001, SizeUnit::Contracts, 0.01);
+            }
+            if (instrument == "ETH-USDT-SWAP") {
+                return InstrumentSpec(0.01, 0.001, SizeUnit::Contracts, 0.1);
+            }
+            return InstrumentSpec(0.01, 0.0001);
+        case Venue::Binance:
+            if (instrument == "BTCUSDT") {
+                return InstrumentSpec(0.1, 0.001);
+            }
+            return InstrumentSpec(0.01, 0.001);
+        case Venue::Bybit:
+            if (instrument == "BTCUSDT") {
+                return InstrumentSpec(0.1, 0.001);
+            }
+            if (instrument == "ETHUSDT") {
+                return InstrumentSpec(0.01, 0.01);
+            }
+            return InstrumentSpec(0.01, 0.001);
+        case Venue::Deribit:
+            // Inverse perpetuals quote amounts in USD; base sizes are off any lot grid
+            if (instrument == "BTC-PERPETUAL") {
+                return InstrumentSpec(0.5, 1e-8, SizeUnit::Quote);
+            }
+            if (instrument == "ETH-PERPETUAL") {
+                return InstrumentSpec(0.05, 1e-8, SizeUnit::Quote);
+            }
+            if (instrument.find('_') != std::string_view::npos) {
+                return InstrumentSpec(0.01, 0.001);  // Linear USDC perpetuals
+            }
+            return InstrumentSpec(0.5, 1e-8, SizeUnit::Quote);
+    }
+    return InstrumentSpec();
+}
+
+std::string perpetualInstrument(Venue venue, std::string_view symbol) {
+    size_t dash = symbol.find('-');
+    std::string_view base = symbol.substr(0, dash);
+    std::string_view quote = dash == std::string_view::npos ? std::string_view() : symbol.substr(dash + 1);
+
+    switch (venue) {
+        case Venue::GoQuant:
+        case Venue::Okx:
+            return std::string(symbol) + "-SWAP";
+        case Venue::Binance:
+        case Venue::Bybit:
+            return std::string(base) + std::string(quote);
+        case Venue::Deribit:
+            if (quote == "USDC") {
+                return std::string(base) + "_USDC-PERPETUAL";
+            }
+            return std::string(base) + "-PERPETUAL";
+    }
+    return std::string(symbol);
+}
+
+std::string venueInstrument(Venue venue, std::string_view name) {
+    size_t dash = name.find('-');
+    std::string_view quote = dash == std::string_view::npos ? std::string_view() : name.substr(dash + 1);
+    bool pair = dash != 0 && (quote == "USDT" || quote == "USDC" || quote == "USD");
+    return pair ? perpetualInstrument(venue, name) : std::string(name);
+}
+
+DecodeResult GoQuantDecoder::decodeMessage(std::string_view message, OrderbookData& book) {
+    L2Parser::parse(message, book);
+    return DecodeResult::Book;
+}
+
+DecodeResult OkxDecoder::decodeMessage(std::string_view message, OrderbookData& book) {
+    static const SymbolId exchange = internSymbol(venueName(kVenue));
+    if (message == "pong") {
+        return DecodeResult::Ignored;  // Reply to the heartbeat, not JSON
+    }
+
+    JsonCursor cursor(message);
+    bool hasBook = false;
+    BookUpdateType updateType = BookUpdateType::Snapshot;
+
+    for (bool more = cursor.beginObject(); more; more = cursor.nextMember()) {
+        std::string_view key = cursor.readKey();
+        if (key == "arg") {
+            for (bool field = cursor.beginObject(); field; field = cursor.nextMember()) {
+                if (cursor.readKey() == "instId") {
+                    book.symbol = internSymbol(cursor.readString());
+                } else {
+                    cursor.skipValue();
+                }
+            }
+        } else if (key == "action") {
+            updateType = cursor.readString() == "update" ? BookUpdateType::Delta : BookUpdateType::Snapshot;
+        } else if (key == "data") {
+            for (bool entry = cursor.beginArray(); entry; entry = cursor.nextElement()) {
+                if (hasBook) {
+                    cursor.skipValue();  // One book per push
+                    continue;
+                }
+                for (bool field = cursor.beginObject(); field; field = cursor.nextMember()) {
+                    std::string_view name = cursor.readKey();
+                    if (name == "asks") {
+                        readPriceSizeLevels(cursor, book.asks);
+                    } else if (name == "bids") {
+                        readPriceSizeLevels(cursor, book.bids);
+                    } else if (name == "ts") {
+                        book.timestamp.assign(cursor.readScalarText());
+                    } else if (name == "seqId") {
+                        book.seq_id = cursor.readInteger();
+                    } else if (name == "prevSeqId") {
+                        book.prev_seq_id = cursor.readInteger();
+                    } else if (name == "checksum") {
+                        book.checksum = static_cast<int32_t>(cursor.readInteger());
+                        book.has_checksum = true;
+                    } else {
+                        cursor.skipValue();
+                    }
+                }
+                hasBook = true;
+            }
+        } else {
+            cursor.skipValue();  // "event" of acknowledgements and errors
+        }
+    }
+
+    if (!hasBook) {
+        return DecodeResult::Ignored;
+    }
+    if (book.symbol == kNoSymbol) {
+        throw std::runtime_error("OKX book without an instrument");
+    }
+    book.exchange = exchange;
+    book.update_type = updateType;
+    return DecodeResult::Book;
+}
+
+DecodeResult BinanceDecoder::decodeMessage(std::string_view message, OrderbookData& book) {
+    static const SymbolId exchange = internSymbol(venueName(kVenue));
+
+    JsonCursor cursor(message);
+    bool isDepth = false;
+    bool hasLevels = false;
+
+    for (bool more = cursor.beginObject(); more; more = cursor.nextMember()) {
+        std::string_view key = cursor.readKey();
+        if (key == "e") {
+            isDepth = cursor.readString() == "depthUpdate";
+        } else if (key == "E") {
+            book.timestamp.assign(cursor.readScalarText());
+        } else if (key == "s") {
+            book.symbol = internSymbol(cursor.readString());
+        } else if (key == "u") {
+            book.seq_id = cursor.readInteger();
+        } else if (key == "a") {
+            readPriceSizeLevels(cursor, book.asks);
+            hasLevels = true;
+        } else if (key == "b") {
+            readPriceSizeLevels(cursor, book.bids);
+            hasLevels = true;
+        } else {
+            cursor.skipValue();
+        }
+    }
+
+    if (!isDepth || !hasLevels) {
+        return DecodeResult::Ignored;
+    }
+    if (book.symbol == kNoSymbol) {
+        throw std::runtime_error("Binance depth update without a symbol");
+    }
+    book.exchange = exchange;
+    book.update_type = BookUpdateType::Snapshot;
+    return DecodeResult::Book;
+}
+
+DecodeResult BybitDecoder::decodeMessage(std::string_view message, OrderbookData& book) {
+    static const SymbolId exchange = internSymbol(venueName(kVenue));
+
+    JsonCursor cursor(message);
+    bool isOrderbook = false;
+    bool hasData = false;
+    BookUpdateType updateType = BookUpdateType::Snapshot;
+
+    for (bool more = cursor.beginObject(); more; more = cursor.nextMember()) {
+        std::string_view key = cursor.readKey();
+        if (key == "topic") {
+            isOrderbook = startsWith(cursor.readString(), "orderbook.");
+        } else if (key == "type") {
+            updateType = cursor.readString() == "delta" ? BookUpdateType::Delta : BookUpdateType::Snapshot;
+        } else if (key == "ts") {
+            book.timestamp.assign(cursor.readScalarText());
+        } else if (key == "data" && cursor.peek() == '{') {
+            for (bool field = cursor.beginObject(); field; field = cursor.nextMember()) {
+                std::string_view name = cursor.readKey();
+                if (name == "s") {
+                    book.symbol = internSymbol(cursor.readString());
+                } else if (name == "a") {
+                    readPriceSizeLevels(cursor, book.asks);
+                } else if (name == "b") {
+                    readPriceSizeLevels(cursor, book.bids);
+                } else if (name == "u") {
+                    book.seq_id = cursor.readInteger();
+                } else {
+                    cursor.skipValue();
+                }
+            }
+            hasData = true;
+        } else {
+            cursor.skipValue();  // "op", "success" and "ret_msg" of acknowledgements
+        }
+    }
+
+    if (!isOrderbook || !hasData) {
+        return DecodeResult::Ignored;
+    }
+    if (book.symbol == kNoSymbol) {
+        throw std::runtime_error("Bybit orderbook without a symbol");
+    }
+    book.exchange = exchange;
+    book.update_type = updateType;
+    // Update ids of a stream are consecutive, so each delta follows the previous id
+    if (updateType == BookUpdateType::Delta && book.seq_id > 0) {
+        book.prev_seq_id = book.seq_id - 1;
+    }
+    return DecodeResult::Book;
+}
+
+DecodeResult DeribitDecoder::decodeMessage(std::string_view message, OrderbookData& book) {
+    static const SymbolId exchange = internSymbol(venueName(kVenue));
+
+    JsonCursor cursor(message);
+    bool isSubscription = false;
+    bool isBook = false;
+    bool hasData = false;
+    BookUpdateType updateType = BookUpdateType::Snapshot;
+
+    for (bool more = cursor.beginObject(); more; more = cursor.nextMember()) {
+        std::string_view key = cursor.readKey();
+        if (key == "method") {
+            isSubscription = cursor.readString() == "subscription";
+        } else if (key == "params" && cursor.peek() == '{') {
+            for (bool param = cursor.beginObject(); param; param = cursor.nextMember()) {
+                std::string_view name = cursor.readKey();
+                if (name == "channel") {
+                    isBook = startsWith(cursor.readString(), "book.");
+                } else if (name == "data" && cursor.peek() == '{') {
+                    for (bool field = cursor.beginObject(); field; field = cursor.nextMember()) {
+                        std::string_view dataKey = cursor.readKey();
+                        if (dataKey == "type") {
+                            updateType = cursor.readString() == "change" ? BookUpdateType::Delta
+                                                                         : BookUpdateType::Snapshot;
+                        } else if (dataKey == "timestamp") {
+                            book.timestamp.assign(cursor.readScalarText());
+                        } else if (dataKey == "instrument_name") {
+                            book.symbol = internSymbol(cursor.readString());
+                        } else if (dataKey == "change_id") {
+                            book.seq_id = cursor.readInteger();
+                        } else if (dataKey == "prev_change_id") {
+                            book.prev_seq_id = cursor.readInteger();
+                        } else if (dataKey == "asks") {
+                            readLevels<1, 2>(cursor, book.asks);  // ["new"|"change"|"delete", price, amount]
+                        } else if (dataKey == "bids") {
+                            readLevels<1, 2>(cursor, book.bids);
+                        } else {
+                            cursor.skipValue();
+                        }
+                    }
+                    hasData = true;
+                } else {
+                    cursor.skipValue();
+                }
+            }
+        } else {
+            cursor.skipValue();  // "jsonrpc", and "id"/"result" of responses
+        }
+    }
+
+    if (!isSubscription || !isBook || !hasData) {
+        return DecodeResult::Ignored;
+    }
+    if (book.symbol == kNoSymbol) {
+        throw std::runtime_error("Deribit book without an instrument");
+    }
+    book.exchange = exchange;
+    book.update_type = updateType;
+    if (updateType == BookUpdateType::Snapshot) {
+        book.prev_seq_id = -1;
+    }
+    return DecodeResult::Book;
+}
+
+FeedDecoder::FeedDecoder(Venue venue, const InstrumentSpec& spec) {
+    select(venue, spec, false);
+}
+
+std::optional<Venue> FeedDecoder::venue() const {
+    switch (decoders_.index()) {
+        case 1:
+            return Venue::GoQuant;
+        case 2:
+            return Venue::Okx;
+        case 3:
+            return Venue::Binance;
+        case 4:
+            return Venue::Bybit;
+        case 5:
+            return Venue::Deribit;
+        default:
+            return std::nullopt;
+    }
+}
+
+void FeedDecoder::select(Venue venue, const InstrumentSpec& spec, bool lookupSpecs) {
+    switch (venue) {
+        case Venue::GoQuant:
+            decoders_.emplace<GoQuantDecoder>(spec, lookupSpecs);
+            break;
+        case Venue::Okx:
+            decoders_.emplace<OkxDecoder>(spec, lookupSpecs);
+            break;
+        case Venue::Binance:
+            decoders_.emplace<BinanceDecoder>(spec, lookupSpecs);
+            break;
+        case Venue::Bybit:
+            decoders_.emplace<BybitDecoder>(spec, lookupSpecs);
+            break;
+        case Venue::Deribit:
+            decoders_.emplace<DeribitDecoder>(spec, lookupSpecs);
+            break;
+    }
+}
+
+bool FeedDecoder::detect(std::string_view message) {
+    std::optional<Venue> detected = detectVenue(message);
+    if (!detected) {
+        return false;
+    }
+    select(*detected, defaultInstrumentSpec(*detected, std::string_view()), true);
+    return true;
+}
+
+} // namespace data
+} // namespace trade_simulator
@@ -0,0 +1,89 @@
+#include "data/feed_log_reader.h"
+#include "data/feed_recorder.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+constexpr size_t kRecordHeaderBytes = sizeof(uint64_t) + sizeof(uint32_t);
+
+/**
+ * @brief Read a little-endian integer
+ */
+template <typename T>
+T readLittleEndian(const unsigned char* bytes) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+FeedLogReader::FeedLogReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open feed log: " + path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FeedRecorder::kMagic)) {
+        ::close(fd);
+        throw std::runtime_error("Not a feed log: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map feed log: " + path);
+    }
+    data_ = static_cast<const unsigned char*>(mapping);
+
+    // Replay reads front to back
+    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+
+    if (std::memcmp(data_, FeedRecorder::kMagic, sizeof(FeedRecorder::kMagic)) != 0) {
+        ::munmap(mapping, size_);
+        throw std::runtime_error("Not a feed log: " + path);
+    }
+    rewind();
+}
+
+FeedLogReader::~FeedLogReader() {
+    ::munmap(const_cast<unsigned char*>(data_), size_);
+}
+
+bool FeedLogReader::next(FeedLogRecord& record) {
+    if (size_ - offset_ < kRecordHeaderBytes) {
+        return false;
+    }
+
+    const unsigned char* header = data_ + offset_;
+    uint64_t nanos = readLittleEndian<uint64_t>(header);
+    uint32_t length = readLittleEndian<uint32_t>(header + sizeof(uint64_t));
+    if (size_ - offset_ - kRecordHeaderBytes < length) {
+        return false;  // Cut off while recording
+    }
+
+    record.receivedTime = std::chrono::nanoseconds(static_cast<int64_t>(nanos));
+    record.message = std::string_view(reinterpret_cast<const char*>(header + kRecordHeaderBytes), length);
+    offset_ += kRecordHeaderBytes + length;
+    return true;
+}
+
+void FeedLogReader::rewind() {
+    offset_ = sizeof(FeedRecorder::kMagic);
+}
+
+} // namespace data
+} // namespace trade_simulator 
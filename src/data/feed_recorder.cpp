@@ -0,0 +1,60 @@
+#include "data/feed_recorder.h"
+
+#include <stdexcept>
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+/**
+ * @brief Write an integer in little-endian byte order
+ */
+template <typename T>
+void writeLittleEndian(std::FILE* file, T value) {
+    unsigned char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    std::fwrite(bytes, 1, sizeof(T), file);
+}
+
+} // namespace
+
+FeedRecorder::FeedRecorder(const std::string& path)
+    : file_(std::fopen(path.c_str(), "wb")) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open feed log for writing: " + path);
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, kWriteBufferBytes);
+    std::fwrite(kMagic, 1, sizeof(kMagic), file_);
+}
+
+FeedRecorder::~FeedRecorder() {
+    std::fclose(file_);
+}
+
+void FeedRecorder::record(std::string_view message,
+                          std::chrono::steady_clock::time_point receivedTime) {
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        receivedTime.time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeLittleEndian(file_, static_cast<uint64_t>(nanos));
+    writeLittleEndian(file_, static_cast<uint32_t>(message.size()));
+    std::fwrite(message.data(), 1, message.size(), file_);
+    ++recordedMessages_;
+}
+
+void FeedRecorder::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fflush(file_);
+}
+
+uint64_t FeedRecorder::recordedMessages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recordedMessages_;
+}
+
+} // namespace data
+} // namespace trade_simulator 
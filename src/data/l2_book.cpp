@@ -0,0 +1,203 @@
+#include "data/l2_book.h"
+#include "data/book_kernels.h"
+
+#include <algorithm>
+#include <charconv>
+#include <boost/crc.hpp>
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+/**
+ * @brief Append a value in shortest round-trip form to a checksum input buffer
+ */
+char* appendValue(char* out, char* end, double value) {
+    auto [ptr, ec] = std::to_chars(out, end, value);
+    return ec == std::errc() ? ptr : out;
+}
+
+/**
+ * @brief Append a size converted back to the exchange's unit to a checksum input buffer
+ */
+char* appendSize(char* out, char* end, double size, double sizeUnit) {
+    if (sizeUnit == 1.0) {
+        return appendValue(out, end, size);
+    }
+    auto [ptr, ec] = std::to_chars(out, end, size / sizeUnit, std::chars_format::general, 15);
+    return ec == std::errc() ? ptr : out;
+}
+
+} // namespace
+
+BookApplyResult L2Book::apply(const OrderbookData& update) {
+    if (update.update_type == BookUpdateType::Snapshot) {
+        applySnapshot(update);
+    } else {
+        if (!synced_) {
+            return BookApplyResult::AwaitingSnapshot;
+        }
+
+        // Every delta must follow the last one we applied
+        if (update.prev_seq_id >= 0 && lastSeqId_ >= 0 && update.prev_seq_id != lastSeqId_) {
+            synced_ = false;
+            return BookApplyResult::SequenceGap;
+        }
+
+        firstChangedAsk_ = kMaxBookDepth;
+        firstChangedBid_ = kMaxBookDepth;
+        for (size_t i = 0; i < update.asks.size(); ++i) {
+            size_t level = applyLevel(asks_, askTotals_, update.asks.prices[i], update.asks.sizes[i], true);
+            firstChangedAsk_ = std::min(firstChangedAsk_, level);
+        }
+        for (size_t i = 0; i < update.bids.size(); ++i) {
+            size_t level = applyLevel(bids_, bidTotals_, update.bids.prices[i], update.bids.sizes[i], false);
+            firstChangedBid_ = std::min(firstChangedBid_, level);
+        }
+        lastChangedLevels_ = update.asks.size() + update.bids.size();
+
+        if (++deltasSinceRecompute_ >= kTotalsRecomputeInterval) {
+            recomputeTotals();
+        }
+    }
+
+    lastSeqId_ = update.seq_id;
+
+    if (update.has_checksum && checksum(update.checksum_size_unit) != update.checksum) {
+        synced_ = false;
+        return BookApplyResult::ChecksumMismatch;
+    }
+    return BookApplyResult::Applied;
+}
+
+void L2Book::reset() {
+    asks_.clear();
+    bids_.clear();
+    askTotals_ = SideTotals();
+    bidTotals_ = SideTotals();
+    synced_ = false;
+    lastSeqId_ = -1;
+    lastChangedLevels_ = 0;
+    firstChangedAsk_ = 0;
+    firstChangedBid_ = 0;
+    deltasSinceRecompute_ = 0;
+}
+
+int32_t L2Book::checksum(double sizeUnit) const {
+    // 25 levels per side, four values each, at most ~25 characters per value
+    char buffer[kChecksumLevels * 4 * 26];
+    char* out = buffer;
+    char* end = buffer + sizeof(buffer);
+
+    for (size_t i = 0; i < static_cast<size_t>(kChecksumLevels); ++i) {
+        if (i < bids_.size()) {
+            out = appendValue(out, end, bids_.prices[i]);
+            *out++ = ':';
+            out = appendSize(out, end, bids_.sizes[i], sizeUnit);
+            *out++ = ':';
+        }
+        if (i < asks_.size()) {
+            out = appendValue(out, end, asks_.prices[i]);
+            *out++ = ':';
+            out = appendSize(out, end, asks_.sizes[i], sizeUnit);
+            *out++ = ':';
+        }
+    }
+    if (out != buffer) {
+        --out;  // No separator after the last value
+    }
+
+    boost::crc_32_type crc;
+    crc.process_bytes(buffer, static_cast<size_t>(out - buffer));
+    return static_cast<int32_t>(crc.checksum());
+}
+
+double L2Book::sizeAt(bool isBid, double price) const {
+    const BookSide& side = isBid ? bids_ : asks_;
+    const double* prices = side.prices.data();
+    size_t count = side.size();
+    const double* position = isBid
+        ? std::lower_bound(prices, prices + count, price, std::greater<double>())
+        : std::lower_bound(prices, prices + count, price);
+    size_t index = static_cast<size_t>(position - prices);
+    return index < count && prices[index] == price ? side.sizes[index] : 0.0;
+}
+
+void L2Book::applySnapshot(const OrderbookData& snapshot) {
+    asks_ = snapshot.asks;
+    bids_ = snapshot.bids;
+    recomputeTotals();
+
+    synced_ = true;
+    lastChangedLevels_ = asks_.size() + bids_.size();
+    firstChangedAsk_ = 0;
+    firstChangedBid_ = 0;
+}
+
+size_t L2Book::applyLevel(BookSide& side, SideTotals& totals, double price, double size,
+                          bool ascending) {
+    double* prices = side.prices.data();
+    double* sizes = side.sizes.data();
+    size_t count = side.size();
+
+    // Position of the first level not better than the price
+    double* position = ascending
+        ? std::lower_bound(prices, prices + count, price)
+        : std::lower_bound(prices, prices + count, price, std::greater<double>());
+    size_t index = static_cast<size_t>(position - prices);
+    bool exists = index < count && prices[index] == price;
+
+    if (exists) {
+        totals.size += size - sizes[index];
+        totals.notional += price * (size - sizes[index]);
+
+        if (size > 0.0) {
+            sizes[index] = size;
+        } else {
+            // Delete: close the gap
+            std::copy(prices + index + 1, prices + count, prices + index);
+            std::copy(sizes + index + 1, sizes + count, sizes + index);
+            --side.count;
+        }
+        return index;
+    }
+
+    if (size <= 0.0) {
+        return kMaxBookDepth;  // Deleting a level we do not hold
+    }
+
+    if (side.full()) {
+        if (index == count) {
+            return kMaxBookDepth;  // Beyond the deepest level we keep
+        }
+        // Make room by dropping the deepest level
+        --side.count;
+        --count;
+        totals.size -= sizes[count];
+        totals.notional -= prices[count] * sizes[count];
+    }
+
+    // Insert: open a gap
+    std::copy_backward(prices + index, prices + count, prices + count + 1);
+    std::copy_backward(sizes + index, sizes + count, sizes + count + 1);
+    prices[index] = price;
+    sizes[index] = size;
+    ++side.count;
+
+    totals.size += size;
+    totals.notional += price * size;
+    return index;
+}
+
+void L2Book::recomputeTotals() {
+    deltasSinceRecompute_ = 0;
+
+    askTotals_.size = kernels::sumSizes(asks_.sizes.data(), asks_.size());
+    askTotals_.notional = kernels::sumNotional(asks_.prices.data(), asks_.sizes.data(), asks_.size());
+    bidTotals_.size = kernels::sumSizes(bids_.sizes.data(), bids_.size());
+    bidTotals_.notional = kernels::sumNotional(bids_.prices.data(), bids_.sizes.data(), bids_.size());
+}
+
+} // namespace data
+} // namespace trade_simulator 
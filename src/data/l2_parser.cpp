@@ -0,0 +1,96 @@
+#include "data/l2_parser.h"
+#include "data/json_cursor.h"
+
+#include <stdexcept>
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+// Bits of the required fields seen in a message
+constexpr unsigned kTimestampField = 1u << 0;
+constexpr unsigned kExchangeField = 1u << 1;
+constexpr unsigned kSymbolField = 1u << 2;
+constexpr unsigned kAsksField = 1u << 3;
+constexpr unsigned kBidsField = 1u << 4;
+constexpr unsigned kRequiredFields =
+    kTimestampField | kExchangeField | kSymbolField | kAsksField | kBidsField;
+
+/**
+ * @brief Parse an array of [price, size, ...] levels
+ * @param cursor Cursor positioned at the array
+ * @param side Output side, appended to; levels beyond its maximum depth are dropped
+ */
+void parseLevels(JsonCursor& cursor, BookSide& side) {
+    for (bool more = cursor.beginArray(); more; more = cursor.nextElement()) {
+        if (!cursor.beginArray()) {
+            continue;  // Empty level, nothing to read
+        }
+        double price = cursor.readNumber();
+        if (!cursor.nextElement()) {
+            continue;  // Level without a size, skip it
+        }
+        double size = cursor.readNumber();
+        // Skip any extra fields some venues append (order count, liquidated orders, ...)
+        while (cursor.nextElement()) {
+            cursor.skipValue();
+        }
+        side.push(price, size);
+    }
+}
+
+} // namespace
+
+void L2Parser::parse(std::string_view message, OrderbookData& orderbook) {
+    orderbook.asks.clear();
+    orderbook.bids.clear();
+    orderbook.update_type = BookUpdateType::Snapshot;
+    orderbook.seq_id = -1;
+    orderbook.prev_seq_id = -1;
+    orderbook.has_checksum = false;
+
+    JsonCursor cursor(message);
+    unsigned seenFields = 0;
+
+    for (bool more = cursor.beginObject(); more; more = cursor.nextMember()) {
+        std::string_view key = cursor.readKey();
+
+        if (key == "asks") {
+            parseLevels(cursor, orderbook.asks);
+            seenFields |= kAsksField;
+        } else if (key == "bids") {
+            parseLevels(cursor, orderbook.bids);
+            seenFields |= kBidsField;
+        } else if (key == "timestamp") {
+            orderbook.timestamp.assign(cursor.readString());
+            seenFields |= kTimestampField;
+        } else if (key == "exchange") {
+            orderbook.exchange = internSymbol(cursor.readString());
+            seenFields |= kExchangeField;
+        } else if (key == "symbol") {
+            orderbook.symbol = internSymbol(cursor.readString());
+            seenFields |= kSymbolField;
+        } else if (key == "action") {
+            orderbook.update_type = cursor.readString() == "update"
+                ? BookUpdateType::Delta : BookUpdateType::Snapshot;
+        } else if (key == "seqId") {
+            orderbook.seq_id = cursor.readInteger();
+        } else if (key == "prevSeqId") {
+            orderbook.prev_seq_id = cursor.readInteger();
+        } else if (key == "checksum") {
+            orderbook.checksum = static_cast<int32_t>(cursor.readInteger());
+            orderbook.has_checksum = true;
+        } else {
+            cursor.skipValue();
+        }
+    }
+
+    // Basic validation of the data
+    if ((seenFields & kRequiredFields) != kRequiredFields) {
+        throw std::runtime_error("Missing required fields in data");
+    }
+}
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,62 @@
+#include "data/live_feed_source.h"
+
+namespace trade_simulator {
+namespace data {
+
+LiveFeedSource::LiveFeedSource(OrderbookCallback callback, const std::string& recordPath,
+                               const utils::ThreadConfig& threadConfig, bool hotStandby)
+    : callback_(std::move(callback)),
+      hotStandby_(hotStandby),
+      client_([this](FeedId feedId, const OrderbookData& data) {
+                  if (feedId == activeFeedId_) {
+                      callback_(data);
+                  }
+              },
+              1, threadConfig) {
+    if (!recordPath.empty()) {
+        recorder_ = std::make_unique<FeedRecorder>(recordPath);
+        client_.setRawMessageCallback(
+            [this](FeedId feedId, std::string_view message,
+                   std::chrono::steady_clock::time_point receivedTime) {
+                if (feedId == activeFeedId_) {
+                    recorder_->record(message, receivedTime);
+                }
+            });
+    }
+}
+
+LiveFeedSource::~LiveFeedSource() {
+    stop();
+}
+
+void LiveFeedSource::start() {
+    client_.start();
+}
+
+void LiveFeedSource::stop() {
+    client_.stop();
+    if (recorder_) {
+        recorder_->flush();
+    }
+}
+
+void LiveFeedSource::selectInstrument(const std::string& exchange, const std::string& instrument) {
+    FeedId previous = activeFeedId_.exchange(0);
+    if (previous != 0) {
+        client_.removeFeed(previous);
+    }
+    FeedConfig config = FeedConfig::forInstrument(exchange, instrument);
+    config.hotStandby = hotStandby_;
+    activeFeedId_ = client_.addFeed(config);
+}
+
+void LiveFeedSource::resubscribe() {
+    client_.resubscribe(activeFeedId_);
+}
+
+bool LiveFeedSource::isConnected() const {
+    return client_.isConnected();
+}
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,165 @@
+#include "data/orderbook_dispatcher.h"
+#include "utils/latency_histogram.h"
+#include "utils/thread_affinity.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace trade_simulator {
+namespace data {
+
+OrderbookDispatcher::OrderbookDispatcher(std::shared_ptr<OrderbookProcessor> processor,
+                                         const DispatcherConfig& config)
+    : processor_(std::move(processor)),
+      overflowPolicy_(config.overflowPolicy),
+      threadConfig_(config.processingThread),
+      dedicatedThread_(config.dedicatedThread),
+      ring_(config.queueCapacity) {
+}
+
+OrderbookDispatcher::~OrderbookDispatcher() {
+    stop();
+}
+
+void OrderbookDispatcher::start() {
+    if (shouldRun_.exchange(true)) {
+        return; // Already running
+    }
+
+    if (dedicatedThread_) {
+        processingThread_ = std::thread([this]() {
+            runProcessing();
+        });
+    }
+}
+
+void OrderbookDispatcher::stop() {
+    if (!shouldRun_.exchange(false)) {
+        return; // Already stopped
+    }
+
+    if (processingThread_.joinable()) {
+        processingThread_.join();
+    }
+
+    // Drain whatever was left so a restart begins with fresh data
+    while (ring_.front()) {
+        ring_.pop();
+    }
+}
+
+void OrderbookDispatcher::submit(const OrderbookData& data) {
+    // Deltas only make sense in sequence, so only snapshots may be conflated
+    bool conflatable = overflowPolicy_ == OverflowPolicy::ConflateLatest &&
+                       data.update_type == BookUpdateType::Snapshot;
+
+    // An unpublished snapshot is still staged from a previous submit
+    if (hasStagedSnapshot_) {
+        if (conflatable) {
+            conflated_.fetch_add(1, std::memory_order_relaxed);  // Superseded
+        } else if (!publishBlocking()) {
+            return;
+        }
+    }
+
+    // Copy into the preallocated slot; only the occupied levels are copied
+    OrderbookData& slot = ring_.writeSlot();
+    slot = data;
+    slot.trace.enqueuedNs = utils::nowNanoseconds();
+
+    if (!conflatable) {
+        publishBlocking();
+        return;
+    }
+
+    if (ring_.tryPublish()) {
+        hasStagedSnapshot_ = false;
+        onPublished();
+        return;
+    }
+
+    // Keep it in the write slot; the next submit replaces or publishes it
+    hasStagedSnapshot_ = true;
+}
+
+DispatcherStats OrderbookDispatcher::getStats() const {
+    DispatcherStats stats;
+    stats.queueDepth = ring_.size();
+    stats.maxQueueDepth = maxQueueDepth_.load(std::memory_order_relaxed);
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.processed = processed_.load(std::memory_order_relaxed);
+    stats.conflated = conflated_.load(std::memory_order_relaxed);
+    stats.blocked = blocked_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t OrderbookDispatcher::drain(size_t maxSnapshots) {
+    size_t processed = 0;
+    while (processed < maxSnapshots) {
+        OrderbookData* data = ring_.front();
+        if (!data) {
+            break;
+        }
+
+        try {
+            processor_->processOrderbook(*data);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error processing orderbook: " << e.what() << std::endl;
+        }
+
+        ring_.pop();
+        processed_.fetch_add(1, std::memory_order_relaxed);
+        ++processed;
+    }
+    return processed;
+}
+
+void OrderbookDispatcher::runProcessing() {
+    utils::applyThreadConfig(threadConfig_, "processing");
+    int idleSpins = 0;
+
+    while (shouldRun_.load(std::memory_order_relaxed)) {
+        if (drain(1) == 0) {
+            // Spin briefly to keep latency low under load, then back off
+            if (threadConfig_.busyPoll) {
+                utils::cpuRelax();
+            } else if (++idleSpins < kIdleSpinsBeforeSleep) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(kIdleSleepMicros));
+            }
+            continue;
+        }
+        idleSpins = 0;
+    }
+}
+
+bool OrderbookDispatcher::publishBlocking() {
+    if (!ring_.tryPublish()) {
+        // Block until the processing thread frees a slot
+        blocked_.fetch_add(1, std::memory_order_relaxed);
+        while (!ring_.tryPublish()) {
+            if (!shouldRun_.load(std::memory_order_relaxed)) {
+                hasStagedSnapshot_ = true;
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+    hasStagedSnapshot_ = false;
+    onPublished();
+    return true;
+}
+
+void OrderbookDispatcher::onPublished() {
+    published_.fetch_add(1, std::memory_order_relaxed);
+
+    size_t depth = ring_.size();
+    if (depth > maxQueueDepth_.load(std::memory_order_relaxed)) {
+        maxQueueDepth_.store(depth, std::memory_order_relaxed);
+    }
+}
+
+} // namespace data
+} // namespace trade_simulator 
@@ -1,6 +1,6 @@
 #include "data/orderbook_processor.h"
+#include "data/book_kernels.h"
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 #include <iostream>
 
@@ -8,19 +8,86 @@ namespace trade_simulator {
 namespace data {
 
 OrderbookProcessor::OrderbookProcessor(StatsCallback statsCallback, size_t historyWindowSize)
+    : OrderbookProcessor(std::move(statsCallback), VolatilityConfig(historyWindowSize)) {
+}
+
+OrderbookProcessor::OrderbookProcessor(StatsCallback statsCallback, const VolatilityConfig& volatilityConfig)
     : statsCallback_(std::move(statsCallback)),
-      historyWindowSize_(historyWindowSize) {
+      volatility_(volatilityConfig) {
     // Initialize the latestStats with default values
 }
 
+void OrderbookProcessor::setResyncCallback(ResyncCallback callback) {
+    resyncCallback_ = std::move(callback);
+}
+
+void OrderbookProcessor::setLatencyRecorder(utils::PipelineLatency* latency) {
+    latency_ = latency;
+}
+
+void OrderbookProcessor::setQueueTracker(QueueTracker* tracker) {
+    queueTracker_ = tracker;
+}
+
 void OrderbookProcessor::processOrderbook(const OrderbookData& data) {
     auto startTime = std::chrono::steady_clock::now();
+    int64_t startNs = utils::nowNanoseconds();
+    
+    // Stages the update went through before reaching this thread
+    if (latency_) {
+        const LatencyTrace& trace = data.trace;
+        latency_->stage(utils::LatencyStage::SocketRead).recordInterval(trace.readNs, trace.parseStartNs);
+        latency_->stage(utils::LatencyStage::Parse).recordInterval(trace.parseStartNs, trace.parsedNs);
+        latency_->stage(utils::LatencyStage::Enqueue).recordInterval(trace.parsedNs, trace.enqueuedNs);
+        latency_->stage(utils::LatencyStage::Queue).recordInterval(trace.enqueuedNs, startNs);
+        latency_->stage(utils::LatencyStage::Reconnect).recordInterval(trace.disconnectedNs, trace.readNs);
+    }
+
+    // How old the book already was when it arrived, by the exchange's clock; clocks a
+    // little ahead of ours count as no lag
+    int64_t exchangeLagNs = -1;
+    if (data.trace.readWallNs != 0 && data.exchange_time_ns != 0) {
+        exchangeLagNs = std::max<int64_t>(0, data.trace.readWallNs - data.exchange_time_ns);
+        if (latency_) {
+            latency_->stage(utils::LatencyStage::ExchangeLag).record(exchangeLagNs);
+        }
+    }
     
-    // Update the order book history
-    updateHistory(data);
+    // The book and the history belong to this thread; reset() only flags them
+    if (bookResetPending_.exchange(false)) {
+        book_.reset();
+        volatility_.reset();
+        latestStats_.store(OrderbookStats());
+        if (queueTracker_) {
+            queueTracker_->reset();
+        }
+    }
+    
+    // Bring the book up to date; only the changed levels are touched for deltas
+    BookApplyResult result = book_.apply(data);
+    if (result != BookApplyResult::Applied) {
+        if (result == BookApplyResult::SequenceGap) {
+            sequenceGaps_++;
+            requestResync("sequence gap");
+        } else if (result == BookApplyResult::ChecksumMismatch) {
+            checksumMismatches_++;
+            requestResync("checksum mismatch");
+        }
+        return;
+    }
+    
+    // Virtual orders move with the levels this update changed
+    if (queueTracker_) {
+        queueTracker_->apply(data, book_);
+    }
+    
+    // Update the order book history; the fill query cache catches up on its first query
+    updateHistory(book_, data.received_time);
+    depthProfile_.update(book_.asks(), book_.bids(), book_.firstChangedLevel(false),
+                         book_.firstChangedLevel(true));
     
     // Calculate statistics
-    OrderbookStats stats = calculateStats(data);
+    OrderbookStats stats = calculateStats(book_);
     
     // Measure processing time
     auto endTime = std::chrono::steady_clock::now();
@@ -32,20 +99,30 @@ void OrderbookProcessor::processOrderbook(const OrderbookData& data) {
     
     // Store the processing latency in the stats
     stats.processing_latency = std::chrono::microseconds(processingTime);
+    stats.read_ns = data.trace.readNs;
+    stats.exchange_lag_ns = exchangeLagNs;
+    if (latency_) {
+        latency_->stage(utils::LatencyStage::Stats).record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+    }
     
     // Update latest stats
-    {
-        std::lock_guard<std::mutex> lock(statsMutex_);
-        latestStats_ = stats; 
-    }
+    latestStats_.store(stats);
     
     // Notify the callback
     statsCallback_(stats); 
 }
 
+void OrderbookProcessor::reset() {
+    bookResetPending_ = true;
+}
+
 OrderbookStats OrderbookProcessor::getLatestStats() const {
-    std::lock_guard<std::mutex> lock(statsMutex_);
-    return latestStats_;
+    // Statistics from before a reset are stale until the processing thread clears them
+    if (bookResetPending_.load()) {
+        return OrderbookStats();
+    }
+    return latestStats_.load();
 }
 
 double OrderbookProcessor::getAverageLatency() const {
@@ -56,32 +133,41 @@ double OrderbookProcessor::getAverageLatency() const {
     return static_cast<double>(totalProcessingTime_.load()) / updates;
 }
 
-OrderbookStats OrderbookProcessor::calculateStats(const OrderbookData& data) {
+OrderbookStats OrderbookProcessor::calculateStats(const L2Book& book) {
     OrderbookStats stats;
+    const BookSide& askSide = book.asks();
+    const BookSide& bidSide = book.bids();
     
     // Make sure we have bid and ask data
-    if (data.asks.empty() || data.bids.empty()) {
+    if (askSide.empty() || bidSide.empty()) {
         return stats;
     }
     
     // Calculate best bid and ask
-    stats.best_ask = data.asks[0].first;
-    stats.best_bid = data.bids[0].first;
+    stats.best_ask = askSide.prices[0];
+    stats.best_bid = bidSide.prices[0];
+    stats.ask_depth = askSide.size();
+    stats.bid_depth = bidSide.size();
     
     // Calculate mid price and spread
     stats.midprice = (stats.best_ask + stats.best_bid) / 2.0;
     stats.spread = stats.best_ask - stats.best_bid;
     
-    // Calculate weighted prices
-    stats.weighted_ask_price = calculateVWAP(data.asks, 10);
-    stats.weighted_bid_price = calculateVWAP(data.bids, 10);
-    
-    // Calculate total sizes
-    stats.total_ask_size = std::accumulate(data.asks.begin(), data.asks.end(), 0.0,
-        [](double sum, const PriceLevel& level) { return sum + level.second; });
-    
-    stats.total_bid_size = std::accumulate(data.bids.begin(), data.bids.end(), 0.0,
-        [](double sum, const PriceLevel& level) { return sum + level.second; });
+    // Totals are maintained by the book; only the top of each side is summarized,
+    // up to the VWAP levels or the widest depth band, whichever reaches further
+    kernels::SideSummary asks = kernels::summarizeSide(
+        askSide.prices.data(), askSide.sizes.data(), topLevels(askSide, true), kVwapLevels, true);
+    kernels::SideSummary bids = kernels::summarizeSide(
+        bidSide.prices.data(), bidSide.sizes.data(), topLevels(bidSide, false), kVwapLevels, false);
+    
+    stats.weighted_ask_price = asks.topVwap();
+    stats.weighted_bid_price = bids.topVwap();
+    stats.total_ask_size = book.askTotals().size;
+    stats.total_bid_size = book.bidTotals().size;
+    stats.total_ask_notional = book.askTotals().notional;
+    stats.total_bid_notional = book.bidTotals().notional;
+    stats.ask_band_size = asks.bandSize;
+    stats.bid_band_size = bids.bandSize;
     
     // Calculate order imbalance
     if (stats.total_ask_size > 0) {
@@ -94,87 +180,42 @@ OrderbookStats OrderbookProcessor::calculateStats(const OrderbookData& data) {
     return stats;
 }
 
-double OrderbookProcessor::calculateVolatility() const {
-    std::lock_guard<std::mutex> lock(historyMutex_);
-    
-    if (orderbookHistory_.size() < 2) {
-        return 0.0;
-    }
-    
-    // Extract midprices from history
-    std::vector<double> midprices;
-    midprices.reserve(orderbookHistory_.size());
-    
-    for (const auto& orderbook : orderbookHistory_) {
-        if (!orderbook.asks.empty() && !orderbook.bids.empty()) {
-            double bestAsk = orderbook.asks[0].first;
-            double bestBid = orderbook.bids[0].first;
-            double midprice = (bestAsk + bestBid) / 2.0;
-            midprices.push_back(midprice);
-        }
-    }
-    
-    if (midprices.size() < 2) {
-        return 0.0;
-    }
-    
-    // Calculate returns
-    std::vector<double> returns;
-    returns.reserve(midprices.size() - 1);
-    
-    for (size_t i = 1; i < midprices.size(); i++) {
-        double ret = (midprices[i] - midprices[i-1]) / midprices[i-1];
-        returns.push_back(ret);
-    }
-    
-    // Calculate standard deviation of returns
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    
-    double sqSum = std::accumulate(returns.begin(), returns.end(), 0.0,
-        [mean](double sum, double x) {
-            double diff = x - mean;
-            return sum + diff * diff;
-        });
-    
-    double variance = sqSum / returns.size();
-    return std::sqrt(variance);
+size_t OrderbookProcessor::topLevels(const BookSide& side, bool isAsk) {
+    // Same band test as the kernels: (price - best) * direction <= best * bps / 10000
+    double best = side.prices[0];
+    double direction = isAsk ? 1.0 : -1.0;
+    double limit = best * kDepthBandsBps.back() / 10000.0;
+    
+    const double* begin = side.prices.data();
+    const double* end = begin + side.size();
+    const double* bandEnd = std::partition_point(begin, end, [=](double price) {
+        return (price - best) * direction <= limit;
+    });
+    
+    return std::min(side.size(), std::max(kVwapLevels, static_cast<size_t>(bandEnd - begin)));
 }
 
-double OrderbookProcessor::calculateVWAP(const PriceLevels& priceLevels, size_t maxLevels) const {
-    if (priceLevels.empty()) {
-        return 0.0;
-    }
-    
-    size_t levelsToUse = maxLevels > 0 ? std::min(maxLevels, priceLevels.size()) : priceLevels.size();
-    
-    double priceSum = 0.0;
-    double volumeSum = 0.0;
-    
-    for (size_t i = 0; i < levelsToUse; i++) {
-        double price = priceLevels[i].first;
-        double volume = priceLevels[i].second;
-        
-        priceSum += price * volume;
-        volumeSum += volume;
-    }
-    
-    if (volumeSum > 0.0) {
-        return priceSum / volumeSum;
+void OrderbookProcessor::requestResync(const char* reason) {
+    std::cerr << "Orderbook out of sync (" << reason << "), waiting for a snapshot" << std::endl;
+    if (resyncCallback_) {
+        resyncCallback_();
     }
-    
-    return 0.0;
 }
 
-void OrderbookProcessor::updateHistory(const OrderbookData& data) {
-    std::lock_guard<std::mutex> lock(historyMutex_);
+double OrderbookProcessor::calculateVolatility() const {
+    return volatility_.volatility();
+}
+
+void OrderbookProcessor::updateHistory(const L2Book& book,
+                                       std::chrono::steady_clock::time_point receivedTime) {
+    // Books with an empty side have no midprice and do not enter the window
+    if (book.asks().empty() || book.bids().empty()) {
+        return;
+    }
     
-    // Add the new data to history
-    orderbookHistory_.push_back(data);
+    double midprice = (book.asks().prices[0] + book.bids().prices[0]) / 2.0;
     
-    // Remove oldest entries if we exceed the window size
-    while (orderbookHistory_.size() > historyWindowSize_) {
-        orderbookHistory_.pop_front();
-    }
+    volatility_.addMidprice(midprice, receivedTime);
 }
 
 } // namespace data
@@ -0,0 +1,432 @@
+#include "data/queue_tracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+inline size_t hashLevel(bool isBid, double price) {
+    uint64_t bits;
+    std::memcpy(&bits, &price, sizeof(bits));
+    bits ^= isBid ? 0x9e3779b97f4a7c15ULL : 0;
+    return static_cast<size_t>((bits * 0xff51afd7ed558ccdULL) >> 32);
+}
+
+inline bool atTouch(bool isBid, double price, const L2Book& book) {
+    const BookSide& side = isBid ? book.bids() : book.asks();
+    if (side.size() == 0) {
+        return true;
+    }
+    return isBid ? price >= side.prices[0] : price <= side.prices[0];
+}
+
+} // namespace
+
+QueueTracker::QueueTracker(const QueueTrackerConfig& config)
+    : config_(config) {
+    config_.maxOrders = std::max<size_t>(config_.maxOrders, 1);
+    config_.touchTradeShare = std::clamp(config_.touchTradeShare, 0.0, 1.0);
+    rateTauSeconds_ = std::max(config_.rateHalfLifeMs, 1.0) / 1000.0 / std::log(2.0);
+
+    // Every order occupies at most one level, so the table stays at most half full
+    size_t tableSize = 2;
+    while (tableSize < 2 * config_.maxOrders) {
+        tableSize <<= 1;
+    }
+    table_.resize(tableSize);
+    tableMask_ = tableSize - 1;
+    orders_.resize(config_.maxOrders);
+    levels_.resize(config_.maxOrders);
+    activeLevels_.reserve(config_.maxOrders);
+    reset();
+}
+
+VirtualOrderId QueueTracker::place(bool isBid, double price, double size, double queueAhead) {
+    if (freeOrder_ == kNil || size <= 0.0 || !(price > 0.0)) {
+        return kNoVirtualOrder;
+    }
+
+    uint32_t levelIndex = findLevel(isBid, price);
+    if (levelIndex == kNil) {
+        levelIndex = acquireLevel(isBid, price, queueAhead);
+    } else {
+        levels_[levelIndex].size = queueAhead;
+    }
+    Level& level = levels_[levelIndex];
+
+    uint32_t index = freeOrder_;
+    Order& order = orders_[index];
+    freeOrder_ = order.next;
+    order.live = true;
+    order.isBid = isBid;
+    order.price = price;
+    order.size = size;
+    order.filledSize = 0.0;
+    order.queueAhead = std::max(queueAhead, 0.0);
+
+    // Join the back of the queue
+    order.level = levelIndex;
+    order.prev = level.tail;
+    order.next = kNil;
+    if (level.tail != kNil) {
+        orders_[level.tail].next = index;
+    } else {
+        level.head = index;
+    }
+    level.tail = index;
+    ++liveOrders_;
+
+    return (static_cast<VirtualOrderId>(order.generation) << 32) | index;
+}
+
+bool QueueTracker::remove(VirtualOrderId id) {
+    if (!lookup(id)) {
+        return false;
+    }
+    uint32_t index = static_cast<uint32_t>(id);
+    Order& order = orders_[index];
+    uint32_t levelIndex = order.level;
+    if (levelIndex != kNil) {
+        unlink(index);
+        if (levels_[levelIndex].head == kNil) {
+            releaseLevel(levelIndex);
+        }
+    }
+
+    order.live = false;
+    ++order.generation;
+    order.next = freeOrder_;
+    freeOrder_ = index;
+    --liveOrders_;
+    return true;
+}
+
+VirtualOrderState QueueTracker::order(VirtualOrderId id) const {
+    VirtualOrderState state;
+    const Order* order = lookup(id);
+    if (!order) {
+        return state;
+    }
+    state.valid = true;
+    state.isBid = order->isBid;
+    state.filled = order->level == kNil;
+    state.price = order->price;
+    state.size = order->size;
+    state.filledSize = order->filledSize;
+    state.queueAhead = order->queueAhead;
+    return state;
+}
+
+FillForecast QueueTracker::forecast(VirtualOrderId id, double horizonSeconds) const {
+    FillForecast forecast;
+    const Order* order = lookup(id);
+    if (!order) {
+        return forecast;
+    }
+    if (order->level == kNil) {
+        forecast.fillProbability = 1.0;
+        forecast.makerProportion = 1.0;
+        forecast.expectedTimeToFill = 0.0;
+        return forecast;
+    }
+
+    double rest = order->size - order->filledSize;
+    double rate = decayedRate(levels_[order->level], lastUpdateNs_);
+    forecast.queueAhead = order->queueAhead;
+    if (rate > 0.0) {
+        forecast.expectedTimeToFill = (order->queueAhead + rest) / rate;
+        forecast.fillProbability = 1.0 - std::exp(-std::max(horizonSeconds, 0.0) /
+                                                  forecast.expectedTimeToFill);
+    }
+    forecast.makerProportion = (order->filledSize + rest * forecast.fillProbability) / order->size;
+    return forecast;
+}
+
+void QueueTracker::apply(const OrderbookData& update, const L2Book& book) {
+    int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        update.received_time.time_since_epoch()).count();
+
+    if (!activeLevels_.empty()) {
+        if (update.update_type == BookUpdateType::Snapshot) {
+            // Backwards, so a level released by its last fill only moves one already visited
+            for (size_t k = activeLevels_.size(); k-- > 0;) {
+                uint32_t index = activeLevels_[k];
+                const Level& level = levels_[index];
+                updateLevel(index, book.sizeAt(level.isBid, level.price),
+                            atTouch(level.isBid, level.price, book), nowNs);
+            }
+        } else {
+            // Only the changed levels, each one probe of the table
+            for (size_t i = 0; i < update.asks.size(); ++i) {
+                double price = update.asks.prices[i];
+                uint32_t index = findLevel(false, price);
+                if (index != kNil) {
+                    updateLevel(index, update.asks.sizes[i], atTouch(false, price, book), nowNs);
+                }
+            }
+            for (size_t i = 0; i < update.bids.size(); ++i) {
+                double price = update.bids.prices[i];
+                uint32_t index = findLevel(true, price);
+                if (index != kNil) {
+                    updateLevel(index, update.bids.sizes[i], atTouch(true, price, book), nowNs);
+                }
+            }
+        }
+        fillCrossed(book);
+    }
+
+    lastUpdateNs_ = nowNs;
+}
+
+void QueueTracker::reset() {
+    // Bumping the generations invalidates every handle given out
+    freeOrder_ = kNil;
+    for (size_t i = orders_.size(); i-- > 0;) {
+        Order& order = orders_[i];
+        if (order.live) {
+            ++order.generation;
+        }
+        order.live = false;
+        order.level = kNil;
+        order.prev = kNil;
+        order.next = freeOrder_;
+        freeOrder_ = static_cast<uint32_t>(i);
+    }
+    freeLevel_ = kNil;
+    for (size_t i = levels_.size(); i-- > 0;) {
+        levels_[i] = Level();
+        levels_[i].active = freeLevel_;
+        freeLevel_ = static_cast<uint32_t>(i);
+    }
+    std::fill(table_.begin(), table_.end(), kNil);
+    activeLevels_.clear();
+    liveOrders_ = 0;
+    lastUpdateNs_ = 0;
+    highestBid_ = -std::numeric_limits<double>::infinity();
+    lowestAsk_ = std::numeric_limits<double>::infinity();
+}
+
+size_t QueueTracker::findSlot(bool isBid, double price) const {
+    size_t slot = hashLevel(isBid, price) & tableMask_;
+    while (table_[slot] != kNil) {
+        const Level& level = levels_[table_[slot]];
+        if (level.price == price && level.isBid == isBid) {
+            break;
+        }
+        slot = (slot + 1) & tableMask_;
+    }
+    return slot;
+}
+
+uint32_t QueueTracker::findLevel(bool isBid, double price) const {
+    return table_[findSlot(isBid, price)];
+}
+
+uint32_t QueueTracker::acquireLevel(bool isBid, double price, double size) {
+    uint32_t index = freeLevel_;
+    Level& level = levels_[index];
+    freeLevel_ = level.active;
+
+    level = Level();
+    level.isBid = isBid;
+    level.price = price;
+    level.size = size;
+    level.rateNs = lastUpdateNs_;
+    level.active = static_cast<uint32_t>(activeLevels_.size());
+    activeLevels_.push_back(index);
+    table_[findSlot(isBid, price)] = index;
+
+    if (isBid) {
+        highestBid_ = std::max(highestBid_, price);
+    } else {
+        lowestAsk_ = std::min(lowestAsk_, price);
+    }
+    return index;
+}
+
+void QueueTracker::releaseLevel(uint32_t index) {
+    Level& level = levels_[index];
+
+    // Backward-shift deletion keeps every probe sequence unbroken without tombstones
+    size_t hole = findSlot(level.isBid, level.price);
+    size_t slot = hole;
+    while (true) {
+        slot = (slot + 1) & tableMask_;
+        uint32_t candidate = table_[slot];
+        if (candidate == kNil) {
+            break;
+        }
+        size_t home = hashLevel(levels_[candidate].isBid, levels_[candidate].price) & tableMask_;
+        // Move the entry into the hole unless its home lies cyclically in (hole, slot]
+        bool stays = hole <= slot ? (home > hole && home <= slot) : (home > hole || home <= slot);
+        if (!stays) {
+            table_[hole] = candidate;
+            hole = slot;
+        }
+    }
+    table_[hole] = kNil;
+
+    // Swap-remove from the active levels
+    uint32_t position = level.active;
+    uint32_t last = activeLevels_.back();
+    activeLevels_[position] = last;
+    levels_[last].active = position;
+    activeLevels_.pop_back();
+
+    bool wasBest = level.isBid ? level.price == highestBid_ : level.price == lowestAsk_;
+    level.active = freeLevel_;
+    freeLevel_ = index;
+    if (wasBest) {
+        recomputeBestPrices();
+    }
+}
+
+void QueueTracker::unlink(uint32_t index) {
+    Order& order = orders_[index];
+    Level& level = levels_[order.level];
+    if (order.prev != kNil) {
+        orders_[order.prev].next = order.next;
+    } else {
+        level.head = order.next;
+    }
+    if (order.next != kNil) {
+        orders_[order.next].prev = order.prev;
+    } else {
+        level.tail = order.prev;
+    }
+    order.level = kNil;
+    order.prev = kNil;
+    order.next = kNil;
+}
+
+void QueueTracker::updateLevel(uint32_t index, double size, bool atTouch, int64_t nowNs) {
+    Level& level = levels_[index];
+    double previous = level.size;
+    level.size = size;
+    if (size >= previous) {
+        return;  // Additions join behind every order
+    }
+
+    double decrease = previous - size;
+    level.rate = decayedRate(level, nowNs) + decrease / rateTauSeconds_;
+    level.rateNs = nowNs;
+    double traded = atTouch ? decrease * config_.touchTradeShare : 0.0;
+    double cancelled = decrease - traded;
+
+    for (uint32_t i = level.head; i != kNil;) {
+        Order& order = orders_[i];
+        uint32_t next = order.next;
+
+        double ahead = order.queueAhead;
+        double behind = std::max(previous - ahead, 0.0);
+        double rest = order.size - order.filledSize;
+
+        // Trades take the front of the queue, then the order, then the size behind it
+        double tradedAhead = std::min(ahead, traded);
+        double fill = std::min(rest, traded - tradedAhead);
+        ahead -= tradedAhead;
+        behind = std::max(behind - (traded - tradedAhead - fill), 0.0);
+
+        // Cancels fall ahead of the order in proportion to the weight of the queue there
+        double weightAhead = queueWeight(ahead);
+        double weightBehind = queueWeight(behind);
+        if (weightAhead + weightBehind > 0.0) {
+            ahead -= cancelled * weightAhead / (weightAhead + weightBehind);
+        }
+        order.queueAhead = std::clamp(ahead, 0.0, size);
+
+        if (fill >= rest) {
+            completeOrder(i);
+        } else {
+            order.filledSize += fill;
+        }
+        i = next;
+    }
+
+    if (level.head == kNil) {
+        releaseLevel(index);
+    }
+}
+
+void QueueTracker::fillCrossed(const L2Book& book) {
+    double bestAsk = book.asks().size() > 0 ? book.asks().prices[0]
+                                            : std::numeric_limits<double>::infinity();
+    double bestBid = book.bids().size() > 0 ? book.bids().prices[0]
+                                            : -std::numeric_limits<double>::infinity();
+    if (bestAsk > highestBid_ && bestBid < lowestAsk_) {
+        return;  // Nothing tracked was traded through
+    }
+
+    for (size_t k = activeLevels_.size(); k-- > 0;) {
+        uint32_t index = activeLevels_[k];
+        const Level& level = levels_[index];
+        bool crossed = level.isBid ? level.price >= bestAsk : level.price <= bestBid;
+        if (!crossed) {
+            continue;
+        }
+        while (level.head != kNil) {
+            completeOrder(level.head);
+        }
+        releaseLevel(index);
+    }
+}
+
+void QueueTracker::completeOrder(uint32_t index) {
+    Order& order = orders_[index];
+    unlink(index);
+    order.filledSize = order.size;
+    order.queueAhead = 0.0;
+}
+
+void QueueTracker::recomputeBestPrices() {
+    highestBid_ = -std::numeric_limits<double>::infinity();
+    lowestAsk_ = std::numeric_limits<double>::infinity();
+    for (uint32_t index : activeLevels_) {
+        const Level& level = levels_[index];
+        if (level.isBid) {
+            highestBid_ = std::max(highestBid_, level.price);
+        } else {
+            lowestAsk_ = std::min(lowestAsk_, level.price);
+        }
+    }
+}
+
+double QueueTracker::queueWeight(double size) const {
+    // The common powers without a call to pow
+    if (config_.cancelPower == 1.0) {
+        return size;
+    }
+    if (config_.cancelPower == 2.0) {
+        return size * size;
+    }
+    return std::pow(size, config_.cancelPower);
+}
+
+double QueueTracker::decayedRate(const Level& level, int64_t nowNs) const {
+    if (nowNs <= level.rateNs) {
+        return level.rate;
+    }
+    double elapsed = static_cast<double>(nowNs - level.rateNs) * 1e-9;
+    return level.rate * std::exp(-elapsed / rateTauSeconds_);
+}
+
+const QueueTracker::Order* QueueTracker::lookup(VirtualOrderId id) const {
+    uint32_t index = static_cast<uint32_t>(id);
+    if (id == kNoVirtualOrder || index >= orders_.size()) {
+        return nullptr;
+    }
+    const Order& order = orders_[index];
+    if (!order.live || order.generation != static_cast<uint32_t>(id >> 32)) {
+        return nullptr;
+    }
+    return &order;
+}
+
+} // namespace data
+} // namespace trade_simulator
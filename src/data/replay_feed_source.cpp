@@ -0,0 +1,194 @@
+#include "data/replay_feed_source.h"
+#include "utils/latency_histogram.h"
+#include "utils/thread_affinity.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+namespace trade_simulator {
+namespace data {
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+} // namespace
+
+ReplayFeedSource::ReplayFeedSource(OrderbookCallback callback, const ReplayConfig& config)
+    : callback_(std::move(callback)),
+      config_(config) {
+    if (BookStoreReader::isBookStore(config.path)) {
+        storeReader_ = std::make_unique<BookStoreReader>(config.path);
+    } else {
+        logReader_ = std::make_unique<FeedLogReader>(config.path);
+    }
+}
+
+ReplayFeedSource::~ReplayFeedSource() {
+    stop();
+}
+
+void ReplayFeedSource::start() {
+    if (shouldRun_.exchange(true)) {
+        return; // Already running
+    }
+
+    if (storeReader_) {
+        storeReader_->rewind();
+    } else {
+        logReader_->rewind();
+    }
+    finished_ = false;
+    replayedMessages_ = 0;
+
+    replayThread_ = std::thread([this]() {
+        runReplay();
+    });
+}
+
+void ReplayFeedSource::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        if (!shouldRun_.exchange(false)) {
+            return; // Already stopped
+        }
+    }
+    wakeCondition_.notify_all();
+
+    if (replayThread_.joinable()) {
+        replayThread_.join();
+    }
+}
+
+void ReplayFeedSource::selectInstrument(const std::string& exchange, const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(selectionMutex_);
+    exchange_ = exchange;
+    instrument_ = instrument;
+    selectionVersion_++;
+}
+
+void ReplayFeedSource::resubscribe() {
+    std::cerr << "Replay book out of sync; waiting for the next snapshot in the log" << std::endl;
+}
+
+bool ReplayFeedSource::isConnected() const {
+    return shouldRun_ && !finished_;
+}
+
+void ReplayFeedSource::runReplay() {
+    utils::ThreadConfig threadConfig;
+    threadConfig.cpu = config_.cpu;
+    utils::applyThreadConfig(threadConfig, "replay");
+
+    OrderbookData orderbook;
+
+    std::string exchange;
+    SymbolId instrument = kNoSymbol;
+    uint64_t seenSelection = ~uint64_t(0);
+
+    bool paced = config_.mode == ReplayMode::RealTime && config_.speed > 0.0;
+    bool haveFirst = false;
+    std::chrono::steady_clock::time_point firstRecordTime;
+    std::chrono::steady_clock::time_point wallStart;
+
+    while (shouldRun_.load(std::memory_order_relaxed)) {
+        bool more;
+        try {
+            more = readNext(orderbook);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error replaying message: " << e.what() << std::endl;
+            if (storeReader_) {
+                break;  // A corrupt block cannot be skipped reliably
+            }
+            continue;
+        }
+        if (!more) {
+            break;
+        }
+
+        if (paced) {
+            if (!haveFirst) {
+                haveFirst = true;
+                firstRecordTime = orderbook.received_time;
+                wallStart = std::chrono::steady_clock::now();
+            }
+            auto offset = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                (orderbook.received_time - firstRecordTime) / config_.speed);
+            if (!waitUntil(wallStart + offset)) {
+                break;
+            }
+
+            // Move the stamps past the pacing wait, which is not pipeline latency
+            int64_t waitedNs = utils::nowNanoseconds() - orderbook.trace.parsedNs;
+            orderbook.trace.readNs += waitedNs;
+            orderbook.trace.parseStartNs += waitedNs;
+            orderbook.trace.parsedNs += waitedNs;
+        }
+
+        if (selectionVersion_.load(std::memory_order_acquire) != seenSelection) {
+            std::lock_guard<std::mutex> lock(selectionMutex_);
+            exchange = exchange_;
+            instrument = internSymbol(instrument_);
+            seenSelection = selectionVersion_.load(std::memory_order_relaxed);
+        }
+
+        if (instrument != kNoSymbol &&
+            (orderbook.symbol != instrument || !equalsIgnoreCase(symbolName(orderbook.exchange), exchange))) {
+            continue;
+        }
+
+        callback_(orderbook);
+        replayedMessages_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (shouldRun_) {
+        finished_ = true;
+        std::cerr << "Replay of " << config_.path << " finished after "
+                  << replayedMessages_ << " messages" << std::endl;
+    }
+}
+
+bool ReplayFeedSource::readNext(OrderbookData& orderbook) {
+    int64_t readNs = utils::nowNanoseconds();
+    if (storeReader_) {
+        // Decoding the columns stands in for parsing
+        if (!storeReader_->next(orderbook)) {
+            return false;
+        }
+        orderbook.trace.readNs = readNs;
+        orderbook.trace.parseStartNs = readNs;
+        orderbook.trace.parsedNs = utils::nowNanoseconds();
+        return true;
+    }
+
+    FeedLogRecord record;
+    do {
+        if (!logReader_->next(record)) {
+            return false;
+        }
+        orderbook.trace.parseStartNs = utils::nowNanoseconds();
+    } while (decoder_.decode(record.message, orderbook) == DecodeResult::Ignored);
+    orderbook.trace.readNs = readNs;
+    orderbook.trace.parsedNs = utils::nowNanoseconds();
+
+    // The recorded receive time keeps time-based statistics identical across runs
+    orderbook.received_time = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(record.receivedTime));
+    return true;
+}
+
+bool ReplayFeedSource::waitUntil(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wakeCondition_.wait_until(lock, deadline, [this]() { return !shouldRun_.load(); });
+    return shouldRun_.load();
+}
+
+} // namespace data
+} // namespace trade_simulator 
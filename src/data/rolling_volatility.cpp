@@ -0,0 +1,126 @@
+#include "data/rolling_volatility.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trade_simulator {
+namespace data {
+
+RollingVolatility::RollingVolatility(const VolatilityConfig& config)
+    : config_(config) {
+    // A window of N midprices holds N - 1 returns
+    size_t capacity = config_.windowSize > 1 ? config_.windowSize - 1 : 1;
+    returns_.assign(capacity, 0.0);
+    times_.assign(capacity, TimePoint());
+}
+
+void RollingVolatility::addMidprice(double midprice, TimePoint time) {
+    if (midprice <= 0.0) {
+        return;
+    }
+
+    if (lastMidprice_ > 0.0) {
+        double ret = (midprice - lastMidprice_) / lastMidprice_;
+
+        if (config_.method == VolatilityMethod::Ewma) {
+            // Seed with the first squared return, then decay
+            ewmaVariance_ = ewmaCount_ == 0
+                ? ret * ret
+                : config_.ewmaLambda * ewmaVariance_ + (1.0 - config_.ewmaLambda) * ret * ret;
+            ++ewmaCount_;
+        } else {
+            push(ret, time);
+        }
+    }
+    lastMidprice_ = midprice;
+
+    // Drop returns that fell out of the time window
+    if (config_.timeWindow.count() > 0) {
+        while (size_ > 0 && time - times_[head_] > config_.timeWindow) {
+            popOldest();
+        }
+    }
+}
+
+double RollingVolatility::volatility() const {
+    if (config_.method == VolatilityMethod::Ewma) {
+        return std::sqrt(ewmaVariance_);
+    }
+
+    if (size_ == 0) {
+        return 0.0;
+    }
+
+    // Clamp tiny negative values left by rounding
+    return std::sqrt(std::max(0.0, m2_ / static_cast<double>(size_)));
+}
+
+size_t RollingVolatility::count() const {
+    return config_.method == VolatilityMethod::Ewma ? ewmaCount_ : size_;
+}
+
+void RollingVolatility::reset() {
+    head_ = 0;
+    size_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+    updatesSinceRecompute_ = 0;
+    ewmaVariance_ = 0.0;
+    ewmaCount_ = 0;
+    lastMidprice_ = 0.0;
+}
+
+void RollingVolatility::push(double ret, TimePoint time) {
+    if (size_ == returns_.size()) {
+        popOldest();
+    }
+
+    size_t index = (head_ + size_) % returns_.size();
+    returns_[index] = ret;
+    times_[index] = time;
+    ++size_;
+
+    double delta = ret - mean_;
+    mean_ += delta / static_cast<double>(size_);
+    m2_ += delta * (ret - mean_);
+
+    if (++updatesSinceRecompute_ >= returns_.size()) {
+        recompute();
+    }
+}
+
+void RollingVolatility::popOldest() {
+    double ret = returns_[head_];
+    head_ = (head_ + 1) % returns_.size();
+    --size_;
+
+    if (size_ == 0) {
+        mean_ = 0.0;
+        m2_ = 0.0;
+        return;
+    }
+
+    double delta = ret - mean_;
+    mean_ -= delta / static_cast<double>(size_);
+    m2_ -= delta * (ret - mean_);
+}
+
+void RollingVolatility::recompute() {
+    updatesSinceRecompute_ = 0;
+
+    double sum = 0.0;
+    for (size_t i = 0; i < size_; ++i) {
+        sum += returns_[(head_ + i) % returns_.size()];
+    }
+    mean_ = size_ > 0 ? sum / static_cast<double>(size_) : 0.0;
+
+    double sqSum = 0.0;
+    for (size_t i = 0; i < size_; ++i) {
+        double diff = returns_[(head_ + i) % returns_.size()] - mean_;
+        sqSum += diff * diff;
+    }
+    m2_ = sqSum;
+}
+
+} // namespace data
+} // namespace trade_simulator 
@@ -0,0 +1,88 @@
+#include "data/symbol_table.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace trade_simulator {
+namespace data {
+
+SymbolTable& SymbolTable::instance() {
+    // Static storage: the names never come from the heap
+    static SymbolTable table;
+    return table;
+}
+
+SymbolId SymbolTable::intern(std::string_view name) {
+    if (name.empty()) {
+        return kNoSymbol;
+    }
+
+    size_t slot = 0;
+    SymbolId id = probe(name, slot);
+    if (id != kNoSymbol) {
+        return id;
+    }
+
+    if (name.size() > kMaxNameLength) {
+        throw std::runtime_error("Symbol name too long: " + std::string(name));
+    }
+
+    std::lock_guard<std::mutex> lock(insertMutex_);
+    // Another thread may have added it, or taken our free slot, since the probe
+    id = probe(name, slot);
+    if (id != kNoSymbol) {
+        return id;
+    }
+    size_t next = count_.load(std::memory_order_relaxed);
+    if (next >= kCapacity) {
+        throw std::runtime_error("Symbol table full");
+    }
+
+    Name& entry = names_[next];
+    std::copy(name.begin(), name.end(), entry.chars.begin());
+    entry.length = static_cast<uint8_t>(name.size());
+    id = static_cast<SymbolId>(next);
+    count_.store(next + 1, std::memory_order_release);
+    slots_[slot].store(id, std::memory_order_release);
+    return id;
+}
+
+SymbolId SymbolTable::find(std::string_view name) const {
+    size_t slot = 0;
+    return name.empty() ? kNoSymbol : probe(name, slot);
+}
+
+std::string_view SymbolTable::name(SymbolId id) const {
+    if (id == kNoSymbol || id >= count_.load(std::memory_order_acquire)) {
+        return std::string_view();
+    }
+    const Name& entry = names_[id];
+    return std::string_view(entry.chars.data(), entry.length);
+}
+
+size_t SymbolTable::hash(std::string_view name) {
+    // FNV-1a
+    uint64_t value = 14695981039346656037ull;
+    for (char c : name) {
+        value ^= static_cast<unsigned char>(c);
+        value *= 1099511628211ull;
+    }
+    return static_cast<size_t>(value);
+}
+
+SymbolId SymbolTable::probe(std::string_view name, size_t& slot) const {
+    for (slot = hash(name) & (kSlots - 1);; slot = (slot + 1) & (kSlots - 1)) {
+        SymbolId id = slots_[slot].load(std::memory_order_acquire);
+        if (id == kNoSymbol) {
+            return kNoSymbol;
+        }
+        const Name& entry = names_[id];
+        if (std::string_view(entry.chars.data(), entry.length) == name) {
+            return id;
+        }
+    }
+}
+
+} // namespace data
+} // namespace trade_simulator
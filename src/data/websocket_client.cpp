@@ -1,46 +1,764 @@
 #include "data/websocket_client.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <iostream>
+#include <random>
 #include <string>
 #include <chrono>
 #include <thread>
-#include <nlohmann/json.hpp>
+#include <string_view>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
-#include <boost/asio/connect.hpp>
-#include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/ssl/stream.hpp>
+#include <boost/beast/zlib.hpp>
 
-using json = nlohmann::json;
+#include "utils/latency_histogram.h"
+#include "utils/timestamp.h"
 
 namespace trade_simulator {
 namespace data {
 
-WebSocketClient::WebSocketClient(OrderbookCallback callback)
+namespace {
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+} // namespace
+
+FeedConfig FeedConfig::forInstrument(const std::string& exchange, const std::string& instrument) {
+    std::optional<Venue> venue = parseVenue(exchange);
+    if (venue && *venue != Venue::GoQuant && *venue != Venue::Okx) {
+        return forVenue(*venue, instrument);
+    }
+
+    FeedConfig config;
+    config.target = "/ws/l2-orderbook/" + toLower(exchange) + "/" + instrument;
+    return config;
+}
+
+FeedConfig FeedConfig::forVenue(Venue venue, const std::string& instrument) {
+    FeedConfig config;
+    config.venue = venue;
+    config.spec = defaultInstrumentSpec(venue, instrument);
+
+    switch (venue) {
+        case Venue::GoQuant:
+            config.target = "/ws/l2-orderbook/okx/" + instrument;
+            break;
+        case Venue::Okx:
+            config.host = "ws.okx.com";
+            config.port = "8443";
+            config.target = "/ws/v5/public";
+            config.subscription = R"({"op":"subscribe","args":[{"channel":"books","instId":")" +
+                                  instrument + R"("}]})";
+            // OKX drops connections without a message for 30 s and answers "pong"
+            config.heartbeat = "ping";
+            config.heartbeatIntervalMs = 20000;
+            break;
+        case Venue::Binance:
+            // Top 20 levels every 100 ms; the stream name is part of the path
+            config.host = "fstream.binance.com";
+            config.target = "/ws/" + toLower(instrument) + "@depth20@100ms";
+            break;
+        case Venue::Bybit:
+            config.host = "stream.bybit.com";
+            config.target = "/v5/public/linear";
+            config.subscription = R"({"op":"subscribe","args":["orderbook.50.)" + instrument + R"("]})";
+            // Bybit expects a ping every 20 s
+            config.heartbeat = R"({"op":"ping"})";
+            config.heartbeatIntervalMs = 20000;
+            break;
+        case Venue::Deribit:
+            config.host = "www.deribit.com";
+            config.target = "/ws/api/v2";
+            config.subscription =
+                R"({"jsonrpc":"2.0","method":"public/subscribe","id":1,"params":{"channels":["book.)" +
+                instrument + R"(.100ms"]}})";
+            break;
+    }
+    return config;
+}
+
+/**
+ * @brief Chooses which connection of a feed delivers its books
+ *
+ * A feed with a hot standby reads and decodes on both connections, but only the active
+ * one is delivered. When the active connection drops, the standby takes over with its
+ * next book; a delta already delivered from the other connection is skipped. The time
+ * from losing the active connection to the next book delivered is stamped on that book
+ * for the reconnect latency histogram, with or without a standby. Sessions deliver under
+ * the arbiter's lock, so the callback still sees one book at a time per feed.
+ */
+class WebSocketClient::FeedArbiter {
+public:
+    static constexpr size_t kMaxConnections = 2;
+
+    explicit FeedArbiter(size_t connections) : connections_(connections) {}
+
+    /**
+     * @brief Check whether a connection is the one delivering books
+     * @param connection Index of the connection; 0 is the primary
+     * @return True if its books are delivered
+     */
+    bool isActive(size_t connection) const {
+        return active_.load(std::memory_order_relaxed) == connection;
+    }
+
+    /**
+     * @brief Note that a connection came up or went down, failing over if it was active
+     * @param connection Index of the connection
+     * @param connected Whether the connection is now up
+     */
+    void setConnected(size_t connection, bool connected) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool wasConnected = connected_[connection];
+        connected_[connection] = connected;
+        if (connected || !wasConnected || connection != active_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        if (disconnectedNs_ == 0) {
+            disconnectedNs_ = utils::nowNanoseconds();
+        }
+        for (size_t other = 0; other < connections_; ++other) {
+            if (connected_[other]) {
+                active_.store(other, std::memory_order_relaxed);
+                std::cerr << "Failing over to connection " << other << std::endl;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Deliver a book from a connection, unless another connection is delivering
+     * @param connection Index of the connection the book came from
+     * @param book Decoded book; its trace gets the time the feed was lost, if it was
+     * @param callback Invoked with the lock held if the book is delivered
+     */
+    template <typename Callback>
+    void deliver(size_t connection, OrderbookData& book, Callback&& callback) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (connection != active_.load(std::memory_order_relaxed)) {
+            if (connected_[active_.load(std::memory_order_relaxed)]) {
+                return;  // Standby while the active connection is up
+            }
+            active_.store(connection, std::memory_order_relaxed);
+        }
+
+        if (book.seq_id >= 0) {
+            if (connections_ > 1 && book.update_type == BookUpdateType::Delta &&
+                book.seq_id <= lastSeqId_) {
+                return;  // Already delivered from the other connection
+            }
+            lastSeqId_ = book.seq_id;
+        }
+
+        book.trace.disconnectedNs = disconnectedNs_;
+        disconnectedNs_ = 0;
+        callback();
+    }
+
+private:
+    size_t connections_;
+    std::mutex mutex_;
+    std::atomic<size_t> active_{0};
+    std::array<bool, kMaxConnections> connected_{};
+    int64_t lastSeqId_ = -1;
+    int64_t disconnectedNs_ = 0;
+};
+
+/**
+ * @brief Connection of one feed: resolve, TCP connect, TLS and WebSocket handshakes,
+ *        the venue's subscription if it needs one, then an async_read loop, reconnecting
+ *        with jittered exponential backoff on failure
+ *
+ * Reconnects skip most of the setup cost: the resolved addresses are cached and
+ * refreshed in the background, and the TLS session of the previous connection is offered
+ * for resumption, which saves a round trip and the key exchange when the server accepts.
+ *
+ * All handlers run on the session's strand. The session keeps itself alive through the
+ * shared_ptr bound into its pending handlers and goes away once it is stopped and the
+ * last handler has completed.
+ */
+class WebSocketClient::FeedSession : public std::enable_shared_from_this<FeedSession> {
+public:
+    using Stream = websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+
+    FeedSession(net::io_context& ioc, ssl::context& sslContext, FeedId feedId,
+                FeedConfig config, const OrderbookCallback& callback,
+                const RawMessageCallback& rawMessageCallback,
+                std::shared_ptr<FeedArbiter> arbiter, size_t connection)
+        : strand_(net::make_strand(ioc)),
+          sslContext_(sslContext),
+          resolver_(strand_),
+          timer_(strand_),
+          heartbeatTimer_(strand_),
+          feedId_(feedId),
+          config_(std::move(config)),
+          callback_(callback),
+          rawMessageCallback_(rawMessageCallback),
+          arbiter_(std::move(arbiter)),
+          connection_(connection),
+          label_(config_.target + (connection_ > 0 ? " (standby)" : "")),
+          backoffRandom_(static_cast<std::minstd_rand::result_type>(
+              utils::nowNanoseconds() ^ (static_cast<int64_t>(feedId) << 8 | static_cast<int64_t>(connection)))),
+          lastMessageNs_(utils::nowNanoseconds()),
+          tlsSession_(nullptr, &SSL_SESSION_free),
+          decoder_(config_.venue, config_.spec) {
+        // Size the read buffer up front so steady-state ingest does not allocate
+        readBuffer_.reserve(kInitialReadBufferBytes);
+        if (config_.binaryFrames != FrameCompression::None) {
+            inflated_.reserve(kInitialReadBufferBytes);
+        }
+    }
+
+    /**
+     * @brief Start connecting
+     */
+    void start() {
+        net::post(strand_, [self = shared_from_this()]() {
+            self->doResolve();
+        });
+    }
+
+    /**
+     * @brief Close the connection and stop reconnecting
+     */
+    void stop() {
+        net::post(strand_, [self = shared_from_this()]() {
+            self->stopped_ = true;
+            self->timer_.cancel();
+            self->heartbeatTimer_.cancel();
+            self->resolver_.cancel();
+
+            if (!self->ws_) {
+                return;
+            }
+
+            if (self->isConnected_) {
+                // Close gracefully, but do not let an unresponsive server hold up shutdown
+                self->timer_.expires_after(std::chrono::milliseconds(kCloseTimeoutMs));
+                self->timer_.async_wait([self](beast::error_code ec) {
+                    if (!ec && self->ws_) {
+                        beast::get_lowest_layer(*self->ws_).cancel();
+                    }
+                });
+                self->ws_->async_close(websocket::close_code::normal,
+                    [self](beast::error_code) {
+                        self->timer_.cancel();
+                        self->isConnected_ = false;
+                    });
+            } else {
+                beast::get_lowest_layer(*self->ws_).cancel();
+            }
+        });
+    }
+
+    /**
+     * @brief Drop the connection and reconnect without backoff
+     */
+    void resync() {
+        net::post(strand_, [self = shared_from_this()]() {
+            if (self->stopped_ || !self->isConnected_ || !self->ws_) {
+                return;
+            }
+            self->resyncRequested_ = true;
+            beast::get_lowest_layer(*self->ws_).cancel();
+        });
+    }
+
+    bool isConnected() const {
+        return isConnected_;
+    }
+
+    bool isHealthy(std::chrono::nanoseconds maxIdle) const {
+        return isConnected_ && utils::nowNanoseconds() - lastMessageNs() < maxIdle.count();
+    }
+
+    int64_t lastMessageNs() const {
+        return lastMessageNs_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int kConnectTimeoutSeconds = 30;
+    static constexpr int kCloseTimeoutMs = 2000;
+    static constexpr size_t kMaxInflatedMessageSize = 16 * 1024 * 1024;  // Bound on a hostile feed
+
+    net::strand<net::io_context::executor_type> strand_;
+    ssl::context& sslContext_;
+    tcp::resolver resolver_;
+    net::steady_timer timer_;
+    net::steady_timer heartbeatTimer_;
+    std::optional<Stream> ws_;
+
+    FeedId feedId_;
+    FeedConfig config_;
+    const OrderbookCallback& callback_;
+    const RawMessageCallback& rawMessageCallback_;
+    std::shared_ptr<FeedArbiter> arbiter_;
+    size_t connection_;
+    std::string label_;
+
+    // Connection state
+    std::atomic<bool> isConnected_{false};
+    bool stopped_{false};
+    bool resyncRequested_{false};
+    int failedAttempts_{0};
+    std::minstd_rand backoffRandom_;
+    std::atomic<int64_t> lastMessageNs_;  // utils::nowNanoseconds() of the last read
+
+    // Reconnect shortcuts: resolved addresses and the last TLS session
+    tcp::resolver::results_type endpoints_;
+    std::chrono::steady_clock::time_point resolvedAt_;
+    bool refreshingEndpoints_{false};
+    std::unique_ptr<SSL_SESSION, decltype(&SSL_SESSION_free)> tlsSession_;
+    bool tlsSessionSaved_{false};
+
+    // Receive path state, reused across messages so steady-state reads do not allocate
+    beast::flat_buffer readBuffer_;
+    beast::zlib::inflate_stream inflater_;
+    std::string inflated_;
+    FeedDecoder decoder_;
+    OrderbookData orderbook_;
+
+    void doResolve() {
+        if (stopped_) {
+            return;
+        }
+
+        // A fresh stream per attempt; TLS state cannot be reused after a failure
+        ws_.emplace(strand_, sslContext_);
+        tlsSessionSaved_ = false;
+
+        if (!endpoints_.empty()) {
+            if (std::chrono::steady_clock::now() - resolvedAt_ >= std::chrono::seconds(config_.dnsRefreshSeconds)) {
+                refreshEndpoints();
+            }
+            return doConnect();
+        }
+
+        resolver_.async_resolve(config_.host, config_.port,
+            beast::bind_front_handler(&FeedSession::onResolve, shared_from_this()));
+    }
+
+    void onResolve(beast::error_code ec, tcp::resolver::results_type results) {
+        if (ec) {
+            return fail(ec, "resolve");
+        }
+
+        endpoints_ = std::move(results);
+        resolvedAt_ = std::chrono::steady_clock::now();
+        doConnect();
+    }
+
+    /**
+     * @brief Resolve the host again without holding up the connection, which uses the
+     *        cached addresses meanwhile
+     */
+    void refreshEndpoints() {
+        if (refreshingEndpoints_) {
+            return;
+        }
+        refreshingEndpoints_ = true;
+        resolver_.async_resolve(config_.host, config_.port,
+            [self = shared_from_this()](beast::error_code ec, tcp::resolver::results_type results) {
+                self->refreshingEndpoints_ = false;
+                if (!ec && !results.empty()) {
+                    self->endpoints_ = std::move(results);
+                    self->resolvedAt_ = std::chrono::steady_clock::now();
+                }
+            });
+    }
+
+    void doConnect() {
+        beast::get_lowest_layer(*ws_).expires_after(std::chrono::seconds(kConnectTimeoutSeconds));
+        beast::get_lowest_layer(*ws_).async_connect(endpoints_,
+            beast::bind_front_handler(&FeedSession::onConnect, shared_from_this()));
+    }
+
+    void onConnect(beast::error_code ec, tcp::resolver::results_type::endpoint_type) {
+        if (ec) {
+            // The addresses may have moved; resolve again on the next attempt
+            endpoints_ = tcp::resolver::results_type();
+            return fail(ec, "connect");
+        }
+
+        // Set SNI Hostname (many hosts need this to handshake successfully)
+        if (!SSL_set_tlsext_host_name(ws_->next_layer().native_handle(), config_.host.c_str())) {
+            ec = beast::error_code(static_cast<int>(::ERR_get_error()), net::error::get_ssl_category());
+            return fail(ec, "SNI");
+        }
+
+        // Offer the previous connection's session; the server falls back to a full
+        // handshake if it no longer knows it
+        if (tlsSession_ && !SSL_set_session(ws_->next_layer().native_handle(), tlsSession_.get())) {
+            tlsSession_.reset();
+        }
+
+        ws_->next_layer().async_handshake(ssl::stream_base::client,
+            beast::bind_front_handler(&FeedSession::onSslHandshake, shared_from_this()));
+    }
+
+    void onSslHandshake(beast::error_code ec) {
+        if (ec) {
+            return fail(ec, "SSL handshake");
+        }
+        saveTlsSession();
+
+        // The websocket stream manages its own timeouts from here on; with an idle timeout
+        // it pings a quiet server and drops the connection if nothing comes back
+        beast::get_lowest_layer(*ws_).expires_never();
+        websocket::stream_base::timeout timeouts =
+            websocket::stream_base::timeout::suggested(beast::role_type::client);
+        if (config_.idleTimeoutMs > 0) {
+            timeouts.idle_timeout = std::chrono::milliseconds(config_.idleTimeoutMs);
+            timeouts.keep_alive_pings = true;
+        }
+        ws_->set_option(timeouts);
+        if (config_.permessageDeflate) {
+            websocket::permessage_deflate deflate;
+            deflate.client_enable = true;
+            ws_->set_option(deflate);
+        }
+
+        ws_->async_handshake(config_.host, config_.target,
+            beast::bind_front_handler(&FeedSession::onHandshake, shared_from_this()));
+    }
+
+    void onHandshake(beast::error_code ec) {
+        if (ec) {
+            return fail(ec, "WebSocket handshake");
+        }
+
+        isConnected_ = true;
+        arbiter_->setConnected(connection_, true);
+
+        bool resumed = SSL_session_reused(ws_->next_layer().native_handle()) == 1;
+        std::cerr << "Connected to WebSocket server: " << config_.host << label_
+                  << (resumed ? " (TLS session resumed)" : "") << std::endl;
+
+        if (config_.subscription.empty()) {
+            scheduleHeartbeat();
+            doRead();
+            return;
+        }
+        ws_->text(true);
+        ws_->async_write(net::buffer(config_.subscription),
+            beast::bind_front_handler(&FeedSession::onSubscribe, shared_from_this()));
+    }
+
+    void onSubscribe(beast::error_code ec, std::size_t) {
+        if (ec) {
+            return fail(ec, "subscribe");
+        }
+
+        scheduleHeartbeat();
+        doRead();
+    }
+
+    /**
+     * @brief Send the venue's application-level ping every heartbeat interval
+     *
+     * Reads run all the time but writes only happen here once subscribed, so a heartbeat
+     * never overlaps another write.
+     */
+    void scheduleHeartbeat() {
+        if (config_.heartbeat.empty() || config_.heartbeatIntervalMs <= 0) {
+            return;
+        }
+        heartbeatTimer_.expires_after(std::chrono::milliseconds(config_.heartbeatIntervalMs));
+        heartbeatTimer_.async_wait([self = shared_from_this()](beast::error_code ec) {
+            if (ec || self->stopped_ || !self->isConnected_) {
+                return;
+            }
+            self->ws_->text(true);
+            self->ws_->async_write(net::buffer(self->config_.heartbeat),
+                [self](beast::error_code writeEc, std::size_t) {
+                    // A failed write also fails the pending read, which reconnects
+                    if (!writeEc) {
+                        self->scheduleHeartbeat();
+                    }
+                });
+        });
+    }
+
+    void doRead() {
+        // Drop the previous message but keep the buffer's storage
+        readBuffer_.clear();
+
+        ws_->async_read(readBuffer_,
+            beast::bind_front_handler(&FeedSession::onRead, shared_from_this()));
+    }
+
+    void onRead(beast::error_code ec, std::size_t) {
+        if (ec) {
+            return fail(ec, "read");
+        }
+
+        // Update last message time
+        orderbook_.trace.readNs = utils::nowNanoseconds();
+        orderbook_.trace.readWallNs = utils::wallClockNanoseconds();
+        lastMessageNs_.store(orderbook_.trace.readNs, std::memory_order_relaxed);
+
+        // The connection works end to end, so the next drop starts the backoff over;
+        // TLS 1.3 servers send their session tickets after the handshake
+        failedAttempts_ = 0;
+        if (!tlsSessionSaved_) {
+            saveTlsSession();
+            tlsSessionSaved_ = true;
+        }
+
+        // Process the message straight off the read buffer
+        std::string_view message(static_cast<const char*>(readBuffer_.data().data()),
+                                 readBuffer_.size());
+        if (ws_->got_binary() && config_.binaryFrames == FrameCompression::RawDeflate) {
+            if (!inflate(message)) {
+                std::cerr << "Dropping undecodable binary frame on " << label_ << std::endl;
+                if (!stopped_) {
+                    doRead();
+                }
+                return;
+            }
+            message = inflated_;
+        }
+        processMessage(message);
+
+        if (!stopped_) {
+            doRead();
+        }
+    }
+
+    void processMessage(std::string_view message) {
+        try {
+            // Parse orderbook data from the message into the reused book
+            orderbook_.received_time = std::chrono::steady_clock::now();
+            if (rawMessageCallback_ && arbiter_->isActive(connection_)) {
+                rawMessageCallback_(feedId_, message, orderbook_.received_time);
+            }
+            orderbook_.trace.parseStartNs = utils::nowNanoseconds();
+            if (decoder_.decode(message, orderbook_) == DecodeResult::Ignored) {
+                return;  // Subscription acknowledgement or other control message
+            }
+            orderbook_.trace.parsedNs = utils::nowNanoseconds();
+
+            // Call the callback with the processed data, if this connection is delivering
+            arbiter_->deliver(connection_, orderbook_, [this]() {
+                callback_(feedId_, orderbook_);
+            });
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error processing message: " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * @brief Inflate a raw deflate frame into inflated_, whose capacity is kept
+     * @param frame Compressed frame
+     * @return False if the frame is not a valid deflate stream or inflates past
+     *         kMaxInflatedMessageSize
+     */
+    bool inflate(std::string_view frame) {
+        // Each frame is an independent raw deflate stream, so the inflater starts afresh;
+        // only the output buffer's capacity carries over between frames
+        inflater_.reset();
+        beast::zlib::z_params stream;
+        stream.next_in = frame.data();
+        stream.avail_in = frame.size();
+        inflated_.clear();
+
+        for (;;) {
+            size_t written = inflated_.size();
+            if (written >= kMaxInflatedMessageSize) {
+                return false;
+            }
+            size_t wanted = std::max(inflated_.capacity(), written + frame.size() * 4 + 256);
+            inflated_.resize(std::min(wanted, kMaxInflatedMessageSize));
+            stream.next_out = &inflated_[written];
+            stream.avail_out = inflated_.size() - written;
+
+            beast::error_code ec;
+            inflater_.write(stream, beast::zlib::Flush::sync, ec);
+            inflated_.resize(inflated_.size() - stream.avail_out);
+            if (ec == beast::zlib::error::end_of_stream ||
+                (!ec && stream.avail_in == 0 && stream.avail_out != 0)) {
+                return true;
+            }
+            if (ec == beast::zlib::error::need_buffers) {
+                // With the input consumed, no progress means the output exactly filled the
+                // buffer on the last pass and the message is complete
+                if (stream.avail_in == 0) {
+                    return true;
+                }
+                continue;
+            }
+            if (ec) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Keep the session of the current connection to resume it on the next one
+     *
+     * Keeps a copy: OpenSSL marks the connection's own session object unresumable when
+     * the connection dies with a fatal error, which is how most connections end.
+     */
+    void saveTlsSession() {
+        SSL_SESSION* session = SSL_get0_session(ws_->next_layer().native_handle());
+        if (session && SSL_SESSION_is_resumable(session)) {
+            if (SSL_SESSION* copy = SSL_SESSION_dup(session)) {
+                tlsSession_.reset(copy);
+            }
+        }
+    }
+
+    void fail(beast::error_code ec, const char* what) {
+        isConnected_ = false;
+        arbiter_->setConnected(connection_, false);
+        heartbeatTimer_.cancel();
+
+        if (stopped_) {
+            return;
+        }
+
+        if (resyncRequested_) {
+            // We cancelled the connection ourselves to get a fresh snapshot
+            resyncRequested_ = false;
+            std::cerr << "Resubscribing " << label_ << std::endl;
+            doResolve();
+            return;
+        }
+
+        if (ec != websocket::error::closed) {
+            std::cerr << "WebSocket " << what << " error on " << label_
+                      << ": " << ec.message() << std::endl;
+        }
+
+        scheduleReconnect();
+    }
+
+    void scheduleReconnect() {
+        ++failedAttempts_;
+        if (failedAttempts_ <= config_.reconnectImmediateAttempts) {
+            std::cerr << "Reconnecting " << label_ << std::endl;
+            doResolve();
+            return;
+        }
+
+        // Exponential backoff after the immediate attempts, randomized by the jitter
+        int exponent = std::min(failedAttempts_ - config_.reconnectImmediateAttempts - 1, 30);
+        double delayMs = std::min(std::ldexp(static_cast<double>(config_.reconnectInitialDelayMs), exponent),
+                                  static_cast<double>(config_.reconnectMaxDelayMs));
+        double jitter = std::clamp(config_.reconnectJitter, 0.0, 1.0);
+        delayMs *= std::uniform_real_distribution<double>(1.0 - jitter, 1.0)(backoffRandom_);
+
+        std::cerr << "Reconnecting " << label_ << " in " << delayMs / 1000.0 << " seconds..." << std::endl;
+
+        timer_.expires_after(std::chrono::milliseconds(static_cast<int64_t>(delayMs)));
+        timer_.async_wait([self = shared_from_this()](beast::error_code ec) {
+            if (!ec) {
+                self->doResolve();
+            }
+        });
+    }
+};
+
+WebSocketClient::WebSocketClient(OrderbookCallback callback, size_t ioThreads,
+                                 const utils::ThreadConfig& threadConfig)
     : callback_(std::move(callback)),
-      lastMessageTime_(std::chrono::steady_clock::now()) {
-    // Nothing else to initialize
+      ioThreadCount_(std::max<size_t>(1, ioThreads)),
+      threadConfig_(threadConfig) {
+    // TLS 1.2 or later; 1.3 saves a round trip on full handshakes
+    SSL_CTX_set_min_proto_version(sslContext_.native_handle(), TLS1_2_VERSION);
+
+    // Verify the certificate
+    sslContext_.set_verify_mode(ssl::verify_peer);
+    sslContext_.set_default_verify_paths();
 }
 
 WebSocketClient::~WebSocketClient() {
     stop();
 }
 
+void WebSocketClient::setRawMessageCallback(RawMessageCallback callback) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    rawMessageCallback_ = std::move(callback);
+}
+
+FeedId WebSocketClient::addFeed(const FeedConfig& config) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+
+    FeedId feedId = nextFeedId_++;
+    Feed& feed = feeds_[feedId];
+    feed.config = config;
+
+    if (shouldRun_) {
+        startSession(feedId, feed);
+    }
+    return feedId;
+}
+
+bool WebSocketClient::removeFeed(FeedId feedId) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+
+    auto it = feeds_.find(feedId);
+    if (it == feeds_.end()) {
+        return false;
+    }
+
+    for (auto& session : it->second.sessions) {
+        session->stop();
+    }
+    feeds_.erase(it);
+    return true;
+}
+
+bool WebSocketClient::resubscribe(FeedId feedId) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+
+    auto it = feeds_.find(feedId);
+    if (it == feeds_.end()) {
+        return false;
+    }
+
+    // A book that lost sync needs a snapshot, which the standby will not send either
+    for (auto& session : it->second.sessions) {
+        session->resync();
+    }
+    return true;
+}
+
 void WebSocketClient::start() {
     std::lock_guard<std::mutex> lock(stateMutex_);
-    
+
     if (shouldRun_) {
         return; // Already running
     }
-    
-    shouldRun_ = true; 
-    reconnectDelayMs_ = kReconnectInitialDelayMs;
-    
-    // Start IO service in a separate thread
-    ioThread_ = std::make_unique<std::thread>([this]() {
-        runIoService();
-    });
+
+    shouldRun_ = true;
+
+    ioc_.restart();
+    work_.emplace(net::make_work_guard(ioc_));
+
+    for (auto& [feedId, feed] : feeds_) {
+        startSession(feedId, feed);
+    }
+
+    // Start the IO thread pool
+    for (size_t i = 0; i < ioThreadCount_; ++i) {
+        ioThreads_.emplace_back([this]() {
+            runIoService();
+        });
+    }
 }
 
 void WebSocketClient::stop() {
@@ -50,197 +768,82 @@ void WebSocketClient::stop() {
             return; // Already stopped
         }
         shouldRun_ = false;
+
+        // Close every feed; the sessions finish on their own once their handlers drain
+        for (auto& [feedId, feed] : feeds_) {
+            for (auto& session : feed.sessions) {
+                session->stop();
+            }
+            feed.sessions.clear();
+        }
+        work_.reset();
     }
-    
-    // Wait for IO thread to finish
-    if (ioThread_ && ioThread_->joinable()) {
-        ioThread_->join();
-        ioThread_.reset();
+
+    // Wait for the IO threads to run out of work
+    for (auto& thread : ioThreads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
-    
-    isConnected_ = false;
+    ioThreads_.clear();
 }
 
 bool WebSocketClient::isConnected() const {
-    return isConnected_;
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return std::any_of(feeds_.begin(), feeds_.end(), [](const auto& entry) {
+        const auto& sessions = entry.second.sessions;
+        return std::any_of(sessions.begin(), sessions.end(), [](const auto& session) {
+            return session->isConnected();
+        });
+    });
 }
 
-bool WebSocketClient::isHealthy(int maxIdleSeconds) const {
-    if (!isConnected_) {
+bool WebSocketClient::isHealthy(std::chrono::nanoseconds maxIdle) const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    if (feeds_.empty()) {
         return false;
     }
-    
-    std::lock_guard<std::mutex> lock(stateMutex_);
-    auto now = std::chrono::steady_clock::now();
-    auto idleTime = std::chrono::duration_cast<std::chrono::seconds>(now - lastMessageTime_).count();
-    
-    return idleTime < maxIdleSeconds;
+    return std::all_of(feeds_.begin(), feeds_.end(), [maxIdle](const auto& entry) {
+        const auto& sessions = entry.second.sessions;
+        return std::any_of(sessions.begin(), sessions.end(), [maxIdle](const auto& session) {
+            return session->isHealthy(maxIdle);
+        });
+    });
 }
 
 void WebSocketClient::runIoService() {
-    while (shouldRun_) {
+    utils::applyThreadConfig(threadConfig_, "network");
+
+    while (true) {
         try {
-            // Reset the io_context
-            ioc_.restart();
-            
-            // Connect to the WebSocket
-            connect();
-            
-            // Run the IO context until it's stopped
-            ioc_.run();
+            // Run the IO context until it runs out of work; busy polling runs ready
+            // handlers in a loop, so a message is picked up without a wake-up
+            if (threadConfig_.busyPoll) {
+                while (!ioc_.stopped()) {
+                    if (ioc_.poll() == 0) {
+                        utils::cpuRelax();
+                    }
+                }
+            } else {
+                ioc_.run();
+            }
+            return;
         }
         catch (const std::exception& e) {
             std::cerr << "WebSocket error: " << e.what() << std::endl;
         }
-        
-        // If we should still be running, reconnect after delay
-        if (shouldRun_) {
-            reconnect();
-        }
     }
 }
 
-void WebSocketClient::connect() {
-    try {
-        // The SSL context is required for secure WebSockets
-        ssl::context ctx{ssl::context::tlsv12_client};
-        
-        // Verify the certificate
-        ctx.set_verify_mode(ssl::verify_peer);
-        ctx.set_default_verify_paths();
-        
-        // These objects perform our I/O
-        tcp::resolver resolver{ioc_};
-        websocket::stream<ssl::stream<tcp::socket>> ws{ioc_, ctx};
-        
-        // Look up the domain name
-        auto const results = resolver.resolve(kHost, kPort);
-        
-        // Make the connection on the IP address we get from a lookup
-        auto ep = net::connect(ws.next_layer().next_layer(), results);
-        
-        // Set SNI Hostname (many hosts need this to handshake successfully)
-        if (!SSL_set_tlsext_host_name(ws.next_layer().native_handle(), kHost.c_str())) {
-            throw beast::system_error(
-                beast::error_code(
-                    static_cast<int>(::ERR_get_error()),
-                    net::error::get_ssl_category()),
-                "Failed to set SNI Hostname");
-        }
-        
-        // SSL handshake
-        ws.next_layer().handshake(ssl::stream_base::client);
-        
-        // WebSocket handshake
-        ws.handshake(kHost, kTarget);
-        
-        // Set connection state
-        isConnected_ = true;
-        
-        std::cout << "Connected to WebSocket server: " << kHost << kTarget << std::endl;
-        
-        // Read loop
-        while (shouldRun_ && isConnected_) {
-            beast::flat_buffer buffer;
-            
-            // Read a message
-            ws.read(buffer);
-            
-            // Update last message time
-            { 
-                std::lock_guard<std::mutex> lock(stateMutex_);
-                lastMessageTime_ = std::chrono::steady_clock::now(); 
-            }
-            
-            // Extract the message
-            std::string message = beast::buffers_to_string(buffer.data());
-            
-            // Process the message
-            processMessage(message); 
-        }
-        
-        // Close the WebSocket connection
-        ws.close(websocket::close_code::normal);
-    }
-    catch (const beast::system_error& se) {
-        // Special handling for system errors
-        if (se.code() != websocket::error::closed) {
-            std::cerr << "WebSocket system error: " << se.code().message() << std::endl;
-        }
-        isConnected_ = false;
+void WebSocketClient::startSession(FeedId feedId, Feed& feed) {
+    size_t connections = feed.config.hotStandby ? FeedArbiter::kMaxConnections : 1;
+    feed.arbiter = std::make_shared<FeedArbiter>(connections);
+    for (size_t connection = 0; connection < connections; ++connection) {
+        feed.sessions.push_back(std::make_shared<FeedSession>(
+            ioc_, sslContext_, feedId, feed.config, callback_, rawMessageCallback_, feed.arbiter, connection));
+        feed.sessions.back()->start();
     }
-    catch (const std::exception& e) {
-        std::cerr << "WebSocket exception: " << e.what() << std::endl;
-        isConnected_ = false;
-    }
-}
-
-void WebSocketClient::processMessage(const std::string& message) {
-    try {
-        // Parse orderbook data from the message
-        OrderbookData orderbookData = parseOrderbookData(message);
-        
-        // Call the callback with the processed data
-        callback_(orderbookData);
-    } 
-    catch (const std::exception& e) {
-        std::cerr << "Error processing message: " << e.what() << std::endl;
-    }
-}
-
-OrderbookData WebSocketClient::parseOrderbookData(const std::string& jsonMessage) {
-    auto startTime = std::chrono::steady_clock::now();
-    
-    // Parse JSON
-    json data = json::parse(jsonMessage);
-    
-    // Create orderbook data
-    OrderbookData orderbookData;
-    orderbookData.received_time = startTime;
-    
-    // Basic validation of the data
-    if (!data.contains("timestamp") || !data.contains("exchange") || 
-        !data.contains("symbol") || !data.contains("asks") || !data.contains("bids")) {
-        throw std::runtime_error("Missing required fields in data");
-    }
-    
-    // Extract the fields
-    orderbookData.timestamp = data["timestamp"].get<std::string>();
-    orderbookData.exchange = data["exchange"].get<std::string>();
-    orderbookData.symbol = data["symbol"].get<std::string>();
-    
-    // Process asks
-    for (const auto& ask : data["asks"]) {
-        if (ask.size() >= 2) {
-            double price = std::stod(ask[0].get<std::string>());
-            double size = std::stod(ask[1].get<std::string>());
-            orderbookData.asks.emplace_back(price, size);
-        }
-    }
-    
-    // Process bids
-    for (const auto& bid : data["bids"]) {
-        if (bid.size() >= 2) {
-            double price = std::stod(bid[0].get<std::string>());
-            double size = std::stod(bid[1].get<std::string>());
-            orderbookData.bids.emplace_back(price, size);
-        }
-    }
-    
-    return orderbookData;
-}
-
-void WebSocketClient::reconnect() {
-    isConnected_ = false;
-    
-    std::cout << "Reconnecting in " << reconnectDelayMs_ / 1000.0 << " seconds..." << std::endl;
-    
-    // Wait for the reconnect delay
-    std::this_thread::sleep_for(std::chrono::milliseconds(reconnectDelayMs_));
-    
-    // Increase reconnect delay with exponential backoff
-    reconnectDelayMs_ = std::min(reconnectDelayMs_ * 2, kReconnectMaxDelayMs);
 }
 
 } // namespace data
-} // namespace trade_simulator 
\ No newline at end of file
+} // namespace trade_simulator
\ No newline at end of file
@@ -0,0 +1,511 @@
+// Headless simulator: runs the feed, processing and models without Qt and writes every
+// output to stdout, a CSV file or a UDP socket. Options come from the command line,
+// a configuration file of "key = value" lines, or both; the command line wins.
+//
+//     trade_simulator_headless [--config file] [--output - | file.csv | udp://host:port]
+//                              [--exchange OKX] [--symbol BTC-USDT] [--quantity usd]
+//                              [--volatility x] [--fee-tier n] [--cost-curve-points n]
+//                              [--order-type market|limit [--limit-horizon seconds]]
+//                              [--record file | --replay file [--replay-fast] [--replay-speed x]]
+//                              [--queue-capacity n] [--overflow conflate|block]
+//                              [--network-cpu n] [--processing-cpu n] [--busy-poll] [--hot-standby]
+//                              [--output-bus /name [--output-bus-capacity n]]
+//                              [--no-calibration] [--duration seconds] [--latency-csv file]
+//                              [--max-exchange-lag-ms n] [--max-queue-age-ms n]
+//                              [--max-silence-ms n] [--no-suppress-stale]
+//                              [--no-cost-memo] [--changes-only]
+//                              [--monte-carlo-paths n [--monte-carlo-threads n] [--monte-carlo-seed n]]
+//                              [--instruments a,b,c [--shards n] [--shard-cpus n,n,...] [--io-threads n]
+//                                  [--route-quantity usd [--route-side buy|sell]]]
+//
+// With --instruments a,b,c it runs a SimulatorEngine instead, pricing every instrument
+// with the same settings on --shards worker threads (pinned by --shard-cpus 2,3,...),
+// and prefixes each output row with its instrument. --route-quantity also routes one
+// order across the instruments as venues of the same asset and prints its split at exit.
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "models/output_sink.h"
+#include "models/simulator.h"
+#include "models/simulator_engine.h"
+#include "utils/latency_histogram.h"
+
+namespace {
+
+using namespace trade_simulator;
+
+std::atomic<bool> stopRequested{false};
+
+void onSignal(int) {
+    stopRequested.store(true);
+}
+
+// Options that take no value on the command line
+const char* const kFlags[] = {"replay-fast", "busy-poll", "hot-standby", "no-calibration",
+                            "no-suppress-stale", "no-cost-memo", "changes-only", "help"};
+
+bool isFlag(const std::string& key) {
+    for (const char* flag : kFlags) {
+        if (key == flag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// "key = value" lines; blank lines and lines starting with '#' are skipped
+void readConfigFile(const std::string& path, std::map<std::string, std::string>& options) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open config file: " + path);
+    }
+    int lineNumber = 0;
+    for (std::string line; std::getline(in, line);) {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected key = value");
+        }
+        options[trim(line.substr(0, equals))] = trim(line.substr(equals + 1));
+    }
+}
+
+// "--key value", "--key=value" and "--flag"
+std::map<std::string, std::string> parseCommandLine(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument.compare(0, 2, "--") != 0) {
+            throw std::runtime_error("Unexpected argument: " + argument);
+        }
+        std::string key = argument.substr(2);
+        size_t equals = key.find('=');
+        if (equals != std::string::npos) {
+            options[key.substr(0, equals)] = key.substr(equals + 1);
+        } else if (isFlag(key)) {
+            options[key] = "true";
+        } else if (i + 1 < argc) {
+            options[key] = argv[++i];
+        } else {
+            throw std::runtime_error("Missing value for --" + key);
+        }
+    }
+    return options;
+}
+
+// "a,b,c" with empty items dropped
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream in(text);
+    for (std::string item; std::getline(in, item, ',');) {
+        item = trim(item);
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @brief Typed access to the merged options; reports unknown and malformed ones
+ */
+class Options {
+public:
+    explicit Options(std::map<std::string, std::string> values) : values_(std::move(values)) {}
+
+    std::string text(const std::string& key, const std::string& fallback = std::string()) {
+        used_[key] = true;
+        auto it = values_.find(key);
+        return it != values_.end() ? it->second : fallback;
+    }
+
+    template <typename T>
+    T number(const std::string& key, T fallback) {
+        std::string value = text(key);
+        if (value.empty()) {
+            return fallback;
+        }
+        std::istringstream in(value);
+        T result{};
+        in >> result;
+        if (!in || !in.eof()) {
+            throw std::runtime_error("Invalid value for " + key + ": " + value);
+        }
+        return result;
+    }
+
+    bool flag(const std::string& key) {
+        std::string value = text(key, "false");
+        if (value == "true" || value == "1" || value == "yes") {
+            return true;
+        }
+        if (value == "false" || value == "0" || value == "no") {
+            return false;
+        }
+        throw std::runtime_error("Invalid value for " + key + ": " + value);
+    }
+
+    std::vector<int> numbers(const std::string& key) {
+        std::vector<int> result;
+        for (const std::string& item : splitList(text(key))) {
+            std::istringstream in(item);
+            int value = 0;
+            in >> value;
+            if (!in || !in.eof()) {
+                throw std::runtime_error("Invalid value for " + key + ": " + item);
+            }
+            result.push_back(value);
+        }
+        return result;
+    }
+
+    void rejectUnknown() const {
+        for (const auto& [key, value] : values_) {
+            if (!used_.count(key)) {
+                throw std::runtime_error("Unknown option: " + key);
+            }
+        }
+    }
+
+private:
+    std::map<std::string, std::string> values_;
+    std::map<std::string, bool> used_;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--config file] [--output - | file.csv | udp://host:port]\n"
+              << "  [--exchange OKX] [--symbol BTC-USDT] [--quantity usd] [--volatility x]\n"
+              << "  [--fee-tier n] [--cost-curve-points n]\n"
+              << "  [--order-type market|limit [--limit-horizon seconds]]\n"
+              << "  [--record file | --replay file [--replay-fast] [--replay-speed x]]\n"
+              << "  [--queue-capacity n] [--overflow conflate|block]\n"
+              << "  [--network-cpu n] [--processing-cpu n] [--busy-poll] [--hot-standby]\n"
+              << "  [--output-bus /name [--output-bus-capacity n]]\n"
+              << "  [--no-calibration] [--duration seconds] [--latency-csv file]\n"
+              << "  [--max-exchange-lag-ms n] [--max-queue-age-ms n] [--max-silence-ms n]\n"
+              << "  [--no-suppress-stale] [--no-cost-memo] [--changes-only]\n"
+              << "  [--monte-carlo-paths n [--monte-carlo-threads n] [--monte-carlo-seed n]]\n"
+              << "  [--instruments a,b,c [--shards n] [--shard-cpus n,n,...] [--io-threads n]\n"
+              << "      [--route-quantity usd [--route-side buy|sell]]]" << std::endl;
+}
+
+// Runs until a signal, the duration, or the end of a replay once `drained` says so
+template <typename Drained>
+void runUntilDone(double duration, bool replaying, Drained drained) {
+    auto started = std::chrono::steady_clock::now();
+    while (!stopRequested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (duration > 0.0 &&
+            std::chrono::steady_clock::now() - started >= std::chrono::duration<double>(duration)) {
+            break;
+        }
+        if (replaying && drained()) {
+            break;
+        }
+    }
+}
+
+models::StalenessConfig readStaleness(Options& options) {
+    models::StalenessConfig staleness;
+    staleness.maxExchangeLagMs = options.number("max-exchange-lag-ms", staleness.maxExchangeLagMs);
+    staleness.maxQueueAgeMs = options.number("max-queue-age-ms", staleness.maxQueueAgeMs);
+    staleness.maxSilenceMs = options.number("max-silence-ms", staleness.maxSilenceMs);
+    staleness.suppressStale = !options.flag("no-suppress-stale");
+    return staleness;
+}
+
+void writeLatencyCsv(const std::string& path, utils::PipelineLatency& latency) {
+    if (path.empty()) {
+        return;
+    }
+    std::ofstream out(path, std::ios::trunc);
+    latency.writeCsv(out);
+    if (!out) {
+        std::cerr << "Cannot write " << path << std::endl;
+    }
+}
+
+int runEngine(Options& options, const std::vector<std::string>& instruments) {
+    models::SimulatorEngineConfig config;
+    for (const std::string& name : instruments) {
+        models::EngineInstrumentConfig instrument(name);
+        instrument.exchange = options.text("exchange", instrument.exchange);
+        instrument.quantity = options.number("quantity", instrument.quantity);
+        instrument.volatility = options.number("volatility", instrument.volatility);
+        instrument.feeTier = options.number("fee-tier", instrument.feeTier);
+        config.instruments.push_back(instrument);
+    }
+    config.shards = options.number("shards", config.shards);
+    config.shardCpus = options.numbers("shard-cpus");
+    config.busyPoll = options.flag("busy-poll");
+    config.ioThreads = options.number("io-threads", config.ioThreads);
+    config.networkThread.cpu = options.number("network-cpu", -1);
+    config.networkThread.busyPoll = config.busyPoll;
+    config.hotStandby = options.flag("hot-standby");
+    config.replayPath = options.text("replay");
+    config.replayMode = options.flag("replay-fast") ? data::ReplayMode::AsFastAsPossible
+                                                    : data::ReplayMode::RealTime;
+    config.replaySpeed = options.number("replay-speed", config.replaySpeed);
+    config.queueCapacity = options.number("queue-capacity", config.queueCapacity);
+    std::string overflow = options.text("overflow", "conflate");
+    if (overflow == "block") {
+        config.overflowPolicy = data::OverflowPolicy::Block;
+    } else if (overflow != "conflate") {
+        throw std::runtime_error("Invalid value for overflow: " + overflow);
+    }
+    config.calibrateSlippage = !options.flag("no-calibration");
+    config.staleness = readStaleness(options);
+    config.memoizeCosts = !options.flag("no-cost-memo");
+    bool changesOnly = options.flag("changes-only");
+    config.routing.quantity = options.number("route-quantity", config.routing.quantity);
+    std::string routeSide = options.text("route-side", "buy");
+    if (routeSide != "buy" && routeSide != "sell") {
+        throw std::runtime_error("Invalid value for route-side: " + routeSide);
+    }
+    config.routing.buy = routeSide == "buy";
+
+    std::string outputTarget = options.text("output", "-");
+    std::string latencyPath = options.text("latency-csv");
+    double duration = options.number("duration", 0.0);
+    options.rejectUnknown();
+
+    std::unique_ptr<models::OutputSink> sink = models::createOutputSink(outputTarget, true);
+
+    // Shards publish concurrently; the sink takes one row at a time
+    std::mutex sinkMutex;
+    models::SimulatorEngine* enginePtr = nullptr;
+    models::SimulatorEngine engine(
+        [&](size_t instrument, const models::SimulatorOutput& output) {
+            if (changesOnly && !output.costsChanged) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(sinkMutex);
+                sink->publish(output, enginePtr->instrumentName(instrument).c_str());
+            }
+            enginePtr->getLatency().stage(utils::LatencyStage::EndToEnd)
+                .recordInterval(output.readNs, utils::nowNanoseconds());
+        },
+        config);
+    enginePtr = &engine;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    engine.start();
+    runUntilDone(duration, !config.replayPath.empty(), [&engine]() {
+        if (engine.isFeedConnected()) {
+            return false;
+        }
+        for (size_t i = 0; i < engine.instrumentCount(); ++i) {
+            data::DispatcherStats queue = engine.getQueueStats(i);
+            if (queue.queueDepth != 0 || queue.processed != queue.published) {
+                return false;
+            }
+        }
+        return true;
+    });
+    engine.stop();
+    sink->flush();
+
+    models::EngineAggregate aggregate = engine.getAggregate();
+    utils::LatencySnapshot endToEnd = engine.getLatency().stage(utils::LatencyStage::EndToEnd).snapshot();
+    std::cerr << "Processed " << aggregate.updates << " updates on " << aggregate.pricedInstruments
+              << " of " << aggregate.instruments << " instruments (" << aggregate.conflated
+              << " conflated, " << aggregate.staleInstruments << " stale, " << aggregate.costMemoHits
+              << " cost memo hits, " << aggregate.costMemoMisses << " misses); total net cost " << aggregate.totalNetCost << "; busiest shard "
+              << aggregate.busiestShard << " with " << aggregate.busiestShardUpdates
+              << " updates; end-to-end p50 " << endToEnd.p50 << " ns, p99 " << endToEnd.p99
+              << " ns, max " << endToEnd.max << " ns" << std::endl;
+
+    for (size_t i = 0; i < engine.instrumentCount(); ++i) {
+        if (engine.getQueueStats(i).published == 0) {
+            std::cerr << "No updates for " << engine.instrumentName(i) << "; check --instruments and --exchange"
+                      << std::endl;
+        }
+    }
+
+    models::RouteAllocation route = engine.getLatestRoute();
+    if (route.publishedNs != 0) {
+        utils::LatencySnapshot routing = engine.getLatency().stage(utils::LatencyStage::Routing).snapshot();
+        std::cerr << "Route " << routeSide << " " << route.routed << " of " << route.quantity
+                  << " at consolidated bid " << route.top.bestBid << " / ask " << route.top.bestAsk
+                  << ": cost " << route.totalCost << " (slippage " << route.slippage << ", fees "
+                  << route.fees << ", impact " << route.marketImpact << "), best single venue "
+                  << route.singleVenueCost << "; routing p50 " << routing.p50 << " ns, p99 "
+                  << routing.p99 << " ns" << std::endl;
+        for (size_t i = 0; i < route.venues; ++i) {
+            const models::VenueAllocation& leg = route.legs[i];
+            if (leg.size > 0.0) {
+                std::cerr << "  " << engine.instrumentName(i) << ": " << leg.size << " for "
+                          << leg.notional << ", cost " << leg.cost << std::endl;
+            }
+        }
+    }
+
+    writeLatencyCsv(latencyPath, engine.getLatency());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        std::map<std::string, std::string> commandLine = parseCommandLine(argc, argv);
+        if (commandLine.count("help")) {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        // File first, so the command line overrides it
+        std::map<std::string, std::string> values;
+        auto configPath = commandLine.find("config");
+        if (configPath != commandLine.end()) {
+            readConfigFile(configPath->second, values);
+        }
+        for (const auto& [key, value] : commandLine) {
+            values[key] = value;
+        }
+        Options options(std::move(values));
+        options.text("config");
+        options.text("help");
+
+        std::vector<std::string> instruments = splitList(options.text("instruments"));
+        if (!instruments.empty()) {
+            return runEngine(options, instruments);
+        }
+
+        models::SimulatorParams params;
+        params.exchange = options.text("exchange", params.exchange);
+        params.symbol = options.text("symbol", params.symbol);
+        params.quantity = options.number("quantity", params.quantity);
+        params.volatility = options.number("volatility", params.volatility);
+        params.feeTier = options.number("fee-tier", params.feeTier);
+        params.orderType = options.text("order-type", params.orderType);
+        if (params.orderType != "market" && params.orderType != "limit") {
+            throw std::runtime_error("Invalid value for order-type: " + params.orderType);
+        }
+        params.costCurvePoints = options.number("cost-curve-points", params.costCurvePoints);
+
+        models::SimulatorConfig config;
+        config.recordPath = options.text("record");
+        config.hotStandby = options.flag("hot-standby");
+        config.replayPath = options.text("replay");
+        config.replayMode = options.flag("replay-fast") ? data::ReplayMode::AsFastAsPossible
+                                                        : data::ReplayMode::RealTime;
+        config.replaySpeed = options.number("replay-speed", config.replaySpeed);
+        config.dispatcher.queueCapacity =
+            options.number("queue-capacity", config.dispatcher.queueCapacity);
+        std::string overflow = options.text("overflow", "conflate");
+        if (overflow == "block") {
+            config.dispatcher.overflowPolicy = data::OverflowPolicy::Block;
+        } else if (overflow != "conflate") {
+            throw std::runtime_error("Invalid value for overflow: " + overflow);
+        }
+        bool busyPoll = options.flag("busy-poll");
+        config.networkThread.cpu = options.number("network-cpu", -1);
+        config.networkThread.busyPoll = busyPoll;
+        config.dispatcher.processingThread.cpu = options.number("processing-cpu", -1);
+        config.dispatcher.processingThread.busyPoll = busyPoll;
+        config.calibrateSlippage = !options.flag("no-calibration");
+        config.outputBusName = options.text("output-bus");
+        config.outputBusCapacity = options.number("output-bus-capacity", config.outputBusCapacity);
+        config.staleness = readStaleness(options);
+        config.monteCarlo.paths = options.number<size_t>("monte-carlo-paths", 0);
+        config.monteCarlo.threads = options.number("monte-carlo-threads", config.monteCarlo.threads);
+        config.monteCarlo.seed = options.number("monte-carlo-seed", config.monteCarlo.seed);
+        config.simulateExecutionRisk = config.monteCarlo.paths > 0;
+        config.memoizeCosts = !options.flag("no-cost-memo");
+        bool changesOnly = options.flag("changes-only");
+        config.limitOrderHorizonSeconds =
+            options.number("limit-horizon", config.limitOrderHorizonSeconds);
+
+        std::string outputTarget = options.text("output", "-");
+        std::string latencyPath = options.text("latency-csv");
+        double duration = options.number("duration", 0.0);
+        options.rejectUnknown();
+
+        std::unique_ptr<models::OutputSink> sink = models::createOutputSink(outputTarget);
+
+        // The output is written on the processing thread; its latency closes the pipeline
+        models::Simulator* simulatorPtr = nullptr;
+        models::Simulator simulator(
+            [&sink, &simulatorPtr, changesOnly](const models::SimulatorOutput& output) {
+                if (changesOnly && !output.costsChanged) {
+                    return;
+                }
+                sink->publish(output);
+                if (simulatorPtr) {
+                    simulatorPtr->getLatency().stage(utils::LatencyStage::EndToEnd)
+                        .recordInterval(output.readNs, utils::nowNanoseconds());
+                }
+            },
+            config);
+        simulatorPtr = &simulator;
+        simulator.updateParams(params);
+
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        simulator.start();
+        // A finished replay ends the run once the queue has drained
+        runUntilDone(duration, !config.replayPath.empty(), [&simulator]() {
+            data::DispatcherStats queue = simulator.getQueueStats();
+            return !simulator.isFeedConnected() && queue.queueDepth == 0 &&
+                   queue.processed == queue.published;
+        });
+        simulator.stop();
+        sink->flush();
+
+        data::DispatcherStats queue = simulator.getQueueStats();
+        utils::LatencySnapshot endToEnd =
+            simulator.getLatency().stage(utils::LatencyStage::EndToEnd).snapshot();
+        std::cerr << "Processed " << queue.processed << " updates (" << queue.conflated
+                  << " conflated); end-to-end p50 " << endToEnd.p50 << " ns, p99 "
+                  << endToEnd.p99 << " ns, max " << endToEnd.max << " ns" << std::endl;
+        models::CostMemoStats memo = simulator.getCostMemoStats();
+        if (memo.hits + memo.misses > 0) {
+            std::cerr << "Cost memo: " << memo.hits << " hits, " << memo.misses << " misses, "
+                      << memo.unchanged << " unchanged updates" << std::endl;
+        }
+        models::CostDistribution risk = simulator.getLatestCostDistribution();
+        if (risk.paths > 0) {
+            std::cerr << "Execution cost over " << risk.paths << " paths: mean " << risk.expectedCost
+                      << ", p50 " << risk.medianCost << ", p95 " << risk.percentile95 << ", VaR "
+                      << risk.confidence * 100.0 << "% " << risk.valueAtRisk << ", expected shortfall "
+                      << risk.expectedShortfall << std::endl;
+        }
+
+        writeLatencyCsv(latencyPath, simulator.getLatency());
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+}
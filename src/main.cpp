@@ -1,4 +1,5 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <iostream>
 #include "ui/main_window.h"
 #include "models/simulator.h"
@@ -8,15 +9,47 @@ int main(int argc, char *argv[])
     try {
         QApplication app(argc, argv);
         
-        qRegisterMetaType<trade_simulator::models::SimulatorOutput>("models::SimulatorOutput");
-        
         QApplication::setApplicationName("Trade Simulator");
         QApplication::setApplicationVersion("1.0.0");
         
-        trade_simulator::ui::MainWindow mainWindow; 
+        // Feed options: record the live feed, or replay a recorded one
+        QCommandLineParser parser;
+        parser.addHelpOption();
+        parser.addVersionOption();
+        QCommandLineOption recordOption("record", "Record the live feed to <file>.", "file");
+        QCommandLineOption replayOption("replay", "Replay the feed log <file> instead of connecting.", "file");
+        QCommandLineOption fastOption("replay-fast", "Replay as fast as possible instead of in real time.");
+        QCommandLineOption speedOption("replay-speed", "Real-time replay speed <factor>.", "factor", "1.0");
+        QCommandLineOption latencyOption("latency-csv", "Write the per-stage latency histograms to <file> on exit.", "file");
+        QCommandLineOption busOption("output-bus", "Broadcast outputs to the shared-memory bus <name>.", "name");
+        QCommandLineOption fpsOption("fps", "Draw at most <n> frames per second.", "n", "30");
+        parser.addOption(recordOption);
+        parser.addOption(replayOption);
+        parser.addOption(fastOption);
+        parser.addOption(speedOption);
+        parser.addOption(latencyOption);
+        parser.addOption(busOption);
+        parser.addOption(fpsOption);
+        parser.process(app);
+        
+        trade_simulator::models::SimulatorConfig config;
+        config.recordPath = parser.value(recordOption).toStdString();
+        config.replayPath = parser.value(replayOption).toStdString();
+        config.replayMode = parser.isSet(fastOption) ? trade_simulator::data::ReplayMode::AsFastAsPossible
+                                                     : trade_simulator::data::ReplayMode::RealTime;
+        config.replaySpeed = parser.value(speedOption).toDouble();
+        config.outputBusName = parser.value(busOption).toStdString();
+        config.simulateExecutionRisk = true;
+        
+        trade_simulator::ui::MainWindow mainWindow(config, parser.value(fpsOption).toInt()); 
         mainWindow.show(); 
         
-        return app.exec();
+        int result = app.exec();
+        
+        if (parser.isSet(latencyOption) && !mainWindow.exportLatency(parser.value(latencyOption))) {
+            std::cerr << "Cannot write " << parser.value(latencyOption).toStdString() << std::endl;
+        }
+        return result;
     }
     catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,134 @@
+#include "models/cost_memo.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+constexpr int kMantissaBits = 52;
+
+/**
+ * @brief Keep the sign, exponent and top bits of the mantissa of a value
+ *
+ * Values that agree to a relative 2^-bits share a bucket, at the cost of a shift.
+ */
+inline uint64_t quantize(double value, int bits) {
+    uint64_t pattern;
+    std::memcpy(&pattern, &value, sizeof(pattern));
+    return pattern >> (kMantissaBits - bits);
+}
+
+// Odd multipliers, one per key field; the products are independent, so they overlap
+constexpr uint64_t kFieldMultipliers[] = {
+    0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL,
+    0xd6e8feb86659fd93ULL, 0xff51afd7ed558ccdULL, 0xc4ceb9fe1a85ec53ULL,
+    0x94d049bb133111ebULL, 0xbf58476d1ce4e5b9ULL, 0x2545f4914f6cdd1dULL};
+
+// The counters have a single writer, so a plain store does without a locked increment
+inline void increment(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline uint64_t hashKey(const std::array<uint64_t, 9>& key) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < key.size(); ++i) {
+        hash += key[i] * kFieldMultipliers[i];
+    }
+    return hash ^ (hash >> 32);
+}
+
+} // namespace
+
+CostMemo::CostMemo(std::shared_ptr<const TransactionCostModel> costModel, const CostMemoConfig& config)
+    : costModel_(std::move(costModel)), config_(config) {
+    config_.midpriceBits = std::clamp(config_.midpriceBits, 0, kMantissaBits);
+    config_.valueBits = std::clamp(config_.valueBits, 0, kMantissaBits);
+    size_t capacity = 1;
+    while (capacity < config_.capacity) {
+        capacity <<= 1;
+    }
+    entries_.resize(capacity);
+    mask_ = capacity - 1;
+}
+
+MemoizedCost CostMemo::evaluate(double orderSize, bool orderSide, const data::OrderbookStats& stats,
+                                const data::FillEstimate& fill, uint64_t parametersVersion) {
+    if (parametersVersion != version_) {
+        version_ = parametersVersion;
+        invalidate();
+    }
+
+    // A complete fill's distance from the midprice is its slippage, so it is keyed as is; a
+    // partial one also goes through the calibrated regression and is keyed on the estimate
+    bool estimated = !fill.complete() || fill.filledSize <= 0.0;
+    double slippage = estimated ? costModel_->calculateSlippage(orderSize, orderSide, stats, fill) : 0.0;
+    double walked = estimated ? slippage : fill.vwap - stats.midprice;
+    int bits = config_.valueBits;
+    Key key = {
+        quantize(stats.midprice, config_.midpriceBits),
+        quantize(stats.spread, bits),
+        quantize(stats.total_ask_size, bits),
+        quantize(stats.total_bid_size, bits),
+        quantize(stats.order_imbalance, bits),
+        quantize(stats.price_volatility, bits),
+        quantize(orderSize, bits),
+        quantize(walked, bits),
+        orderSide ? 1u : 0u
+    };
+
+    bool changed = !hasLast_ || key != lastKey_;
+    lastKey_ = key;
+    hasLast_ = true;
+    if (!changed) {
+        increment(unchanged_);
+    }
+
+    Entry& entry = entries_[hashKey(key) & mask_];
+    if (entry.valid && entry.key == key) {
+        increment(hits_);
+        MemoizedCost cost = entry.cost;
+        cost.changed = changed;
+        return cost;
+    }
+
+    increment(misses_);
+    if (!estimated) {
+        slippage = costModel_->calculateSlippage(orderSize, orderSide, stats, fill);
+    }
+    auto [slippageCost, marketImpact, fees, totalCost] = costModel_->calculateTotalCost(
+        orderSize, orderSide, stats, slippage, &entry.cost.makerProportion);
+    entry.key = key;
+    entry.valid = true;
+    entry.cost.slippage = slippageCost;
+    entry.cost.marketImpact = marketImpact;
+    entry.cost.fees = fees;
+    entry.cost.totalCost = totalCost;
+
+    MemoizedCost cost = entry.cost;
+    cost.changed = changed;
+    return cost;
+}
+
+void CostMemo::invalidate() {
+    for (Entry& entry : entries_) {
+        entry.valid = false;
+    }
+    hasLast_ = false;
+    increment(invalidations_);
+}
+
+CostMemoStats CostMemo::stats() const {
+    CostMemoStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.unchanged = unchanged_.load(std::memory_order_relaxed);
+    stats.invalidations = invalidations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace models
+} // namespace trade_simulator
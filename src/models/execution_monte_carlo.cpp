@@ -0,0 +1,357 @@
+#include "models/execution_monte_carlo.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TRADE_SIMULATOR_HAVE_AVX2_NORMALS 1
+#include <immintrin.h>
+#endif
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+constexpr double kPi = 3.141592653589793;
+constexpr double kLn2 = 0.6931471805599453;
+constexpr uint64_t kGoldenGamma = 0x9e3779b97f4a7c15ULL;
+constexpr uint64_t kMixMultiplier1 = 0xbf58476d1ce4e5b9ULL;
+constexpr uint64_t kMixMultiplier2 = 0x94d049bb133111ebULL;
+constexpr uint64_t kOneBits = 0x3ff0000000000000ULL;        // 1.0
+constexpr uint64_t kSqrtHalfBits = 0x3fe6a09e667f3bcdULL;   // sqrt(1/2)
+constexpr uint64_t kMantissaMask = 0x000fffffffffffffULL;
+
+// Horner coefficients, highest power first: atanh(t) / t in t^2, and sin(x) / x and
+// cos(x) in x^2
+constexpr std::array<double, 9> kLogSeries = {
+    1.0 / 17, 1.0 / 15, 1.0 / 13, 1.0 / 11, 1.0 / 9, 1.0 / 7, 1.0 / 5, 1.0 / 3, 1.0};
+constexpr std::array<double, 8> kSinSeries = {
+    -1.0 / 1307674368000.0, 1.0 / 6227020800.0, -1.0 / 39916800.0, 1.0 / 362880.0,
+    -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0, 1.0};
+constexpr std::array<double, 9> kCosSeries = {
+    1.0 / 20922789888000.0, -1.0 / 87178291200.0, 1.0 / 479001600.0, -1.0 / 3628800.0,
+    1.0 / 40320.0, -1.0 / 720.0, 1.0 / 24.0, -0.5, 1.0};
+
+/**
+ * @brief SplitMix64 finalizer; hashing a counter with it gives a counter-based generator
+ */
+inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * kMixMultiplier1;
+    z = (z ^ (z >> 27)) * kMixMultiplier2;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Uniform in (0, 1] from 52 random bits: 2 - [1, 2), so its logarithm is finite
+ */
+inline double uniformFromBits(uint64_t bits) {
+    uint64_t oneToTwo = (bits >> 12) | kOneBits;
+    double value;
+    std::memcpy(&value, &oneToTwo, sizeof(value));
+    return 2.0 - value;
+}
+
+/**
+ * @brief Natural logarithm of a positive normal double, without branches or errno
+ *
+ * Splits x into 2^e * m with m in [sqrt(1/2), sqrt(2)) and sums the atanh series of
+ * log(m) = 2 * atanh((m - 1) / (m + 1)); accurate to about 1e-15 relative.
+ */
+inline double fastLog(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    // Shift the mantissa range so the split lands at sqrt(2) instead of 2
+    uint64_t shifted = bits + (kOneBits - kSqrtHalfBits);
+    double exponent = static_cast<double>(static_cast<int64_t>(shifted >> 52) - 0x3ff);
+    uint64_t mantissaBits = (shifted & kMantissaMask) + kSqrtHalfBits;
+    double m;
+    std::memcpy(&m, &mantissaBits, sizeof(m));
+
+    double t = (m - 1.0) / (m + 1.0);
+    double t2 = t * t;
+    double series = kLogSeries[0];
+    for (size_t i = 1; i < kLogSeries.size(); ++i) {
+        series = series * t2 + kLogSeries[i];
+    }
+    return 2.0 * t * series + exponent * kLn2;
+}
+
+/**
+ * @brief Sine and cosine of 2 * pi * u for u in [0, 1], without branches
+ *
+ * Evaluates the Taylor series of the half angle pi * (u - 1/2), within [-pi/2, pi/2], and
+ * doubles it; the shift by pi flips both signs. Accurate to about 1e-13.
+ */
+inline void fastSinCos2Pi(double u, double& sine, double& cosine) {
+    double half = kPi * (u - 0.5);
+    double h2 = half * half;
+    double s = kSinSeries[0];
+    for (size_t i = 1; i < kSinSeries.size(); ++i) {
+        s = s * h2 + kSinSeries[i];
+    }
+    s = s * half;
+    double c = kCosSeries[0];
+    for (size_t i = 1; i < kCosSeries.size(); ++i) {
+        c = c * h2 + kCosSeries[i];
+    }
+    sine = -2.0 * s * c;
+    cosine = 2.0 * s * s - 1.0;
+}
+
+/**
+ * @brief Box-Muller transform of one pair of uniforms, in place
+ */
+inline void boxMuller(double& first, double& second) {
+    double radius = std::sqrt(-2.0 * fastLog(first));
+    double sine, cosine;
+    fastSinCos2Pi(second, sine, cosine);
+    first = radius * cosine;
+    second = radius * sine;
+}
+
+/**
+ * @brief Fill count standard normals for the counters counter..counter+count-1
+ *
+ * The uniforms are hashed straight from their counters, and Box-Muller pairs element i
+ * with i + count / 2, so no element depends on another.
+ *
+ * @param key Hashed seed
+ * @param counter Index of the first normal
+ * @param count Number of normals, even
+ * @param normals Output
+ */
+void fillNormalsScalar(uint64_t key, uint64_t counter, size_t count, double* normals) {
+    for (size_t i = 0; i < count; ++i) {
+        normals[i] = uniformFromBits(mix64(key + (counter + i) * kGoldenGamma));
+    }
+    size_t half = count / 2;
+    for (size_t i = 0; i < half; ++i) {
+        boxMuller(normals[i], normals[i + half]);
+    }
+}
+
+#if TRADE_SIMULATOR_HAVE_AVX2_NORMALS
+
+/**
+ * @brief Low 64 bits of a 64 x 64-bit product, which AVX2 lacks, from 32-bit products
+ */
+__attribute__((target("avx2")))
+inline __m256i multiplyLow64(__m256i x, uint64_t constant) {
+    const __m256i low = _mm256_set1_epi64x(static_cast<int64_t>(constant & 0xffffffffULL));
+    const __m256i high = _mm256_set1_epi64x(static_cast<int64_t>(constant >> 32));
+    __m256i lowProduct = _mm256_mul_epu32(x, low);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), low),
+                                     _mm256_mul_epu32(x, high));
+    return _mm256_add_epi64(lowProduct, _mm256_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2")))
+inline __m256i mix64(__m256i z) {
+    z = multiplyLow64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 30)), kMixMultiplier1);
+    z = multiplyLow64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 27)), kMixMultiplier2);
+    return _mm256_xor_si256(z, _mm256_srli_epi64(z, 31));
+}
+
+__attribute__((target("avx2")))
+inline __m256d polynomial(const double* coefficients, size_t count, __m256d x) {
+    __m256d result = _mm256_set1_pd(coefficients[0]);
+    for (size_t i = 1; i < count; ++i) {
+        result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(coefficients[i]));
+    }
+    return result;
+}
+
+/**
+ * @brief fillNormalsScalar() four lanes at a time
+ *
+ * The same operations in the same order, without fused multiply-adds, so the normals
+ * are bit for bit those of the scalar code and results do not depend on the CPU.
+ */
+__attribute__((target("avx2")))
+void fillNormalsAvx2(uint64_t key, uint64_t counter, size_t count, double* normals) {
+    const __m256i one = _mm256_set1_epi64x(static_cast<int64_t>(kOneBits));
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256i step = _mm256_set1_epi64x(static_cast<int64_t>(4 * kGoldenGamma));
+    __m256i z = _mm256_set_epi64x(static_cast<int64_t>(key + (counter + 3) * kGoldenGamma),
+                                  static_cast<int64_t>(key + (counter + 2) * kGoldenGamma),
+                                  static_cast<int64_t>(key + (counter + 1) * kGoldenGamma),
+                                  static_cast<int64_t>(key + counter * kGoldenGamma));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i bits = _mm256_or_si256(_mm256_srli_epi64(mix64(z), 12), one);
+        _mm256_storeu_pd(normals + i, _mm256_sub_pd(two, _mm256_castsi256_pd(bits)));
+        z = _mm256_add_epi64(z, step);
+    }
+    for (; i < count; ++i) {
+        normals[i] = uniformFromBits(mix64(key + (counter + i) * kGoldenGamma));
+    }
+
+    const __m256i logShift = _mm256_set1_epi64x(static_cast<int64_t>(kOneBits - kSqrtHalfBits));
+    const __m256i sqrtHalf = _mm256_set1_epi64x(static_cast<int64_t>(kSqrtHalfBits));
+    const __m256i mantissaMask = _mm256_set1_epi64x(static_cast<int64_t>(kMantissaMask));
+    // Exponents are small non-negative integers: or-ing them into 2^52 converts them exactly
+    const __m256i twoTo52Bits = _mm256_set1_epi64x(0x4330000000000000LL);
+    const __m256d exponentOffset = _mm256_set1_pd(4503599627370496.0 + 0x3ff);
+    const __m256d oneValue = _mm256_set1_pd(1.0);
+    const __m256d minusTwo = _mm256_set1_pd(-2.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d pi = _mm256_set1_pd(kPi);
+    const __m256d ln2 = _mm256_set1_pd(kLn2);
+
+    size_t pairs = count / 2;
+    size_t j = 0;
+    for (; j + 4 <= pairs; j += 4) {
+        __m256d first = _mm256_loadu_pd(normals + j);
+        __m256d second = _mm256_loadu_pd(normals + j + pairs);
+
+        // fastLog(first)
+        __m256i shifted = _mm256_add_epi64(_mm256_castpd_si256(first), logShift);
+        __m256d exponent = _mm256_sub_pd(
+            _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(shifted, 52), twoTo52Bits)),
+            exponentOffset);
+        __m256d m = _mm256_castsi256_pd(
+            _mm256_add_epi64(_mm256_and_si256(shifted, mantissaMask), sqrtHalf));
+        __m256d t = _mm256_div_pd(_mm256_sub_pd(m, oneValue), _mm256_add_pd(m, oneValue));
+        __m256d series = polynomial(kLogSeries.data(), kLogSeries.size(), _mm256_mul_pd(t, t));
+        __m256d logarithm = _mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(two, t), series),
+                                          _mm256_mul_pd(exponent, ln2));
+        __m256d radius = _mm256_sqrt_pd(_mm256_mul_pd(minusTwo, logarithm));
+
+        // fastSinCos2Pi(second)
+        __m256d angle = _mm256_mul_pd(pi, _mm256_sub_pd(second, half));
+        __m256d angle2 = _mm256_mul_pd(angle, angle);
+        __m256d s = _mm256_mul_pd(polynomial(kSinSeries.data(), kSinSeries.size(), angle2), angle);
+        __m256d c = polynomial(kCosSeries.data(), kCosSeries.size(), angle2);
+        __m256d sine = _mm256_mul_pd(_mm256_mul_pd(minusTwo, s), c);
+        __m256d cosine = _mm256_sub_pd(_mm256_mul_pd(_mm256_mul_pd(two, s), s), oneValue);
+
+        _mm256_storeu_pd(normals + j, _mm256_mul_pd(radius, cosine));
+        _mm256_storeu_pd(normals + j + pairs, _mm256_mul_pd(radius, sine));
+    }
+    for (; j < pairs; ++j) {
+        boxMuller(normals[j], normals[j + pairs]);
+    }
+}
+
+#endif
+
+using FillNormalsFn = void (*)(uint64_t key, uint64_t counter, size_t count, double* normals);
+
+FillNormalsFn selectFillNormals() {
+#if TRADE_SIMULATOR_HAVE_AVX2_NORMALS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return fillNormalsAvx2;
+    }
+#endif
+    return fillNormalsScalar;
+}
+
+void fillNormals(uint64_t key, uint64_t counter, size_t count, double* normals) {
+    static const FillNormalsFn implementation = selectFillNormals();
+    implementation(key, counter, count, normals);
+}
+
+/**
+ * @brief Move the nearest-rank quantile of values into place
+ * @return Its index; the values after it are all at least as large
+ */
+size_t selectQuantile(std::vector<double>& values, double level) {
+    size_t rank = static_cast<size_t>(std::ceil(level * static_cast<double>(values.size())));
+    size_t index = std::min(values.size() - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return index;
+}
+
+} // namespace
+
+ExecutionMonteCarlo::ExecutionMonteCarlo(const MonteCarloConfig& config) : config_(config) {
+    config_.pathsPerTask = std::max<size_t>(2, config_.pathsPerTask + (config_.pathsPerTask & 1));
+    config_.confidence = std::min(1.0, std::max(0.0, config_.confidence));
+}
+
+CostDistribution ExecutionMonteCarlo::simulate(const std::vector<double>& tradeSizes,
+                                               const ExecutionProblem& problem,
+                                               utils::WorkStealingPool& pool) {
+    CostDistribution distribution;
+    size_t paths = config_.paths;
+    size_t steps = tradeSizes.size();
+    if (paths == 0 || steps == 0) {
+        return distribution;
+    }
+
+    size_t block = config_.pathsPerTask;
+    size_t tasks = (paths + block - 1) / block;
+    size_t stride = tasks * block;  // Normals per step, padded to whole blocks
+    costs_.assign(paths, 0.0);
+    scratch_.resize(pool.threadCount() * 2 * block);
+
+    double tau = problem.timeHorizon / static_cast<double>(steps);
+    double shockScale = problem.volatility * std::sqrt(std::max(0.0, tau));
+    double temporaryPerUnit = tau > 0.0 ? problem.temporaryImpact / tau : 0.0;
+    double permanent = problem.permanentImpact;
+    uint64_t key = mix64(config_.seed);
+
+    pool.parallelFor(tasks, [&](size_t task, size_t worker) {
+        size_t begin = task * block;
+        size_t count = std::min(block, paths - begin);
+        double* cost = costs_.data() + begin;
+        double* drift = scratch_.data() + worker * 2 * block;  // S_{k-1} - S_0
+        double* shocks = drift + block;
+        std::fill(drift, drift + count, 0.0);
+
+        for (size_t k = 0; k < steps; ++k) {
+            double trade = tradeSizes[k];
+            double temporaryCost = temporaryPerUnit * trade * trade;
+            for (size_t p = 0; p < count; ++p) {
+                cost[p] += trade * drift[p] + temporaryCost;
+            }
+            // The move after the last trade costs nothing
+            if (k + 1 == steps) {
+                break;
+            }
+            fillNormals(key, k * stride + begin, block, shocks);
+            double permanentMove = permanent * trade;
+            for (size_t p = 0; p < count; ++p) {
+                drift[p] += shockScale * shocks[p] + permanentMove;
+            }
+        }
+    });
+
+    // Moments in path order, so they do not depend on the schedule of the tasks
+    double sum = 0.0;
+    for (double cost : costs_) {
+        sum += cost;
+    }
+    double mean = sum / static_cast<double>(paths);
+    double squaredDeviations = 0.0;
+    for (double cost : costs_) {
+        squaredDeviations += (cost - mean) * (cost - mean);
+    }
+
+    distribution.paths = paths;
+    distribution.expectedCost = mean;
+    distribution.costStdDev = std::sqrt(squaredDeviations / static_cast<double>(paths));
+    distribution.confidence = config_.confidence;
+    distribution.medianCost = costs_[selectQuantile(costs_, 0.5)];
+    distribution.percentile95 = costs_[selectQuantile(costs_, 0.95)];
+
+    // Selected last, so every cost at or beyond the value at risk follows it
+    size_t tail = selectQuantile(costs_, config_.confidence);
+    distribution.valueAtRisk = costs_[tail];
+    double tailSum = 0.0;
+    double worst = costs_[tail];
+    for (size_t i = tail; i < paths; ++i) {
+        tailSum += costs_[i];
+        worst = std::max(worst, costs_[i]);
+    }
+    distribution.expectedShortfall = tailSum / static_cast<double>(paths - tail);
+    distribution.worstCost = worst;
+    return distribution;
+}
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,160 @@
+#include "models/optimal_execution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+// Below this kappa * T the trajectory is indistinguishable from a straight line
+constexpr double kLinearUrgencyThreshold = 1e-9;
+
+/**
+ * @brief Get the step length of a problem
+ */
+double stepLength(const ExecutionProblem& problem) {
+    return problem.timeHorizon / std::max(1, problem.numSteps);
+}
+
+/**
+ * @brief Get eta_tilde = eta - gamma * tau / 2, the temporary impact net of the
+ *        permanent impact a trade has on itself
+ */
+double effectiveTemporaryImpact(const ExecutionProblem& problem) {
+    double etaTilde = problem.temporaryImpact - 0.5 * problem.permanentImpact * stepLength(problem);
+    // A permanent impact this large makes the discrete problem ill-posed; ignore the correction
+    return etaTilde > 0.0 ? etaTilde : problem.temporaryImpact;
+}
+
+} // namespace
+
+OptimalExecutionEngine::OptimalExecutionEngine(size_t cacheCapacity)
+    : cacheCapacity_(std::max<size_t>(1, cacheCapacity)) {
+}
+
+double OptimalExecutionEngine::urgency(const ExecutionProblem& problem) {
+    double tau = stepLength(problem);
+    double etaTilde = effectiveTemporaryImpact(problem);
+    if (tau <= 0.0 || etaTilde <= 0.0) {
+        return 0.0;
+    }
+
+    double kappaTildeSquared = problem.riskAversion * problem.volatility * problem.volatility / etaTilde;
+    if (kappaTildeSquared <= 0.0) {
+        return 0.0;
+    }
+
+    return std::acosh(1.0 + 0.5 * kappaTildeSquared * tau * tau) / tau;
+}
+
+void OptimalExecutionEngine::schedule(double orderSize, const ExecutionProblem& problem,
+                                      std::vector<double>& tradeSizes) {
+    auto unit = trajectory(urgency(problem), problem.timeHorizon, problem.numSteps);
+
+    tradeSizes.resize(unit->tradeFractions.size());
+    for (size_t i = 0; i < tradeSizes.size(); ++i) {
+        tradeSizes[i] = unit->tradeFractions[i] * orderSize;
+    }
+}
+
+FrontierPoint OptimalExecutionEngine::evaluate(double orderSize, const ExecutionProblem& problem) {
+    auto unit = trajectory(urgency(problem), problem.timeHorizon, problem.numSteps);
+    return price(orderSize, problem, *unit);
+}
+
+void OptimalExecutionEngine::frontier(double orderSize, const ExecutionProblem& problem,
+                                      const double* riskAversions, size_t count,
+                                      FrontierPoint* points) {
+    ExecutionProblem point = problem;
+    for (size_t i = 0; i < count; ++i) {
+        point.riskAversion = riskAversions[i];
+        points[i] = evaluate(orderSize, point);
+    }
+}
+
+size_t OptimalExecutionEngine::cacheSize() const {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return cache_.size();
+}
+
+std::shared_ptr<const OptimalExecutionEngine::Trajectory> OptimalExecutionEngine::trajectory(
+    double kappa, double timeHorizon, int numSteps) {
+    numSteps = std::max(1, numSteps);
+    Key key(kappa, timeHorizon, numSteps);
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            return it->second;
+        }
+    }
+
+    // Build outside the lock; a concurrent miss on the same key just builds it twice
+    auto built = buildTrajectory(kappa, timeHorizon, numSteps);
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cache_.size() >= cacheCapacity_) {
+        cache_.clear();  // Parameters moved on; start over rather than track recency
+    }
+    cache_.emplace(key, built);
+    return built;
+}
+
+std::shared_ptr<const OptimalExecutionEngine::Trajectory> OptimalExecutionEngine::buildTrajectory(
+    double kappa, double timeHorizon, int numSteps) {
+    auto trajectory = std::make_shared<Trajectory>();
+    trajectory->tradeFractions.resize(numSteps);
+
+    bool linear = kappa * timeHorizon < kLinearUrgencyThreshold;
+    double previousHolding = 1.0;
+
+    for (int j = 1; j <= numSteps; ++j) {
+        // Remaining fraction after trade j
+        double holding;
+        if (j == numSteps) {
+            holding = 0.0;
+        } else if (linear) {
+            holding = 1.0 - static_cast<double>(j) / numSteps;
+        } else {
+            // sinh(kappa (T - t)) / sinh(kappa T) in a form that does not overflow
+            double t = timeHorizon * j / numSteps;
+            holding = std::exp(-kappa * t) * -std::expm1(-2.0 * kappa * (timeHorizon - t)) /
+                      -std::expm1(-2.0 * kappa * timeHorizon);
+        }
+
+        double fraction = previousHolding - holding;
+        trajectory->tradeFractions[j - 1] = fraction;
+        trajectory->sumSquaredTrades += fraction * fraction;
+        trajectory->sumSquaredHoldings += holding * holding;
+        previousHolding = holding;
+    }
+
+    return trajectory;
+}
+
+FrontierPoint OptimalExecutionEngine::price(double orderSize, const ExecutionProblem& problem,
+                                            const Trajectory& trajectory) {
+    double tau = stepLength(problem);
+    double squaredSize = orderSize * orderSize;
+
+    FrontierPoint point;
+    point.riskAversion = problem.riskAversion;
+
+    // E = gamma X^2 / 2 + (eta_tilde / tau) * sum n_j^2
+    point.expectedCost = 0.5 * problem.permanentImpact * squaredSize;
+    if (tau > 0.0) {
+        point.expectedCost += effectiveTemporaryImpact(problem) / tau * squaredSize *
+                              trajectory.sumSquaredTrades;
+    }
+
+    // V = sigma^2 tau * sum x_j^2
+    point.costVariance = problem.volatility * problem.volatility * tau * squaredSize *
+                         trajectory.sumSquaredHoldings;
+    return point;
+}
+
+} // namespace models
+} // namespace trade_simulator 
@@ -0,0 +1,27 @@
+#include "models/output_bus.h"
+
+namespace trade_simulator {
+namespace models {
+
+OutputBusPublisher::OutputBusPublisher(const std::string& name, size_t capacity)
+    : region_(utils::SharedMemoryRegion::create(
+          name, utils::BroadcastRingWriter<OutputBusRecord>::bytesFor(capacity))),
+      ring_(std::make_unique<utils::BroadcastRingWriter<OutputBusRecord>>(
+          region_.data(), capacity, kOutputBusLayoutVersion)) {
+}
+
+void OutputBusPublisher::publish(const SimulatorOutput& output, const data::OrderbookStats& stats) {
+    OutputBusRecord record;
+    record.output = output;
+    record.stats = stats;
+    ring_->publish(record);
+}
+
+OutputBusReader::OutputBusReader(const std::string& name)
+    : region_(utils::SharedMemoryRegion::open(name)),
+      ring_(std::make_unique<utils::BroadcastRingReader<OutputBusRecord>>(
+          region_.data(), region_.size(), kOutputBusLayoutVersion)) {
+}
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,147 @@
+#include "models/output_sink.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+namespace net = boost::asio;
+using udp = net::ip::udp;
+
+// Longest row: an instrument name, two 19-digit stamps and nine doubles at 17 significant digits and a flag
+constexpr size_t kRowCapacity = 640;
+
+/**
+ * @brief CSV rows to a stream, buffered by the stream
+ */
+class StreamOutputSink : public OutputSink {
+public:
+    // Write to stdout
+    explicit StreamOutputSink(bool instrumentColumn) : out_(&std::cout) {
+        writeHeader(instrumentColumn);
+    }
+
+    // Write to a new file
+    StreamOutputSink(const std::string& path, bool instrumentColumn)
+        : file_(std::make_unique<std::ofstream>(path, std::ios::trunc)), out_(file_.get()) {
+        if (!*file_) {
+            throw std::runtime_error("Cannot create output file: " + path);
+        }
+        writeHeader(instrumentColumn);
+    }
+
+    ~StreamOutputSink() override {
+        flush();
+    }
+
+    void publish(const SimulatorOutput& output, const char* instrument) override {
+        char row[kRowCapacity];
+        size_t length = formatOutputCsv(output, row, sizeof(row), instrument);
+        out_->write(row, static_cast<std::streamsize>(length));
+    }
+
+    void flush() override {
+        out_->flush();
+    }
+
+private:
+    std::unique_ptr<std::ofstream> file_;
+    std::ostream* out_;
+
+    void writeHeader(bool instrumentColumn) {
+        if (instrumentColumn) {
+            *out_ << kInstrumentCsvColumn;
+        }
+        *out_ << kOutputCsvHeader << '\n';
+    }
+};
+
+/**
+ * @brief One CSV row per UDP datagram; rows are dropped rather than waited on
+ */
+class UdpOutputSink : public OutputSink {
+public:
+    UdpOutputSink(const std::string& host, const std::string& port) : socket_(ioc_) {
+        udp::resolver resolver(ioc_);
+        boost::system::error_code ec;
+        auto endpoints = resolver.resolve(host, port, ec);
+        if (ec || endpoints.empty()) {
+            throw std::runtime_error("Cannot resolve output address " + host + ":" + port);
+        }
+        endpoint_ = *endpoints.begin();
+        socket_.open(endpoint_.protocol());
+        socket_.non_blocking(true);
+    }
+
+    void publish(const SimulatorOutput& output, const char* instrument) override {
+        char row[kRowCapacity];
+        size_t length = formatOutputCsv(output, row, sizeof(row), instrument);
+        boost::system::error_code ec;
+        socket_.send_to(net::buffer(row, length), endpoint_, 0, ec);  // Dropped if full
+    }
+
+private:
+    net::io_context ioc_;
+    udp::socket socket_;
+    udp::endpoint endpoint_;
+};
+
+} // namespace
+
+const char* const kOutputCsvHeader =
+    "published_ns,read_ns,midprice,spread,volatility,slippage,fees,market_impact,"
+    "net_cost,maker_proportion,internal_latency_us,stale,fill_probability,time_to_fill_s";
+
+const char* const kInstrumentCsvColumn = "instrument,";
+
+size_t formatOutputCsv(const SimulatorOutput& output, char* buffer, size_t capacity,
+                       const char* instrument) {
+    int prefix = instrument ? std::snprintf(buffer, capacity, "%s,", instrument) : 0;
+    if (prefix < 0 || static_cast<size_t>(prefix) >= capacity) {
+        return 0;
+    }
+    buffer += prefix;
+    capacity -= static_cast<size_t>(prefix);
+
+    int length = std::snprintf(
+        buffer, capacity,
+        "%" PRId64 ",%" PRId64 ",%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%d,%.17g,%.17g\n",
+        output.publishedNs, output.readNs, output.midprice, output.spread,
+        output.marketVolatility, output.expectedSlippage, output.expectedFees,
+        output.expectedMarketImpact, output.netCost, output.makerProportion,
+        output.internalLatency, output.stale ? 1 : 0, output.fillProbability,
+        output.expectedTimeToFill);
+    if (length < 0 || static_cast<size_t>(length) >= capacity) {
+        return 0;
+    }
+    return static_cast<size_t>(prefix + length);
+}
+
+std::unique_ptr<OutputSink> createOutputSink(const std::string& target, bool instrumentColumn) {
+    static const std::string kUdpScheme = "udp://";
+
+    if (target.empty() || target == "-") {
+        return std::make_unique<StreamOutputSink>(instrumentColumn);
+    }
+    if (target.compare(0, kUdpScheme.size(), kUdpScheme) == 0) {
+        std::string address = target.substr(kUdpScheme.size());
+        size_t colon = address.rfind(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+            throw std::runtime_error("Expected udp://host:port, got " + target);
+        }
+        return std::make_unique<UdpOutputSink>(address.substr(0, colon), address.substr(colon + 1));
+    }
+    return std::make_unique<StreamOutputSink>(target, instrumentColumn);
+}
+
+} // namespace models
+} // namespace trade_simulator
@@ -0,0 +1,249 @@
+#include "models/parameter_sweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "data/book_store.h"
+#include "data/feed_adapter.h"
+#include "data/feed_log_reader.h"
+#include "data/orderbook_processor.h"
+#include "models/optimal_execution.h"
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+// Updates per task; large enough to amortize the per-task model setup
+constexpr size_t kTicksPerTask = 4096;
+
+// Running sums of one configuration and quantity over a block of updates
+struct SweepAccumulator {
+    uint64_t ticks = 0;
+    double slippage = 0.0;
+    double walkedSlippage = 0.0;
+    double squaredSlippageError = 0.0;
+    double marketImpact = 0.0;
+    double fees = 0.0;
+    double totalCost = 0.0;
+    double executionCost = 0.0;
+    double executionVariance = 0.0;
+
+    void add(const SweepAccumulator& other) {
+        ticks += other.ticks;
+        slippage += other.slippage;
+        walkedSlippage += other.walkedSlippage;
+        squaredSlippageError += other.squaredSlippageError;
+        marketImpact += other.marketImpact;
+        fees += other.fees;
+        totalCost += other.totalCost;
+        executionCost += other.executionCost;
+        executionVariance += other.executionVariance;
+    }
+};
+
+// Index of each grid dimension, the last one varying fastest
+size_t gridDigit(size_t& index, size_t count) {
+    size_t digit = index % count;
+    index /= count;
+    return digit;
+}
+
+} // namespace
+
+SweepSession SweepSession::load(const std::string& path, const std::vector<double>& quantities,
+                                const data::VolatilityConfig& volatilityConfig,
+                                const std::string& symbol) {
+    SweepSession session;
+    session.quantities_ = quantities;
+    session.symbol_ = symbol;
+
+    data::OrderbookProcessor processor(
+        [&session, &processor](const data::OrderbookStats& stats) {
+            session.stats_.push_back(stats);
+            const data::DepthProfile& profile = processor.getDepthProfile();
+            for (double quantity : session.quantities_) {
+                double baseQuantity = stats.midprice > 0.0 ? quantity / stats.midprice : 0.0;
+                session.fills_.push_back(profile.walk(baseQuantity, true));
+            }
+        },
+        volatilityConfig);
+
+    data::SymbolId symbolId = data::internSymbol(symbol);
+    auto process = [&session, &processor, &symbolId](const data::OrderbookData& orderbook) {
+        if (symbolId == data::kNoSymbol) {
+            symbolId = orderbook.symbol;
+            session.symbol_ = std::string(data::symbolName(symbolId));
+        }
+        if (orderbook.symbol == symbolId) {
+            processor.processOrderbook(orderbook);
+        }
+    };
+
+    data::OrderbookData orderbook;
+    if (data::BookStoreReader::isBookStore(path)) {
+        data::BookStoreReader reader(path);
+        while (reader.next(orderbook)) {
+            process(orderbook);
+        }
+    } else {
+        data::FeedLogReader reader(path);
+        data::FeedLogRecord record;
+        data::FeedDecoder decoder;
+        while (reader.next(record)) {
+            if (decoder.decode(record.message, orderbook) == data::DecodeResult::Ignored) {
+                continue;
+            }
+            orderbook.received_time = std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(record.receivedTime));
+            process(orderbook);
+        }
+    }
+    return session;
+}
+
+size_t SweepGrid::configurationCount() const {
+    return permanentImpactFactors.size() * temporaryImpactFactors.size() * riskAversions.size() *
+           feeTiers.size() * slippageVolumeFactors.size() * slippageVolatilityFactors.size() *
+           slippageImbalanceFactors.size();
+}
+
+SweepConfiguration sweepConfiguration(const SweepGrid& grid, size_t index) {
+    SweepConfiguration configuration;
+    configuration.slippage.imbalanceFactor =
+        grid.slippageImbalanceFactors[gridDigit(index, grid.slippageImbalanceFactors.size())];
+    configuration.slippage.volatilityFactor =
+        grid.slippageVolatilityFactors[gridDigit(index, grid.slippageVolatilityFactors.size())];
+    configuration.slippage.volumeFactor =
+        grid.slippageVolumeFactors[gridDigit(index, grid.slippageVolumeFactors.size())];
+    configuration.fees = FeeModel::forTier(grid.feeTiers[gridDigit(index, grid.feeTiers.size())]);
+    configuration.impact.riskAversion =
+        grid.riskAversions[gridDigit(index, grid.riskAversions.size())];
+    configuration.impact.temporaryImpactFactor =
+        grid.temporaryImpactFactors[gridDigit(index, grid.temporaryImpactFactors.size())];
+    configuration.impact.permanentImpactFactor =
+        grid.permanentImpactFactors[gridDigit(index, grid.permanentImpactFactors.size())];
+    configuration.impact.volatility = grid.volatility;
+    configuration.impact.timeHorizon = grid.timeHorizon;
+    configuration.executionSteps = std::max(1, grid.executionSteps);
+    return configuration;
+}
+
+std::vector<SweepResult> runParameterSweep(const SweepSession& session, const SweepGrid& grid,
+                                           utils::WorkStealingPool& pool) {
+    const size_t configurations = grid.configurationCount();
+    const size_t quantities = session.quantities().size();
+    const size_t ticks = session.tickCount();
+    const size_t blocks = std::max<size_t>(1, (ticks + kTicksPerTask - 1) / kTicksPerTask);
+
+    // One slot per task, written only by the worker running it
+    std::vector<std::vector<SweepAccumulator>> slots(
+        configurations * blocks, std::vector<SweepAccumulator>(quantities));
+
+    pool.parallelFor(configurations * blocks, [&](size_t task, size_t /*worker*/) {
+        SweepConfiguration configuration = sweepConfiguration(grid, task / blocks);
+        size_t begin = (task % blocks) * kTicksPerTask;
+        size_t end = std::min(ticks, begin + kTicksPerTask);
+
+        auto impactModel = std::make_shared<MarketImpactModel>(configuration.impact);
+        TransactionCostModel costModel(impactModel, configuration.fees);
+        costModel.setSlippageCoefficients(configuration.slippage);
+        OptimalExecutionEngine executionEngine;
+
+        ExecutionProblem problem;
+        problem.permanentImpact = configuration.impact.permanentImpactFactor;
+        problem.temporaryImpact = configuration.impact.temporaryImpactFactor;
+        problem.timeHorizon = configuration.impact.timeHorizon;
+        problem.riskAversion = configuration.impact.riskAversion;
+        problem.numSteps = configuration.executionSteps;
+
+        std::vector<SweepAccumulator>& sums = slots[task];
+        for (size_t tick = begin; tick < end; ++tick) {
+            const data::OrderbookStats& stats = session.stats(tick);
+            if (stats.midprice <= 0.0) {
+                continue;
+            }
+            problem.volatility = configuration.impact.volatility > 0.0
+                                     ? configuration.impact.volatility
+                                     : stats.price_volatility;
+            bool liquid = stats.total_ask_size > 0.0 && stats.total_bid_size > 0.0;
+
+            for (size_t q = 0; q < quantities; ++q) {
+                double baseQuantity = session.quantities()[q] / stats.midprice;
+                double slippage = costModel.calculateSlippage(baseQuantity, true, stats);
+                auto [walkedSlippage, marketImpact, fees, totalCost] =
+                    costModel.calculateTotalCost(baseQuantity, true, stats, session.fill(tick, q));
+
+                SweepAccumulator& sum = sums[q];
+                ++sum.ticks;
+                sum.slippage += slippage;
+                sum.walkedSlippage += walkedSlippage;
+                sum.squaredSlippageError += (slippage - walkedSlippage) * (slippage - walkedSlippage);
+                sum.marketImpact += marketImpact;
+                sum.fees += fees;
+                sum.totalCost += totalCost;
+                if (liquid) {
+                    FrontierPoint execution = executionEngine.evaluate(baseQuantity, problem);
+                    sum.executionCost += execution.expectedCost;
+                    sum.executionVariance += execution.costVariance;
+                }
+            }
+        }
+    });
+
+    // Reduce the blocks of each configuration in order
+    std::vector<SweepResult> results;
+    results.reserve(configurations * quantities);
+    for (size_t c = 0; c < configurations; ++c) {
+        SweepConfiguration configuration = sweepConfiguration(grid, c);
+        for (size_t q = 0; q < quantities; ++q) {
+            SweepAccumulator total;
+            for (size_t b = 0; b < blocks; ++b) {
+                total.add(slots[c * blocks + b][q]);
+            }
+
+            SweepResult result;
+            result.configuration = configuration;
+            result.quantity = session.quantities()[q];
+            result.ticks = total.ticks;
+            if (total.ticks > 0) {
+                double n = static_cast<double>(total.ticks);
+                result.meanSlippage = total.slippage / n;
+                result.meanWalkedSlippage = total.walkedSlippage / n;
+                result.slippageRmse = std::sqrt(total.squaredSlippageError / n);
+                result.meanMarketImpact = total.marketImpact / n;
+                result.meanFees = total.fees / n;
+                result.meanTotalCost = total.totalCost / n;
+                result.meanExecutionCost = total.executionCost / n;
+                result.meanExecutionVariance = total.executionVariance / n;
+            }
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+void writeSweepCsv(std::ostream& out, const std::vector<SweepResult>& results) {
+    out << "permanent_impact,temporary_impact,risk_aversion,fee_tier,"
+           "slippage_volume,slippage_volatility,slippage_imbalance,quantity,ticks,"
+           "slippage,walked_slippage,slippage_rmse,market_impact,fees,total_cost,"
+           "execution_cost,execution_variance\n";
+
+    auto precision = out.precision(10);
+    for (const SweepResult& result : results) {
+        const SweepConfiguration& c = result.configuration;
+        out << c.impact.permanentImpactFactor << ',' << c.impact.temporaryImpactFactor << ','
+            << c.impact.riskAversion << ',' << c.fees.feeTier << ','
+            << c.slippage.volumeFactor << ',' << c.slippage.volatilityFactor << ','
+            << c.slippage.imbalanceFactor << ',' << result.quantity << ',' << result.ticks << ','
+            << result.meanSlippage << ',' << result.meanWalkedSlippage << ','
+            << result.slippageRmse << ',' << result.meanMarketImpact << ','
+            << result.meanFees << ',' << result.meanTotalCost << ','
+            << result.meanExecutionCost << ',' << result.meanExecutionVariance << '\n';
+    }
+    out.precision(precision);
+}
+
+} // namespace models
+} // namespace trade_simulator 
\ No newline at end of file
@@ -1,13 +1,22 @@
 #include "models/simulator.h"
+#include "data/feed_adapter.h"
+#include "data/live_feed_source.h"
+#include "models/output_bus.h"
 #include <iostream>
 #include <chrono>
 #include <functional>
+#include <algorithm>
+#include <cmath>
 
 namespace trade_simulator {
 namespace models {
 
-Simulator::Simulator(SimulatorCallback callback)
-    : callback_(std::move(callback)) {
+Simulator::Simulator(SimulatorCallback callback, const SimulatorConfig& config)
+    : callback_(std::move(callback)),
+      config_(config),
+      pricingParams_(PricingParams(params_)),
+      queueTracker_(config.queueTracker),
+      stalenessBreaker_(config.staleness) {
     
     initializeComponents();
 }
@@ -23,9 +32,23 @@ void Simulator::start() {
     
     isRunning_ = true;
     
-   
-    if (webSocketClient_) {
-        webSocketClient_->start();
+    // Start the consumer before the producer
+    if (orderbookDispatcher_) {
+        orderbookDispatcher_->start();
+    }
+    
+    if (feedSource_) {
+        feedSource_->start();
+    }
+    
+    if (monteCarlo_) {
+        {
+            std::lock_guard<std::mutex> lock(riskMutex_);
+            riskStopRequested_ = false;
+        }
+        riskThread_ = std::thread([this]() {
+            runExecutionRisk();
+        });
     }
 }
 
@@ -36,15 +59,39 @@ void Simulator::stop() {
     
     isRunning_ = false;
     
-   
-    if (webSocketClient_) {
-        webSocketClient_->stop();
+    if (feedSource_) {
+        feedSource_->stop();
+    }
+    
+    if (orderbookDispatcher_) {
+        orderbookDispatcher_->stop();
+    }
+    
+    if (riskThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(riskMutex_);
+            riskStopRequested_ = true;
+        }
+        riskWakeup_.notify_all();
+        riskThread_.join();
     }
 }
 
 void Simulator::updateParams(const SimulatorParams& params) {
     std::lock_guard<std::mutex> lock(paramsMutex_);
+    bool instrumentChanged = params.exchange != params_.exchange || params.symbol != params_.symbol;
     params_ = params;
+    pricingParams_.store(PricingParams(params_));
+    
+    // Switch the feed to the newly selected instrument
+    if (instrumentChanged && feedSource_) {
+        if (orderbookProcessor_) {
+            orderbookProcessor_->reset();
+        }
+        calibrationResetPending_ = true;
+        stalenessBreaker_.reset();
+        feedSource_->selectInstrument(params_.exchange, instrumentFor(params_));
+    }
     
     // Update market impact model with new volatility
     if (marketImpactModel_) {
@@ -55,27 +102,11 @@ void Simulator::updateParams(const SimulatorParams& params) {
     
     // Update fee model with new fee tier
     if (transactionCostModel_) {
-        auto currentFeeModel = transactionCostModel_->getFeeModel();
-        currentFeeModel.feeTier = params_.feeTier;
-        
-        // Adjust fee rates based on tier
-        // Higher tier means lower fees
-        if (params_.feeTier == 0) {
-            currentFeeModel.makerFeeRate = 0.0002;  // 0.02%
-            currentFeeModel.takerFeeRate = 0.0005;  // 0.05%
-        } else if (params_.feeTier == 1) {
-            currentFeeModel.makerFeeRate = 0.00015;  // 0.015%
-            currentFeeModel.takerFeeRate = 0.0004;   // 0.04%
-        } else if (params_.feeTier == 2) {
-            currentFeeModel.makerFeeRate = 0.0001;   // 0.01%
-            currentFeeModel.takerFeeRate = 0.0003;   // 0.03%
-        } else if (params_.feeTier >= 3) {
-            currentFeeModel.makerFeeRate = 0.00005;  // 0.005%
-            currentFeeModel.takerFeeRate = 0.0002;   // 0.02%
-        }
-        
-        transactionCostModel_->setFeeModel(currentFeeModel);
+        transactionCostModel_->setFeeModel(FeeModel::forTier(params_.feeTier));
     }
+    
+    // After the models, so costs memoized under the new version see the new parameters
+    parametersVersion_.fetch_add(1, std::memory_order_release);
 }
 
 SimulatorParams Simulator::getParams() const {
@@ -84,20 +115,63 @@ SimulatorParams Simulator::getParams() const {
 }
 
 SimulatorOutput Simulator::getLatestOutput() const {
-    std::lock_guard<std::mutex> lock(outputMutex_);
-    return latestOutput_;
+    return latestOutput_.load();
+}
+
+CostSurface Simulator::getLatestCostSurface() const {
+    std::lock_guard<std::mutex> lock(costSurfaceMutex_);
+    return latestCostSurface_;
+}
+
+CostDistribution Simulator::getLatestCostDistribution() const {
+    return latestCostDistribution_.load();
 }
 
 bool Simulator::isRunning() const {
     return isRunning_;
 }
 
+bool Simulator::isFeedConnected() const {
+    return feedSource_ && feedSource_->isConnected();
+}
+
+CostMemoStats Simulator::getCostMemoStats() const {
+    return costMemo_ ? costMemo_->stats() : CostMemoStats();
+}
+
+bool Simulator::isStale() const {
+    return stalenessBreaker_.isStale(utils::nowNanoseconds());
+}
+
+data::DispatcherStats Simulator::getQueueStats() const {
+    return orderbookDispatcher_ ? orderbookDispatcher_->getStats() : data::DispatcherStats();
+}
+
 void Simulator::initializeComponents() {
     // Create market impact model
     marketImpactModel_ = std::make_shared<MarketImpactModel>();
     
     // Create transaction cost model
     transactionCostModel_ = std::make_shared<TransactionCostModel>(marketImpactModel_);
+    if (config_.calibrateSlippage) {
+        slippageCalibrator_ = std::make_unique<SlippageCalibrator>(transactionCostModel_,
+                                                                   config_.slippageCalibration);
+    }
+    if (config_.memoizeCosts) {
+        costMemo_ = std::make_unique<CostMemo>(transactionCostModel_, config_.costMemo);
+    }
+    
+    // Broadcast to other processes, if asked to
+    if (!config_.outputBusName.empty()) {
+        outputBus_ = std::make_unique<OutputBusPublisher>(config_.outputBusName,
+                                                          config_.outputBusCapacity);
+    }
+    
+    // Execution risk is simulated on workers of its own, so the processing thread never waits
+    if (config_.simulateExecutionRisk) {
+        riskPool_ = std::make_unique<utils::WorkStealingPool>(config_.monteCarlo.threads);
+        monteCarlo_ = std::make_unique<ExecutionMonteCarlo>(config_.monteCarlo);
+    }
     
     // Create orderbook processor
     orderbookProcessor_ = std::make_shared<data::OrderbookProcessor>(
@@ -105,15 +179,43 @@ void Simulator::initializeComponents() {
             onOrderbookStats(stats);
         }
     );
+    orderbookProcessor_->setLatencyRecorder(&latency_);
+    orderbookProcessor_->setQueueTracker(&queueTracker_);
     
-    // Create websocket client
-    webSocketClient_ = std::make_shared<data::WebSocketClient>(
-        [this](const data::OrderbookData& data) {
-            if (orderbookProcessor_) {
-                orderbookProcessor_->processOrderbook(data);
-            }
-        }
-    );
+    // Processing runs on its own thread, fed through a lock-free SPSC queue.
+    // A replay at full speed must not conflate, or runs would differ.
+    data::DispatcherConfig dispatcherConfig = config_.dispatcher;
+    if (!config_.replayPath.empty() && config_.replayMode == data::ReplayMode::AsFastAsPossible) {
+        dispatcherConfig.overflowPolicy = data::OverflowPolicy::Block;
+    }
+    orderbookDispatcher_ = std::make_shared<data::OrderbookDispatcher>(
+        orderbookProcessor_, dispatcherConfig);
+    
+    // Create the feed source; both deliver from a single thread, as the dispatcher requires
+    auto onOrderbook = [this](const data::OrderbookData& data) {
+        orderbookDispatcher_->submit(data);
+    };
+    if (config_.replayPath.empty()) {
+        feedSource_ = std::make_shared<data::LiveFeedSource>(onOrderbook, config_.recordPath,
+                                                             config_.networkThread, config_.hotStandby);
+    } else {
+        data::ReplayConfig replayConfig(config_.replayPath, config_.replayMode);
+        replayConfig.speed = config_.replaySpeed;
+        replayConfig.cpu = config_.networkThread.cpu;
+        feedSource_ = std::make_shared<data::ReplayFeedSource>(onOrderbook, replayConfig);
+    }
+    feedSource_->selectInstrument(params_.exchange, instrumentFor(params_));
+    
+    // An incremental book that lost sync is rebuilt from the snapshot sent on resubscribe
+    orderbookProcessor_->setResyncCallback([this]() {
+        feedSource_->resubscribe();
+    });
+}
+
+std::string Simulator::instrumentFor(const SimulatorParams& params) {
+    // The simulator prices perpetual swaps, e.g. BTC-USDT -> BTC-USDT-SWAP on OKX
+    std::optional<data::Venue> venue = data::parseVenue(params.exchange);
+    return data::perpetualInstrument(venue.value_or(data::Venue::Okx), params.symbol);
 }
 
 void Simulator::onOrderbookStats(const data::OrderbookStats& stats) {
@@ -121,32 +223,38 @@ void Simulator::onOrderbookStats(const data::OrderbookStats& stats) {
         return;
     }
     
-    auto startTime = std::chrono::high_resolution_clock::now();
+    auto startTime = std::chrono::steady_clock::now();
     
     // Update the simulation with the new stats
-    updateSimulation(stats);
+    SimulatorOutput output;
+    updateSimulation(stats, output);
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    auto endTime = std::chrono::steady_clock::now();
+    auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+    output.internalLatency = static_cast<double>(latency) / 1000.0;
+    latency_.stage(utils::LatencyStage::Models).record(latency);
     
-    // Update internal latency in the output
-    {
-        std::lock_guard<std::mutex> lock(outputMutex_);
-        latestOutput_.internalLatency = static_cast<double>(latency);
+    // Publish the output; while the book is stale only the latest output is kept, flagged
+    output.readNs = stats.read_ns;
+    output.publishedNs = utils::nowNanoseconds();
+    output.stale = stalenessBreaker_.check(stats, output.publishedNs);
+    latestOutput_.store(output);
+    if (stalenessBreaker_.suppressing()) {
+        return;
+    }
+    if (outputBus_) {
+        outputBus_->publish(output, stats);
     }
+    
+    // Notify callback
+    callback_(output); 
 }
 
-void Simulator::updateSimulation(const data::OrderbookStats& stats) {
+void Simulator::updateSimulation(const data::OrderbookStats& stats, SimulatorOutput& output) {
     // Get a copy of the current parameters
-    SimulatorParams params;
-    {
-        std::lock_guard<std::mutex> lock(paramsMutex_);
-        params = params_;
-    }
+    PricingParams params = pricingParams_.load();
     
-    // Create a new output structure
-    SimulatorOutput output;
-     
+
     // Set market metrics 
     output.midprice = stats.midprice;
     output.spread = stats.spread;
@@ -161,10 +269,34 @@ void Simulator::updateSimulation(const data::OrderbookStats& stats) {
     // Default to buy side
     bool orderSide = true;
     
-    // Calculate transaction costs
-    if (transactionCostModel_) {
+    // Walk the order against the book the stats were computed from, once for both uses
+    const data::DepthProfile& profile = orderbookProcessor_->getDepthProfile();
+    data::FillEstimate fill = profile.walk(baseQuantity, orderSide);
+    
+    // Calibrate the slippage regression on this book's fills of the order, both sides
+    if (slippageCalibrator_) {
+        if (calibrationResetPending_.exchange(false)) {
+            slippageCalibrator_->reset();
+        }
+        slippageCalibrator_->observe(baseQuantity, orderSide, stats, fill);
+        slippageCalibrator_->observe(baseQuantity, !orderSide, stats, profile.walk(baseQuantity, !orderSide));
+    }
+    
+    // Calculate transaction costs, from the memo when the inputs have not moved
+    if (params.limitOrder && transactionCostModel_) {
+        priceLimitOrder(baseQuantity, orderSide, params, stats, output);
+    } else if (costMemo_) {
+        MemoizedCost cost = costMemo_->evaluate(baseQuantity, orderSide, stats, fill,
+                                                parametersVersion_.load(std::memory_order_acquire));
+        output.expectedSlippage = cost.slippage;
+        output.expectedMarketImpact = cost.marketImpact;
+        output.expectedFees = cost.fees;
+        output.netCost = cost.totalCost;
+        output.makerProportion = cost.makerProportion;
+        output.costsChanged = cost.changed;
+    } else if (transactionCostModel_) {
         auto [slippage, marketImpact, fees, totalCost] = 
-            transactionCostModel_->calculateTotalCost(baseQuantity, orderSide, stats);
+            transactionCostModel_->calculateTotalCost(baseQuantity, orderSide, stats, fill);
         
         output.expectedSlippage = slippage;
         output.expectedMarketImpact = marketImpact;
@@ -174,14 +306,99 @@ void Simulator::updateSimulation(const data::OrderbookStats& stats) {
             baseQuantity, orderSide, stats);
     }
     
-    // Update latest output
-    {
-        std::lock_guard<std::mutex> lock(outputMutex_);
-        latestOutput_ = output;
-    } 
+    // Evaluate the full cost curves of both sides
+    updateCostSurface(params, stats);
+}
+
+void Simulator::priceLimitOrder(double baseQuantity, bool orderSide, const PricingParams& params,
+                                const data::OrderbookStats& stats, SimulatorOutput& output) {
+    // Keep the order at the touch; a requote joins the back of the queue again
+    double touch = orderSide ? stats.best_bid : stats.best_ask;
+    data::VirtualOrderState order = queueTracker_.order(limitOrder_);
+    bool outbid = orderSide ? order.price < touch : order.price > touch;
+    if (!order.valid || order.filled || outbid || limitOrderQuantity_ != params.quantity) {
+        queueTracker_.remove(limitOrder_);
+        const data::L2Book& book = orderbookProcessor_->getBook();
+        limitOrder_ = queueTracker_.place(orderSide, touch, baseQuantity, book.sizeAt(orderSide, touch));
+        limitOrderQuantity_ = params.quantity;
+    }
     
-    // Notify callback
-    callback_(output); 
+    data::FillForecast forecast = queueTracker_.forecast(limitOrder_, config_.limitOrderHorizonSeconds);
+    double takerSize = baseQuantity * (1.0 - forecast.makerProportion);
+    data::FillEstimate takerFill = orderbookProcessor_->getDepthProfile().walk(takerSize, orderSide);
+    auto [slippage, marketImpact, fees, totalCost] = transactionCostModel_->calculateLimitOrderCost(
+        baseQuantity, orderSide, stats, takerFill, forecast.makerProportion);
+    
+    output.expectedSlippage = slippage;
+    output.expectedMarketImpact = marketImpact;
+    output.expectedFees = fees;
+    output.netCost = totalCost;
+    output.makerProportion = forecast.makerProportion;
+    output.fillProbability = forecast.fillProbability;
+    output.expectedTimeToFill = forecast.expectedTimeToFill;
+    output.queueAhead = forecast.queueAhead;
+}
+
+void Simulator::runExecutionRisk() {
+    auto interval = std::chrono::milliseconds(std::max(1, config_.monteCarlo.intervalMs));
+    int steps = std::max(1, config_.monteCarlo.executionSteps);
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(riskMutex_);
+            if (riskWakeup_.wait_for(lock, interval, [this]() { return riskStopRequested_; })) {
+                return;
+            }
+        }
+        
+        data::OrderbookStats stats = orderbookProcessor_->getLatestStats();
+        if (stats.midprice <= 0.0) {
+            continue;
+        }
+        
+        // The schedule and problem the simulator prices, for a buy of the current quantity
+        PricingParams params = pricingParams_.load();
+        double baseQuantity = params.quantity / stats.midprice;
+        std::vector<double> schedule =
+            marketImpactModel_->calculateOptimalExecution(baseQuantity, true, stats, steps);
+        ExecutionProblem problem = marketImpactModel_->executionProblem(stats, steps);
+        latestCostDistribution_.store(monteCarlo_->simulate(schedule, problem, *riskPool_));
+    }
+}
+
+void Simulator::updateCostSurface(const PricingParams& params, const data::OrderbookStats& stats) {
+    size_t points = std::min(static_cast<size_t>(std::max(params.costCurvePoints, 0)),
+                             CostSurface::kMaxPoints);
+    if (!transactionCostModel_ || points == 0 || stats.midprice <= 0.0 ||
+        params.costCurveMinQuantity <= 0.0) {
+        return;
+    }
+    
+    // Geometric grid of order sizes, converted from USD to base units
+    double maxQuantity = std::max(params.costCurveMaxQuantity, params.costCurveMinQuantity);
+    double step = points > 1
+        ? std::pow(maxQuantity / params.costCurveMinQuantity, 1.0 / static_cast<double>(points - 1))
+        : 1.0;
+    costCurveSizes_.resize(points);
+    double quantity = params.costCurveMinQuantity;
+    for (size_t i = 0; i < points; ++i) {
+        costCurveSizes_[i] = quantity / stats.midprice;
+        quantity *= step;
+    }
+    
+    const data::DepthProfile& profile = orderbookProcessor_->getDepthProfile();
+    transactionCostModel_->calculateCostCurve(costCurveSizes_.data(), points, true, stats,
+                                              &profile, workingCostSurface_.buy);
+    transactionCostModel_->calculateCostCurve(costCurveSizes_.data(), points, false, stats,
+                                              &profile, workingCostSurface_.sell);
+    workingCostSurface_.midprice = stats.midprice;
+    
+    // Swapping keeps both surfaces' storage, so steady-state updates do not allocate;
+    // while a reader is copying the latest surface this one is dropped instead of waiting
+    std::unique_lock<std::mutex> lock(costSurfaceMutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+        std::swap(workingCostSurface_, latestCostSurface_);
+    }
 }
 
 } // namespace models
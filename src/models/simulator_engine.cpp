@@ -0,0 +1,403 @@
+#include "models/simulator_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+
+#include "data/feed_adapter.h"
+#include "data/orderbook_processor.h"
+#include "models/market_impact.h"
+#include "models/transaction_cost.h"
+#include "utils/seqlock.h"
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+// Idle loop tuning of the shard threads, as for the dispatcher's processing thread
+constexpr int kIdleSpinsBeforeSleep = 1000;
+constexpr int kIdleSleepMicros = 50;
+
+} // namespace
+
+/**
+ * @brief Book, models and latest output of one instrument, touched only by its shard
+ */
+struct SimulatorEngine::Instrument {
+    EngineInstrumentConfig config;
+    size_t index;
+    SimulatorEngine& engine;
+
+    std::shared_ptr<MarketImpactModel> impactModel;
+    std::shared_ptr<TransactionCostModel> costModel;
+    std::unique_ptr<SlippageCalibrator> calibrator;
+    std::unique_ptr<CostMemo> costMemo;
+    std::shared_ptr<data::OrderbookProcessor> processor;
+    std::unique_ptr<data::OrderbookDispatcher> dispatcher;
+    data::FeedId feedId = 0;
+    StalenessBreaker staleness;
+
+    // Published for readers on other threads
+    utils::SeqLock<SimulatorOutput> latest;
+    std::atomic<uint64_t> updates{0};
+
+    // Routing: this venue's quote for every instrument's router, and the route it made last
+    utils::SeqLock<VenueQuote> quote;
+    utils::SeqLock<RouteAllocation> route;
+    std::unique_ptr<SmartOrderRouter> router;
+    std::vector<VenueQuote> venueQuotes;
+
+    Instrument(const EngineInstrumentConfig& instrumentConfig, size_t instrumentIndex,
+               SimulatorEngine& owner, const data::DispatcherConfig& dispatcherConfig)
+        : config(instrumentConfig), index(instrumentIndex), engine(owner),
+          staleness(owner.config_.staleness) {
+        AlmgrenChrissParams impactParams;
+        impactParams.volatility = config.volatility;
+        impactModel = std::make_shared<MarketImpactModel>(impactParams);
+        costModel = std::make_shared<TransactionCostModel>(impactModel, FeeModel::forTier(config.feeTier));
+        if (engine.config_.calibrateSlippage) {
+            calibrator = std::make_unique<SlippageCalibrator>(costModel, engine.config_.slippageCalibration);
+        }
+        if (engine.config_.memoizeCosts) {
+            costMemo = std::make_unique<CostMemo>(costModel, engine.config_.costMemo);
+        }
+        if (engine.config_.routing.quantity > 0.0) {
+            router = std::make_unique<SmartOrderRouter>(engine.config_.routing.slices);
+            venueQuotes.resize(engine.config_.instruments.size());
+        }
+
+        processor = std::make_shared<data::OrderbookProcessor>(
+            [this](const data::OrderbookStats& stats) {
+                onStats(stats);
+            });
+        processor->setLatencyRecorder(&engine.latency_);
+        dispatcher = std::make_unique<data::OrderbookDispatcher>(processor, dispatcherConfig);
+    }
+
+    void onStats(const data::OrderbookStats& stats) {
+        auto startTime = std::chrono::steady_clock::now();
+
+        SimulatorOutput output;
+        output.midprice = stats.midprice;
+        output.spread = stats.spread;
+        output.marketVolatility = stats.price_volatility;
+
+        // Price a buy of the configured size against the book the stats came from
+        double baseQuantity = stats.midprice > 0.0 ? config.quantity / stats.midprice : 0.0;
+        const data::DepthProfile& profile = processor->getDepthProfile();
+        data::FillEstimate fill = profile.walk(baseQuantity, true);
+        if (calibrator) {
+            calibrator->observe(baseQuantity, true, stats, fill);
+            calibrator->observe(baseQuantity, false, stats, profile.walk(baseQuantity, false));
+        }
+        if (costMemo) {
+            // Instrument parameters are fixed for the engine's lifetime, so one version
+            MemoizedCost cost = costMemo->evaluate(baseQuantity, true, stats, fill, 0);
+            output.expectedSlippage = cost.slippage;
+            output.expectedMarketImpact = cost.marketImpact;
+            output.expectedFees = cost.fees;
+            output.netCost = cost.totalCost;
+            output.makerProportion = cost.makerProportion;
+            output.costsChanged = cost.changed;
+        } else {
+            auto [slippage, marketImpact, fees, totalCost] =
+                costModel->calculateTotalCost(baseQuantity, true, stats, fill);
+            output.expectedSlippage = slippage;
+            output.expectedMarketImpact = marketImpact;
+            output.expectedFees = fees;
+            output.netCost = totalCost;
+            output.makerProportion = costModel->predictMakerProportion(baseQuantity, true, stats);
+        }
+
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        output.internalLatency = static_cast<double>(latency) / 1000.0;
+        engine.latency_.stage(utils::LatencyStage::Models).record(latency);
+
+        output.readNs = stats.read_ns;
+        output.publishedNs = utils::nowNanoseconds();
+        output.stale = staleness.check(stats, output.publishedNs);
+        latest.store(output);
+        updates.fetch_add(1, std::memory_order_relaxed);
+
+        if (engine.callback_ && !staleness.suppressing()) {
+            engine.callback_(index, output);
+        }
+
+        if (router) {
+            routeOrder(stats, output.publishedNs);
+        }
+    }
+
+    void routeOrder(const data::OrderbookStats& stats, int64_t publishedNs) {
+        VenueQuote venue;
+        const data::L2Book& book = processor->getBook();
+        venue.depth.assign(book.asks(), book.bids());
+        venue.takerFeeRate = costModel->getFeeModel().takerFeeRate;
+        venue.impact = impactModel->calculateCoefficients(stats);
+        venue.updatedNs = publishedNs;
+        quote.store(venue);
+
+        // Venues whose books are stale are left out rather than routed to
+        for (size_t i = 0; i < venueQuotes.size(); ++i) {
+            const Instrument& other = *engine.instruments_[i];
+            venueQuotes[i] = &other == this ? venue : other.quote.load();
+            if (other.staleness.isStale(publishedNs)) {
+                venueQuotes[i].updatedNs = 0;
+            }
+        }
+        const RouterConfig& routing = engine.config_.routing;
+        int64_t startNs = utils::nowNanoseconds();
+        RouteAllocation allocation =
+            router->route(venueQuotes.data(), venueQuotes.size(), routing.quantity, routing.buy);
+        allocation.publishedNs = utils::nowNanoseconds();
+        engine.latency_.stage(utils::LatencyStage::Routing).recordInterval(startNs, allocation.publishedNs);
+        route.store(allocation);
+    }
+};
+
+/**
+ * @brief A worker thread and the instruments it owns
+ */
+struct SimulatorEngine::Shard {
+    utils::Arena arena;
+    std::vector<Instrument*> instruments;
+    std::thread thread;
+    std::atomic<bool> shouldRun{false};
+    std::atomic<uint64_t> updates{0};
+};
+
+SimulatorEngine::SimulatorEngine(EngineCallback callback, const SimulatorEngineConfig& config)
+    : config_(config), callback_(std::move(callback)) {
+    if (config_.instruments.empty()) {
+        throw std::runtime_error("The engine needs at least one instrument");
+    }
+    if (config_.routing.quantity > 0.0 && config_.instruments.size() > data::kMaxVenues) {
+        throw std::runtime_error("Routing takes at most " + std::to_string(data::kMaxVenues) + " venues");
+    }
+
+    // Queues drained by the shards; a replay at full speed must not conflate
+    data::DispatcherConfig dispatcherConfig;
+    dispatcherConfig.queueCapacity = config_.queueCapacity;
+    dispatcherConfig.overflowPolicy = config_.overflowPolicy;
+    dispatcherConfig.dedicatedThread = false;
+    if (!config_.replayPath.empty() && config_.replayMode == data::ReplayMode::AsFastAsPossible) {
+        dispatcherConfig.overflowPolicy = data::OverflowPolicy::Block;
+    }
+
+    size_t shardCount = std::max<size_t>(1, std::min(config_.shards, config_.instruments.size()));
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+
+    for (size_t i = 0; i < config_.instruments.size(); ++i) {
+        // Feeds are keyed by the venue's name, as Simulator::instrumentFor maps its symbol
+        EngineInstrumentConfig& instrumentConfig = config_.instruments[i];
+        std::optional<data::Venue> venue = data::parseVenue(instrumentConfig.exchange);
+        instrumentConfig.instrument =
+            data::venueInstrument(venue.value_or(data::Venue::Okx), instrumentConfig.instrument);
+        if (!instrumentBySymbol_.emplace(data::internSymbol(instrumentConfig.instrument), i).second) {
+            throw std::runtime_error("Instrument listed twice: " + instrumentConfig.instrument);
+        }
+        Shard& shard = *shards_[shardOf(i)];
+        Instrument* instrument = shard.arena.make<Instrument>(instrumentConfig, i, *this, dispatcherConfig);
+        shard.instruments.push_back(instrument);
+        instruments_.push_back(instrument);
+    }
+
+    initializeFeed();
+}
+
+SimulatorEngine::~SimulatorEngine() {
+    stop();
+}
+
+void SimulatorEngine::initializeFeed() {
+    if (!config_.replayPath.empty()) {
+        data::ReplayConfig replayConfig(config_.replayPath, config_.replayMode);
+        replayConfig.speed = config_.replaySpeed;
+        replayConfig.cpu = config_.networkThread.cpu;
+        replaySource_ = std::make_unique<data::ReplayFeedSource>(
+            [this](const data::OrderbookData& data) {
+                auto it = instrumentBySymbol_.find(data.symbol);
+                if (it != instrumentBySymbol_.end()) {
+                    instruments_[it->second]->dispatcher->submit(data);
+                }
+            },
+            replayConfig);
+        return;
+    }
+
+    // One feed per instrument; a feed's messages are serialized on its strand, so each
+    // queue still has a single producer at a time however many I/O threads there are
+    client_ = std::make_unique<data::WebSocketClient>(
+        [this](data::FeedId feedId, const data::OrderbookData& data) {
+            auto it = instrumentByFeed_.find(feedId);
+            if (it != instrumentByFeed_.end()) {
+                instruments_[it->second]->dispatcher->submit(data);
+            }
+        },
+        config_.ioThreads, config_.networkThread);
+    for (Instrument* instrument : instruments_) {
+        data::FeedConfig feed =
+            data::FeedConfig::forInstrument(instrument->config.exchange, instrument->config.instrument);
+        feed.hotStandby = config_.hotStandby;
+        instrument->feedId = client_->addFeed(feed);
+        instrumentByFeed_.emplace(instrument->feedId, instrument->index);
+        instrument->processor->setResyncCallback([this, instrument]() {
+            client_->resubscribe(instrument->feedId);
+        });
+    }
+}
+
+void SimulatorEngine::start() {
+    if (isRunning_.exchange(true)) {
+        return;
+    }
+
+    // Consumers before the producer
+    for (Instrument* instrument : instruments_) {
+        instrument->dispatcher->start();
+    }
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        Shard& shard = *shards_[i];
+        shard.shouldRun = true;
+        shard.thread = std::thread([this, &shard, i]() {
+            runShard(shard, i);
+        });
+    }
+
+    if (client_) {
+        client_->start();
+    }
+    if (replaySource_) {
+        replaySource_->start();
+    }
+}
+
+void SimulatorEngine::stop() {
+    if (!isRunning_.exchange(false)) {
+        return;
+    }
+
+    if (client_) {
+        client_->stop();
+    }
+    if (replaySource_) {
+        replaySource_->stop();
+    }
+
+    for (auto& shard : shards_) {
+        shard->shouldRun = false;
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+    for (Instrument* instrument : instruments_) {
+        instrument->dispatcher->stop();
+    }
+}
+
+bool SimulatorEngine::isFeedConnected() const {
+    if (client_) {
+        return client_->isConnected();
+    }
+    return replaySource_ && replaySource_->isConnected();
+}
+
+const std::string& SimulatorEngine::instrumentName(size_t instrument) const {
+    return instruments_.at(instrument)->config.instrument;
+}
+
+SimulatorOutput SimulatorEngine::getLatestOutput(size_t instrument) const {
+    return instruments_.at(instrument)->latest.load();
+}
+
+RouteAllocation SimulatorEngine::getLatestRoute() const {
+    RouteAllocation latest;
+    for (const Instrument* instrument : instruments_) {
+        if (!instrument->router) {
+            continue;
+        }
+        RouteAllocation allocation = instrument->route.load();
+        if (allocation.publishedNs > latest.publishedNs) {
+            latest = allocation;
+        }
+    }
+    return latest;
+}
+
+data::DispatcherStats SimulatorEngine::getQueueStats(size_t instrument) const {
+    return instruments_.at(instrument)->dispatcher->getStats();
+}
+
+EngineAggregate SimulatorEngine::getAggregate() const {
+    EngineAggregate aggregate;
+    aggregate.instruments = instruments_.size();
+    int64_t nowNs = utils::nowNanoseconds();
+    for (const Instrument* instrument : instruments_) {
+        if (instrument->staleness.isStale(nowNs)) {
+            ++aggregate.staleInstruments;
+        }
+        uint64_t updates = instrument->updates.load(std::memory_order_relaxed);
+        aggregate.updates += updates;
+        aggregate.conflated += instrument->dispatcher->getStats().conflated;
+        if (instrument->costMemo) {
+            CostMemoStats memo = instrument->costMemo->stats();
+            aggregate.costMemoHits += memo.hits;
+            aggregate.costMemoMisses += memo.misses;
+        }
+        if (updates == 0) {
+            continue;
+        }
+
+        SimulatorOutput output = instrument->latest.load();
+        ++aggregate.pricedInstruments;
+        aggregate.totalSlippage += output.expectedSlippage;
+        aggregate.totalFees += output.expectedFees;
+        aggregate.totalMarketImpact += output.expectedMarketImpact;
+        aggregate.totalNetCost += output.netCost;
+        aggregate.maxInternalLatency = std::max(aggregate.maxInternalLatency, output.internalLatency);
+    }
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        uint64_t updates = shards_[i]->updates.load(std::memory_order_relaxed);
+        if (updates > aggregate.busiestShardUpdates) {
+            aggregate.busiestShard = i;
+            aggregate.busiestShardUpdates = updates;
+        }
+    }
+    return aggregate;
+}
+
+void SimulatorEngine::runShard(Shard& shard, size_t index) {
+    utils::ThreadConfig threadConfig;
+    threadConfig.cpu = index < config_.shardCpus.size() ? config_.shardCpus[index] : -1;
+    threadConfig.busyPoll = config_.busyPoll;
+    utils::applyThreadConfig(threadConfig, "shard");
+
+    size_t maxPerTurn = std::max<size_t>(1, config_.maxUpdatesPerTurn);
+    int idleSpins = 0;
+    while (shard.shouldRun.load(std::memory_order_relaxed)) {
+        // One bounded turn per instrument, so a hot one only delays the others by a turn
+        size_t processed = 0;
+        for (Instrument* instrument : shard.instruments) {
+            processed += instrument->dispatcher->drain(maxPerTurn);
+        }
+
+        if (processed > 0) {
+            shard.updates.fetch_add(processed, std::memory_order_relaxed);
+            idleSpins = 0;
+        } else if (threadConfig.busyPoll) {
+            utils::cpuRelax();
+        } else if (++idleSpins < kIdleSpinsBeforeSleep) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(kIdleSleepMicros));
+        }
+    }
+}
+
+} // namespace models
+} // namespace trade_simulator
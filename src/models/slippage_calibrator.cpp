@@ -0,0 +1,59 @@
+#include "models/slippage_calibrator.h"
+
+#include <cmath>
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+RlsEstimator<4>::Vector toVector(const SlippageCoefficients& coefficients) {
+    return {coefficients.intercept, coefficients.volumeFactor, coefficients.volatilityFactor,
+            coefficients.imbalanceFactor};
+}
+
+} // namespace
+
+SlippageCalibrator::SlippageCalibrator(std::shared_ptr<TransactionCostModel> costModel,
+                                       const SlippageCalibrationConfig& config)
+    : costModel_(std::move(costModel)),
+      config_(config),
+      initial_(costModel_->getSlippageCoefficients()),
+      estimator_(toVector(initial_), config.forgettingFactor, config.initialCovariance) {
+}
+
+bool SlippageCalibrator::observe(double orderSize, bool orderSide,
+                                 const data::OrderbookStats& stats,
+                                 const data::FillEstimate& fill) {
+    if (orderSize <= 0.0 || stats.midprice <= 0.0 || fill.filledSize <= 0.0 || !fill.complete()) {
+        return false;
+    }
+
+    // Realized slippage of the fill as a fraction of the midprice
+    double realized = (orderSide ? fill.vwap - stats.midprice : stats.midprice - fill.vwap) /
+                      stats.midprice;
+    lastError_ = estimator_.update(TransactionCostModel::slippageRegressors(orderSize, orderSide, stats),
+                                   realized);
+
+    if (estimator_.updateCount() < config_.warmupObservations) {
+        return true;
+    }
+
+    const auto& theta = estimator_.coefficients();
+    if (!std::isfinite(theta[0]) || !std::isfinite(theta[1]) ||
+        !std::isfinite(theta[2]) || !std::isfinite(theta[3])) {
+        reset();
+        return true;
+    }
+    costModel_->setSlippageCoefficients(SlippageCoefficients(theta[0], theta[1], theta[2], theta[3]));
+    return true;
+}
+
+void SlippageCalibrator::reset() {
+    estimator_.reset(toVector(initial_));
+    lastError_ = 0.0;
+    costModel_->setSlippageCoefficients(initial_);
+}
+
+} // namespace models
+} // namespace trade_simulator 
@@ -0,0 +1,153 @@
+#include "models/smart_order_router.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace trade_simulator {
+namespace models {
+
+SmartOrderRouter::SmartOrderRouter(size_t slices)
+    : slices_(std::max<size_t>(slices, 1)) {}
+
+const RouteAllocation& SmartOrderRouter::route(const VenueQuote* quotes, size_t count,
+                                               double quantity, bool buy) {
+    count = std::min(count, data::kMaxVenues);
+    allocation_ = RouteAllocation();
+    allocation_.venues = count;
+
+    // Consolidate the venues that have a book
+    const data::VenueDepth* depths[data::kMaxVenues];
+    for (size_t v = 0; v < count; ++v) {
+        depths[v] = quotes[v].updatedNs != 0 ? &quotes[v].depth : nullptr;
+    }
+    book_.merge(depths, count);
+    allocation_.top = book_.top();
+    double midprice = allocation_.top.midprice();
+    if (midprice <= 0.0 || quantity <= 0.0) {
+        return allocation_;
+    }
+    double baseQuantity = quantity / midprice;
+    allocation_.quantity = baseQuantity;
+
+    // Prefix sums of the side each venue fills the order from
+    for (size_t v = 0; v < count; ++v) {
+        VenueCurve& curve = curves_[v];
+        const data::VenueDepth& depth = quotes[v].depth;
+        curve.levels = depths[v] ? (buy ? depth.askCount : depth.bidCount) : 0;
+        curve.prices = buy ? depth.askPrices.data() : depth.bidPrices.data();
+        const double* sizes = buy ? depth.askSizes.data() : depth.bidSizes.data();
+        curve.takerFeeRate = quotes[v].takerFeeRate;
+        curve.impact = quotes[v].impact;
+        curve.cumSize[0] = 0.0;
+        curve.cumNotional[0] = 0.0;
+        for (size_t i = 0; i < curve.levels; ++i) {
+            curve.cumSize[i + 1] = curve.cumSize[i] + sizes[i];
+            curve.cumNotional[i + 1] = curve.cumNotional[i] + curve.prices[i] * sizes[i];
+        }
+    }
+
+    // Greedy: each slice goes to the venue whose cost grows least per unit by taking it
+    double slice = baseQuantity / static_cast<double>(slices_);
+    std::array<double, data::kMaxVenues> sizes{};
+    std::array<double, data::kMaxVenues> costs{};
+    std::array<double, data::kMaxVenues> marginal{};
+    auto nextMarginal = [&](size_t v, double remaining) {
+        const VenueCurve& curve = curves_[v];
+        double step = std::min({slice, curve.cumSize[curve.levels] - sizes[v], remaining});
+        if (step <= 0.0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return (venueCost(curve, sizes[v] + step, midprice, buy, nullptr) - costs[v]) / step;
+    };
+    for (size_t v = 0; v < count; ++v) {
+        marginal[v] = nextMarginal(v, baseQuantity);
+    }
+
+    // A venue running out of depth takes a short slice, so allow one extra per venue;
+    // the tolerance keeps rounding from leaving a sliver of the order behind
+    double remaining = baseQuantity;
+    double tolerance = baseQuantity * 1e-9;
+    for (size_t s = 0; s < slices_ + count && remaining > tolerance; ++s) {
+        size_t best = 0;
+        for (size_t v = 1; v < count; ++v) {
+            best = marginal[v] < marginal[best] ? v : best;
+        }
+        if (marginal[best] == std::numeric_limits<double>::infinity()) {
+            break;  // Every venue's visible depth is taken
+        }
+        const VenueCurve& curve = curves_[best];
+        double step = std::min({slice, curve.cumSize[curve.levels] - sizes[best], remaining});
+        sizes[best] += step;
+        remaining -= step;
+        costs[best] = venueCost(curve, sizes[best], midprice, buy, nullptr);
+        for (size_t v = 0; v < count; ++v) {
+            // A short last slice changes every venue's step, otherwise only the chosen one moved
+            if (v == best || remaining < slice + tolerance) {
+                marginal[v] = nextMarginal(v, remaining);
+            }
+        }
+    }
+
+    // The concave impact can make one venue cheaper than any split
+    double splitCost = 0.0;
+    for (size_t v = 0; v < count; ++v) {
+        splitCost += costs[v];
+    }
+    size_t singleVenue = count;
+    for (size_t v = 0; v < count; ++v) {
+        const VenueCurve& curve = curves_[v];
+        if (curve.cumSize[curve.levels] < baseQuantity) {
+            continue;
+        }
+        double cost = venueCost(curve, baseQuantity, midprice, buy, nullptr);
+        if (allocation_.singleVenueCost < 0.0 || cost < allocation_.singleVenueCost) {
+            allocation_.singleVenueCost = cost;
+            singleVenue = v;
+        }
+    }
+    if (singleVenue < count && (remaining > tolerance || allocation_.singleVenueCost < splitCost)) {
+        sizes.fill(0.0);
+        sizes[singleVenue] = baseQuantity;
+    }
+
+    for (size_t v = 0; v < count; ++v) {
+        VenueAllocation& leg = allocation_.legs[v];
+        if (sizes[v] <= 0.0) {
+            continue;
+        }
+        leg.size = sizes[v];
+        venueCost(curves_[v], sizes[v], midprice, buy, &leg);
+        allocation_.routed += leg.size;
+        allocation_.slippage += leg.slippage;
+        allocation_.fees += leg.fees;
+        allocation_.marketImpact += leg.marketImpact;
+        allocation_.totalCost += leg.cost;
+    }
+    return allocation_;
+}
+
+double SmartOrderRouter::venueCost(const VenueCurve& curve, double size, double midprice, bool buy,
+                                   VenueAllocation* leg) {
+    // First prefix covering the size; the level before it is filled in part
+    const double* begin = curve.cumSize.data() + 1;
+    const double* end = begin + curve.levels;
+    size_t level = static_cast<size_t>(std::lower_bound(begin, end, size) - begin);
+    level = std::min(level, curve.levels - 1);
+    double notional = curve.cumNotional[level] + (size - curve.cumSize[level]) * curve.prices[level];
+
+    double slippage = buy ? notional - midprice * size : midprice * size - notional;
+    double fees = curve.takerFeeRate * notional;
+    double marketImpact = curve.impact.impact(size);
+    double cost = slippage + fees + marketImpact;
+    if (leg) {
+        leg->notional = notional;
+        leg->slippage = slippage;
+        leg->fees = fees;
+        leg->marketImpact = marketImpact;
+        leg->cost = cost;
+    }
+    return cost;
+}
+
+} // namespace models
+} // namespace trade_simulator
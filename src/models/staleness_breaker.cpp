@@ -0,0 +1,64 @@
+#include "models/staleness_breaker.h"
+
+#include <iostream>
+
+namespace trade_simulator {
+namespace models {
+
+namespace {
+
+constexpr int64_t kNanosecondsPerMillisecond = 1000000;
+
+bool exceeds(int64_t valueNs, int64_t limitMs) {
+    return limitMs > 0 && valueNs > limitMs * kNanosecondsPerMillisecond;
+}
+
+} // namespace
+
+StalenessBreaker::StalenessBreaker(const StalenessConfig& config) : config_(config) {}
+
+bool StalenessBreaker::check(const data::OrderbookStats& stats, int64_t nowNs) {
+    lastUpdateNs_.store(nowNs, std::memory_order_relaxed);
+
+    bool stale = (stats.exchange_lag_ns >= 0 && exceeds(stats.exchange_lag_ns, config_.maxExchangeLagMs)) ||
+                 (stats.read_ns != 0 && exceeds(nowNs - stats.read_ns, config_.maxQueueAgeMs));
+
+    bool open = open_.load(std::memory_order_relaxed);
+    if (stale) {
+        freshInRow_.store(0, std::memory_order_relaxed);
+        if (!open) {
+            open_.store(true, std::memory_order_relaxed);
+            trips_.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "Stale book (exchange lag " << stats.exchange_lag_ns / kNanosecondsPerMillisecond
+                      << " ms, queue age " << (nowNs - stats.read_ns) / kNanosecondsPerMillisecond
+                      << " ms); " << (config_.suppressStale ? "suppressing outputs" : "flagging outputs")
+                      << std::endl;
+        }
+        return true;
+    }
+
+    if (open && freshInRow_.fetch_add(1, std::memory_order_relaxed) + 1 >= config_.recoveryUpdates) {
+        open_.store(false, std::memory_order_relaxed);
+        freshInRow_.store(0, std::memory_order_relaxed);
+        std::cerr << "Book fresh again; publishing resumed" << std::endl;
+        return false;
+    }
+    return open_.load(std::memory_order_relaxed);
+}
+
+bool StalenessBreaker::isStale(int64_t nowNs) const {
+    if (open_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    int64_t lastUpdateNs = lastUpdateNs_.load(std::memory_order_relaxed);
+    return lastUpdateNs != 0 && exceeds(nowNs - lastUpdateNs, config_.maxSilenceMs);
+}
+
+void StalenessBreaker::reset() {
+    open_.store(false, std::memory_order_relaxed);
+    lastUpdateNs_.store(0, std::memory_order_relaxed);
+    freshInRow_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace models
+} // namespace trade_simulator
@@ -5,6 +5,18 @@
 namespace trade_simulator {
 namespace models {
 
+FeeModel FeeModel::forTier(int tier) {
+    // Higher tier means lower fees
+    if (tier <= 0) {
+        return FeeModel(0.0002, 0.0005, tier);   // 0.02% / 0.05%
+    } else if (tier == 1) {
+        return FeeModel(0.00015, 0.0004, tier);  // 0.015% / 0.04%
+    } else if (tier == 2) {
+        return FeeModel(0.0001, 0.0003, tier);   // 0.01% / 0.03%
+    }
+    return FeeModel(0.00005, 0.0002, tier);      // 0.005% / 0.02%
+}
+
 TransactionCostModel::TransactionCostModel(
     std::shared_ptr<MarketImpactModel> marketImpactModel,
     const FeeModel& feeModel)
@@ -13,35 +25,39 @@ TransactionCostModel::TransactionCostModel(
 }
 
 void TransactionCostModel::setFeeModel(const FeeModel& feeModel) {
-    feeModel_ = feeModel;
+    feeModel_.store(feeModel);
 }
 
 FeeModel TransactionCostModel::getFeeModel() const {
-    return feeModel_;
+    return feeModel_.load();
+}
+
+void TransactionCostModel::setSlippageCoefficients(const SlippageCoefficients& coefficients) {
+    slippage_.store(coefficients);
+}
+
+SlippageCoefficients TransactionCostModel::getSlippageCoefficients() const {
+    return slippage_.load();
+}
+
+SlippageRegressors TransactionCostModel::slippageRegressors(double orderSize, bool orderSide,
+                                                            const data::OrderbookStats& stats) {
+    return {1.0, orderSize * inverseSideDepth(orderSide, stats), stats.price_volatility,
+            stats.order_imbalance - 1.0};
 }
 
 double TransactionCostModel::calculateSlippage(double orderSize, bool orderSide, 
                                             const data::OrderbookStats& stats) const {
     // For this implementation, we'll use a linear regression model
     // to predict slippage based on order size, volatility, and order imbalance
-    
-    double relativeSizeToDepth = 0.0;
-    
-    if (orderSide) {  // Buy order  
-        if (stats.total_ask_size > 0.0) {
-            relativeSizeToDepth = orderSize / stats.total_ask_size;
-        }
-    } else {  // Sell order
-        if (stats.total_bid_size > 0.0) {
-            relativeSizeToDepth = orderSize / stats.total_bid_size;
-        }
-    }
+    SlippageRegressors x = slippageRegressors(orderSize, orderSide, stats);
+    SlippageCoefficients coefficients = slippage_.load();
     
     // Apply regression model
-    double slippageEstimate = slippageIntercept_ +   
-                             (slippageVolumeFactor_ * relativeSizeToDepth) +
-                             (slippageVolatilityFactor_ * stats.price_volatility) +
-                             (slippageImbalanceFactor_ * (stats.order_imbalance - 1.0));
+    double slippageEstimate = (coefficients.intercept * x[0]) +
+                             (coefficients.volumeFactor * x[1]) +
+                             (coefficients.volatilityFactor * x[2]) +
+                             (coefficients.imbalanceFactor * x[3]);
     
     // Convert to price impact
     // For buys: positive slippage means paying more
@@ -54,6 +70,33 @@ double TransactionCostModel::calculateSlippage(double orderSize, bool orderSide,
     return std::max(priceSlippage, minSlippage);
 }
 
+double TransactionCostModel::calculateSlippage(double orderSize, bool orderSide,
+                                            const data::OrderbookStats& stats,
+                                            const data::DepthProfile& profile) const {
+    return calculateSlippage(orderSize, orderSide, stats, profile.walk(orderSize, orderSide));
+}
+
+double TransactionCostModel::calculateSlippage(double orderSize, bool orderSide,
+                                            const data::OrderbookStats& stats,
+                                            const data::FillEstimate& fill) const {
+    if (fill.filledSize <= 0.0 || stats.midprice <= 0.0) {
+        return calculateSlippage(orderSize, orderSide, stats);
+    }
+    
+    // Price the part the book cannot fill beyond the worst level, as the regression would
+    double notional = fill.notional;
+    if (!fill.complete()) {
+        double worstSlippage = std::abs(fill.worstPrice - stats.midprice);
+        double residualSlippage = worstSlippage + calculateSlippage(fill.residualSize, orderSide, stats);
+        notional += fill.residualSize * (orderSide ? stats.midprice + residualSlippage
+                                                   : stats.midprice - residualSlippage);
+    }
+    
+    // For buys the fill price is above the mid, for sells below it
+    double averagePrice = notional / orderSize;
+    return orderSide ? averagePrice - stats.midprice : stats.midprice - averagePrice;
+}
+
 double TransactionCostModel::calculateFees(double orderSize, double orderPrice, 
                                         double makerProportion) const {
     // Ensure maker proportion is between 0 and 1
@@ -66,8 +109,9 @@ double TransactionCostModel::calculateFees(double orderSize, double orderPrice,
     double notionalValue = orderSize * orderPrice;
     
     // Calculate fee components
-    double makerFee = notionalValue * makerProportion * feeModel_.makerFeeRate;
-    double takerFee = notionalValue * takerProportion * feeModel_.takerFeeRate;
+    FeeModel feeModel = feeModel_.load();
+    double makerFee = notionalValue * makerProportion * feeModel.makerFeeRate;
+    double takerFee = notionalValue * takerProportion * feeModel.takerFeeRate;
     
     // Total fee
     return makerFee + takerFee;
@@ -109,6 +153,33 @@ std::tuple<double, double, double, double> TransactionCostModel::calculateTotalC
     // Calculate expected slippage
     double slippage = calculateSlippage(orderSize, orderSide, stats);
     
+    return calculateTotalCost(orderSize, orderSide, stats, slippage);
+}
+
+std::tuple<double, double, double, double> TransactionCostModel::calculateTotalCost(
+    double orderSize, bool orderSide, const data::OrderbookStats& stats,
+    const data::DepthProfile& profile) const {
+    
+    // Calculate slippage against the actual levels
+    double slippage = calculateSlippage(orderSize, orderSide, stats, profile);
+    
+    return calculateTotalCost(orderSize, orderSide, stats, slippage);
+}
+
+std::tuple<double, double, double, double> TransactionCostModel::calculateTotalCost(
+    double orderSize, bool orderSide, const data::OrderbookStats& stats,
+    const data::FillEstimate& fill) const {
+    
+    // Calculate slippage from the precomputed fill
+    double slippage = calculateSlippage(orderSize, orderSide, stats, fill);
+    
+    return calculateTotalCost(orderSize, orderSide, stats, slippage);
+}
+
+std::tuple<double, double, double, double> TransactionCostModel::calculateTotalCost(
+    double orderSize, bool orderSide, const data::OrderbookStats& stats, double slippage,
+    double* makerProportionOut) const {
+    
     // Calculate market impact using the Almgren-Chriss model
     double marketImpact = 0.0;
     if (marketImpactModel_) { 
@@ -117,6 +188,9 @@ std::tuple<double, double, double, double> TransactionCostModel::calculateTotalC
      
     // Predict maker/taker proportion
     double makerProportion = predictMakerProportion(orderSize, orderSide, stats);
+    if (makerProportionOut) {
+        *makerProportionOut = makerProportion;
+    }
     
     // Calculate expected fees
     // Use midprice as the reference price for fee calculation
@@ -128,5 +202,88 @@ std::tuple<double, double, double, double> TransactionCostModel::calculateTotalC
     return std::make_tuple(slippage, marketImpact, fees, totalCost);
 }
 
+std::tuple<double, double, double, double> TransactionCostModel::calculateLimitOrderCost(
+    double orderSize, bool orderSide, const data::OrderbookStats& stats,
+    const data::FillEstimate& takerFill, double makerProportion) const {
+    
+    makerProportion = std::clamp(makerProportion, 0.0, 1.0);
+    double takerSize = orderSize * (1.0 - makerProportion);
+    
+    // Average distance from the mid: the passive share earns half the spread
+    double slippage = -makerProportion * stats.spread / 2.0;
+    double marketImpact = 0.0;
+    if (takerSize > 0.0) {
+        slippage += (1.0 - makerProportion) * calculateSlippage(takerSize, orderSide, stats, takerFill);
+        if (marketImpactModel_) {
+            marketImpact = marketImpactModel_->calculateMarketImpact(takerSize, orderSide, stats);
+        }
+    }
+    
+    double fees = calculateFees(orderSize, stats.midprice, makerProportion);
+    double totalCost = slippage + marketImpact + fees;
+    
+    return std::make_tuple(slippage, marketImpact, fees, totalCost);
+}
+
+void TransactionCostModel::calculateCostCurve(const double* orderSizes, size_t count,
+                                              bool orderSide,
+                                              const data::OrderbookStats& stats,
+                                              const data::DepthProfile* profile,
+                                              CostCurve& curve) const {
+    curve.resize(count);
+    std::copy_n(orderSizes, count, curve.sizes.data());
+    
+    const double* sizes = curve.sizes.data();
+    double* slippage = curve.slippage.data();
+    double* impact = curve.marketImpact.data();
+    double* fees = curve.fees.data();
+    double* total = curve.totalCost.data();
+    double* maker = curve.makerProportion.data();
+    
+    // Slippage: a binary search per size against the book, or the regression in bulk
+    if (profile) {
+        for (size_t i = 0; i < count; ++i) {
+            slippage[i] = calculateSlippage(sizes[i], orderSide, stats, *profile);
+        }
+    } else {
+        SlippageCoefficients coefficients = slippage_.load();
+        double inverseDepth = inverseSideDepth(orderSide, stats);
+        double base = coefficients.intercept +
+                      coefficients.volatilityFactor * stats.price_volatility +
+                      coefficients.imbalanceFactor * (stats.order_imbalance - 1.0);
+        double volumeFactor = coefficients.volumeFactor;
+        double minSlippage = stats.spread / 2.0;
+        for (size_t i = 0; i < count; ++i) {
+            double estimate = base + volumeFactor * sizes[i] * inverseDepth;
+            slippage[i] = std::max(estimate * stats.midprice, minSlippage);
+        }
+    }
+    
+    // Market impact
+    if (marketImpactModel_) {
+        marketImpactModel_->calculateMarketImpactBatch(sizes, count, orderSide, stats, impact);
+    } else {
+        std::fill_n(impact, count, 0.0);
+    }
+    
+    // Maker proportion and fees, priced at the midprice as in calculateTotalCost
+    double makerDecay = -5.0 * inverseSideDepth(orderSide, stats);
+    double volatilityScale = std::exp(-2.0 * stats.price_volatility);
+    FeeModel feeModel = feeModel_.load();
+    double makerRate = feeModel.makerFeeRate;
+    double takerRate = feeModel.takerFeeRate;
+    for (size_t i = 0; i < count; ++i) {
+        double proportion = std::clamp(std::exp(makerDecay * sizes[i]) * volatilityScale, 0.0, 0.1);
+        maker[i] = proportion;
+        fees[i] = sizes[i] * stats.midprice * (takerRate + proportion * (makerRate - takerRate));
+        total[i] = slippage[i] + impact[i] + fees[i];
+    }
+}
+
+double TransactionCostModel::inverseSideDepth(bool orderSide, const data::OrderbookStats& stats) {
+    double depth = orderSide ? stats.total_ask_size : stats.total_bid_size;
+    return depth > 0.0 ? 1.0 / depth : 0.0;
+}
+
 } // namespace models
 } // namespace trade_simulator 
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "ui/chart_history.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace trade_simulator {
+namespace ui {
+
+ChartHistory::ChartHistory(double windowSeconds, double bucketSeconds)
+    : bucketSeconds_(bucketSeconds),
+      capacity_(std::max<size_t>(1, static_cast<size_t>(std::ceil(windowSeconds / bucketSeconds)))),
+      ring_(capacity_) {
+}
+
+void ChartHistory::add(double timeSeconds, const OutputFrame& frame) {
+    int64_t index = static_cast<int64_t>(std::floor(std::max(0.0, timeSeconds) / bucketSeconds_));
+    if (newest_ < 0) {
+        oldest_ = index;
+        newest_ = index;
+    }
+    index = std::max(index, newest_);
+    newest_ = index;
+
+    // Slide the window; buckets that fall out are recycled for the new ones
+    oldest_ = std::max(oldest_, newest_ - static_cast<int64_t>(capacity_) + 1);
+    while (!maxima_.empty() && maxima_.front().first < oldest_) {
+        maxima_.pop_front();
+    }
+
+    Bucket& bucket = ring_[static_cast<size_t>(index) % capacity_];
+    if (bucket.index != index) {
+        bucket = Bucket();
+        bucket.index = index;
+    }
+    double bucketMax = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < kChartSeriesCount; ++i) {
+        bucket.ranges[i].merge(frame.ranges[i]);
+        bucketMax = std::max(bucketMax, bucket.ranges[i].max);
+    }
+
+    // Entries at or below the new value can never be the maximum again
+    while (!maxima_.empty() && maxima_.back().second <= bucketMax) {
+        maxima_.pop_back();
+    }
+    maxima_.emplace_back(index, bucketMax);
+}
+
+void ChartHistory::clear() {
+    std::fill(ring_.begin(), ring_.end(), Bucket());
+    maxima_.clear();
+    oldest_ = 0;
+    newest_ = -1;
+}
+
+double ChartHistory::maximum() const {
+    return maxima_.empty() ? 0.0 : maxima_.front().second;
+}
+
+double ChartHistory::latestTime() const {
+    return newest_ < 0 ? 0.0 : static_cast<double>(newest_ + 1) * bucketSeconds_;
+}
+
+void ChartHistory::render(ChartSeries series, int maxPoints, QVector<QPointF>& points) const {
+    points.clear();
+    if (newest_ < 0) {
+        return;
+    }
+
+    // Two points (minimum, maximum) per group of adjacent buckets
+    size_t seriesIndex = static_cast<size_t>(series);
+    int64_t buckets = newest_ - oldest_ + 1;
+    int64_t groups = std::max<int64_t>(1, maxPoints / 2);
+    int64_t bucketsPerGroup = (buckets + groups - 1) / groups;
+
+    for (int64_t start = oldest_; start <= newest_; start += bucketsPerGroup) {
+        ValueRange range;
+        int64_t end = std::min(newest_ + 1, start + bucketsPerGroup);
+        for (int64_t index = start; index < end; ++index) {
+            const Bucket& bucket = ring_[static_cast<size_t>(index) % capacity_];
+            if (bucket.index == index) {
+                range.merge(bucket.ranges[seriesIndex]);
+            }
+        }
+        if (range.empty()) {
+            continue;  // Nothing arrived, e.g. while stopped
+        }
+        double x = static_cast<double>(start) * bucketSeconds_;
+        points.append(QPointF(x, range.min));
+        if (range.max != range.min) {
+            points.append(QPointF(x, range.max));
+        }
+    }
+}
+
+} // namespace ui
+} // namespace trade_simulator
@@ -8,14 +8,19 @@
 #include <QTableWidget>
 #include <QSplitter>
 #include <QDebug>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <algorithm>
+#include <fstream>
 
 namespace trade_simulator {
 namespace ui {
 
-MainWindow::MainWindow(QWidget *parent)
+MainWindow::MainWindow(const models::SimulatorConfig& config, int framesPerSecond, QWidget *parent)
     : QMainWindow(parent), 
       ui(nullptr),
-      dataPointCounter(0) {
+      chartHistory(kChartWindowSeconds, kChartBucketSeconds),
+      frameIntervalMs(1000 / std::max(1, framesPerSecond)) {
     
     setupUi();
     setupInputPanel();
@@ -26,13 +31,18 @@ MainWindow::MainWindow(QWidget *parent)
     // Create simulator
     simulator = std::make_shared<models::Simulator>(
         [this](const models::SimulatorOutput& output) {
-            // This will be called from a different thread, so use Qt's signal/slot mechanism
-            QMetaObject::invokeMethod(this, "updateOutput", Qt::QueuedConnection,
-                                    Q_ARG(trade_simulator::models::SimulatorOutput, output));
-        } 
+            // Called on the processing thread; only the first output of a frame wakes the UI
+            if (mailbox.post(output)) {
+                QMetaObject::invokeMethod(this, "onOutputReady", Qt::QueuedConnection);
+            }
+        },
+        config
     );
     
-    // Start update timer (for chart updates)
+    frameTimer.setSingleShot(true);
+    chartClock.start();
+    
+    // Start update timer (for the latency label)
     updateTimer.setInterval(1000);  // Update every second
     updateTimer.start();
     
@@ -89,10 +99,15 @@ void MainWindow::setupInputPanel() {
     // Exchange
     exchangeComboBox = new QComboBox(parametersGroup);
     exchangeComboBox->addItem("OKX");
+    exchangeComboBox->addItem("Binance");
+    exchangeComboBox->addItem("Bybit");
+    exchangeComboBox->addItem("Deribit");
     formLayout->addRow("Exchange:", exchangeComboBox);
     
-    // Symbol
+    // Symbol; editable so other instruments' feeds can be added by name
     symbolComboBox = new QComboBox(parametersGroup);
+    symbolComboBox->setEditable(true);
+    symbolComboBox->setInsertPolicy(QComboBox::InsertAtBottom);
     symbolComboBox->addItem("BTC-USDT");
     symbolComboBox->addItem("ETH-USDT");
     symbolComboBox->addItem("SOL-USDT");
@@ -101,6 +116,7 @@ void MainWindow::setupInputPanel() {
     // Order Type
     orderTypeComboBox = new QComboBox(parametersGroup);
     orderTypeComboBox->addItem("Market");
+    orderTypeComboBox->addItem("Limit");
     formLayout->addRow("Order Type:", orderTypeComboBox);
     
     // Quantity
@@ -148,7 +164,10 @@ void MainWindow::setupOutputPanel() {
     marketImpactLabel = new QLabel("$ 0.00", outputGroup);
     netCostLabel = new QLabel("$ 0.00", outputGroup);
     makerTakerLabel = new QLabel("0.0% / 100.0%", outputGroup);
-    latencyLabel = new QLabel("0 μs", outputGroup);
+    fillProbabilityLabel = new QLabel("-", outputGroup);
+    latencyLabel = new QLabel("-", outputGroup);
+    valueAtRiskLabel = new QLabel("-", outputGroup);
+    expectedShortfallLabel = new QLabel("-", outputGroup);
     
     // Add labels to form layout
     formLayout->addRow("Expected Slippage:", slippageLabel);
@@ -156,7 +175,14 @@ void MainWindow::setupOutputPanel() {
     formLayout->addRow("Expected Market Impact:", marketImpactLabel);
     formLayout->addRow("Net Cost:", netCostLabel);
     formLayout->addRow("Maker/Taker:", makerTakerLabel);
-    formLayout->addRow("Internal Latency:", latencyLabel);
+    formLayout->addRow("Limit Fill:", fillProbabilityLabel);
+    formLayout->addRow("Execution Cost VaR:", valueAtRiskLabel);
+    formLayout->addRow("Expected Shortfall:", expectedShortfallLabel);
+    formLayout->addRow("End-to-End Latency:", latencyLabel);
+    
+    // Export of the per-stage latency histograms
+    exportLatencyButton = new QPushButton("Export Latency...", outputGroup);
+    formLayout->addRow(exportLatencyButton);
     
     // Create chart view
     chart = new QChart();
@@ -184,6 +210,7 @@ void MainWindow::setupChart() {
     impactSeries->setName("Market Impact");
     feesSeries->setName("Fees");
     totalCostSeries->setName("Total Cost");
+    chartSeries = {slippageSeries, impactSeries, feesSeries, totalCostSeries};
     
     // Add series to chart
     chart->addSeries(slippageSeries);
@@ -198,7 +225,7 @@ void MainWindow::setupChart() {
     // Set axes properties
     axisX->setTitleText("Time (s)");
     axisY->setTitleText("Cost (USD)");
-    axisX->setRange(0, kMaxDataPoints);
+    axisX->setRange(0, kChartWindowSeconds);
     axisY->setRange(0, 1.0);  // Will auto-adjust as needed
     
     // Add axes to chart
@@ -226,6 +253,7 @@ void MainWindow::setupChart() {
 void MainWindow::connectSignals() {
     // Connect start/stop button
     connect(startStopButton, &QPushButton::clicked, this, &MainWindow::onStartStopButtonClicked);
+    connect(exportLatencyButton, &QPushButton::clicked, this, &MainWindow::onExportLatencyClicked);
     
     // Connect parameter change signals
     connect(exchangeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), 
@@ -241,8 +269,9 @@ void MainWindow::connectSignals() {
     connect(feeTierSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), 
             this, &MainWindow::onParametersChanged);
     
-    // Connect update timer for chart
-    connect(&updateTimer, &QTimer::timeout, this, &MainWindow::updateChart);
+    // Frames deferred by the frame rate, and the latency label
+    connect(&frameTimer, &QTimer::timeout, this, &MainWindow::renderFrame);
+    connect(&updateTimer, &QTimer::timeout, this, &MainWindow::updateLatencyLabel);
 }
 
 void MainWindow::onStartStopButtonClicked() {
@@ -272,7 +301,50 @@ void MainWindow::onParametersChanged() {
     }
 }
 
-void MainWindow::updateOutput(const models::SimulatorOutput& output) {
+void MainWindow::onOutputReady() {
+    if (frameTimer.isActive()) {
+        return;  // A frame is already scheduled
+    }
+    qint64 remaining = lastFrame.isValid() ? frameIntervalMs - lastFrame.elapsed() : 0;
+    if (remaining > 0) {
+        frameTimer.start(static_cast<int>(remaining));
+    } else {
+        renderFrame();
+    }
+}
+
+void MainWindow::renderFrame() {
+    OutputFrame frame;
+    if (!mailbox.take(frame)) {
+        return;
+    }
+    lastFrame.restart();
+    
+    // A frame of outputs the cost memo reported unchanged has nothing new to draw
+    updateOutput(frame.latest, frame.changedUpdates > 0);
+    updateExecutionRisk();
+    chartHistory.add(chartClock.elapsed() / 1000.0, frame);
+    updateChart();
+}
+
+void MainWindow::updateExecutionRisk() {
+    models::CostDistribution risk = simulator ? simulator->getLatestCostDistribution()
+                                              : models::CostDistribution();
+    if (risk.paths == 0) {
+        return;
+    }
+    QString level = QString("%1%").arg(risk.confidence * 100.0, 0, 'f', 0);
+    valueAtRiskLabel->setText(QString("%1 (%2)").arg(formatCurrency(risk.valueAtRisk)).arg(level));
+    expectedShortfallLabel->setText(
+        QString("%1 (%2)").arg(formatCurrency(risk.expectedShortfall)).arg(level));
+}
+
+void MainWindow::updateOutput(const models::SimulatorOutput& output, bool costsChanged) {
+    recordUiLatency(output);
+    if (!costsChanged) {
+        return;
+    }
+    
     // Update result labels
     slippageLabel->setText(formatCurrency(output.expectedSlippage));
     feesLabel->setText(formatCurrency(output.expectedFees));
@@ -288,57 +360,86 @@ void MainWindow::updateOutput(const models::SimulatorOutput& output) {
             .arg(takerPercentage, 0, 'f', 1)
     );
     
-    // Update latency
-    if (output.internalLatency > 1000.0) {
-        latencyLabel->setText(
-            QString("%1 ms").arg(output.internalLatency / 1000.0, 0, 'f', 2)
-        );
+    // Fill of the resting order; a market order fills at once
+    if (orderTypeComboBox->currentText() != "Limit") {
+        fillProbabilityLabel->setText("-");
+    } else if (output.expectedTimeToFill < 0.0) {
+        fillProbabilityLabel->setText(QString("0.0% (queue not moving, %1 ahead)")
+                                          .arg(output.queueAhead, 0, 'g', 4));
     } else {
-        latencyLabel->setText(
-            QString("%1 μs").arg(output.internalLatency, 0, 'f', 0)
-        );
+        fillProbabilityLabel->setText(QString("%1% (~%2 s, %3 ahead)")
+                                          .arg(output.fillProbability * 100.0, 0, 'f', 1)
+                                          .arg(output.expectedTimeToFill, 0, 'f', 1)
+                                          .arg(output.queueAhead, 0, 'g', 4));
     }
 }
 
-void MainWindow::updateChart() {
+void MainWindow::recordUiLatency(const models::SimulatorOutput& output) {
+    // Record the hop to this thread and the whole pipeline, including the wait for the
+    // frame; the label shows percentiles
+    if (simulator) {
+        int64_t nowNs = utils::nowNanoseconds();
+        utils::PipelineLatency& latency = simulator->getLatency();
+        latency.stage(utils::LatencyStage::UiDispatch).recordInterval(output.publishedNs, nowNs);
+        latency.stage(utils::LatencyStage::EndToEnd).recordInterval(output.readNs, nowNs);
+    }
+}
+
+void MainWindow::onExportLatencyClicked() {
+    QString path = QFileDialog::getSaveFileName(this, "Export Latency", "latency.csv",
+                                                "CSV files (*.csv)");
+    if (!path.isEmpty() && !exportLatency(path)) {
+        QMessageBox::warning(this, "Export Latency", QString("Cannot write %1").arg(path));
+    }
+}
+
+bool MainWindow::exportLatency(const QString& path) const {
+    if (!simulator) {
+        return false;
+    }
+    std::ofstream out(path.toStdString());
+    if (!out) {
+        return false;
+    }
+    simulator->getLatency().writeCsv(out);
+    return static_cast<bool>(out);
+}
+
+void MainWindow::updateLatencyLabel() {
     if (!simulator || !simulator->isRunning()) {
         return;
     }
-    
-    // Get latest output
-    models::SimulatorOutput output = simulator->getLatestOutput();
-    
-    // Add data points to series
-    slippageSeries->append(dataPointCounter, output.expectedSlippage);
-    impactSeries->append(dataPointCounter, output.expectedMarketImpact);
-    feesSeries->append(dataPointCounter, output.expectedFees);
-    totalCostSeries->append(dataPointCounter, output.netCost);
-    
-    // Increment counter
-    dataPointCounter++;
-    
-    // Remove old points if we exceed the maximum
-    if (slippageSeries->count() > kMaxDataPoints) {
-        slippageSeries->remove(0);
-        impactSeries->remove(0);
-        feesSeries->remove(0);
-        totalCostSeries->remove(0);
+    utils::LatencySnapshot snapshot =
+        simulator->getLatency().stage(utils::LatencyStage::EndToEnd).snapshot();
+    if (snapshot.count == 0) {
+        return;
     }
-    
-    // Update X axis range to show the most recent points
-    if (dataPointCounter > kMaxDataPoints) {
-        axisX->setRange(dataPointCounter - kMaxDataPoints, dataPointCounter);
-    } else {
-        axisX->setRange(0, std::max(kMaxDataPoints, dataPointCounter));
+    // Outputs stop while the breaker is open, so flag the numbers still shown
+    latencyLabel->setText(
+        QString("%1p50 %2 / p99 %3 / p99.9 %4 / max %5")
+            .arg(simulator->isStale() ? "STALE - " : "")
+            .arg(formatLatency(snapshot.p50))
+            .arg(formatLatency(snapshot.p99))
+            .arg(formatLatency(snapshot.p999))
+            .arg(formatLatency(snapshot.max))
+    );
+}
+
+void MainWindow::updateChart() {
+    // Decimate to about one point per pixel and swap each series' points in one call
+    int maxPoints = std::max(2, chartView->width());
+    for (size_t i = 0; i < kChartSeriesCount; ++i) {
+        chartHistory.render(static_cast<ChartSeries>(i), maxPoints, chartPoints[i]);
+        chartSeries[i]->replace(chartPoints[i]);
     }
     
-    // Find the maximum Y value to auto-scale the Y axis
-    double maxY = 0.0;
-    for (int i = 0; i < totalCostSeries->count(); i++) {
-        maxY = std::max(maxY, totalCostSeries->at(i).y());
-    }
+    // Show the most recent window
+    double latest = chartHistory.latestTime();
+    axisX->setRange(std::max(0.0, latest - kChartWindowSeconds),
+                    std::max(kChartWindowSeconds, latest));
     
     // Add some margin to the Y axis
+    double maxY = chartHistory.maximum();
     if (maxY > 0.0) {
         axisY->setRange(0, maxY * 1.1);
     }
@@ -352,5 +453,14 @@ QString MainWindow::formatPercentage(double value) const {
     return QString("%1%").arg(value * 100.0, 0, 'f', 2);
 }
 
+QString MainWindow::formatLatency(uint64_t nanoseconds) const {
+    if (nanoseconds >= 1000000) {
+        return QString("%1 ms").arg(nanoseconds / 1e6, 0, 'f', 2);
+    } else if (nanoseconds >= 1000) {
+        return QString("%1 μs").arg(nanoseconds / 1e3, 0, 'f', 1);
+    }
+    return QString("%1 ns").arg(nanoseconds);
+}
+
 } // namespace ui
 } // namespace trade_simulator 
\ No newline at end of file
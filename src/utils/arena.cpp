@@ -0,0 +1,62 @@
+#include "utils/arena.h"
+
+#include <algorithm>
+
+namespace trade_simulator {
+namespace utils {
+
+Arena::Arena(size_t blockBytes) : blockBytes_(std::max<size_t>(blockBytes, kBlockAlignment)) {
+}
+
+Arena::~Arena() {
+    destroyAll();
+    for (const Block& block : blocks_) {
+        ::operator delete(block.data, std::align_val_t(kBlockAlignment));
+    }
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    alignment = std::max<size_t>(alignment, 1);
+    if (!blocks_.empty()) {
+        size_t aligned = (offset_ + alignment - 1) & ~(alignment - 1);
+        if (aligned + bytes <= blocks_.back().size) {
+            used_ += aligned + bytes - offset_;
+            offset_ = aligned + bytes;
+            return blocks_.back().data + aligned;
+        }
+    }
+
+    // Blocks start 64-byte aligned, so a fresh block needs no padding
+    addBlock(bytes);
+    offset_ = bytes;
+    used_ += bytes;
+    return blocks_.back().data;
+}
+
+void Arena::reset() {
+    destroyAll();
+    for (size_t i = 1; i < blocks_.size(); ++i) {
+        ::operator delete(blocks_[i].data, std::align_val_t(kBlockAlignment));
+    }
+    if (blocks_.size() > 1) {
+        blocks_.resize(1);
+    }
+    offset_ = 0;
+    used_ = 0;
+}
+
+void Arena::destroyAll() {
+    for (auto it = finalizers_.rbegin(); it != finalizers_.rend(); ++it) {
+        it->destroy(it->object);
+    }
+    finalizers_.clear();
+}
+
+void Arena::addBlock(size_t minimumBytes) {
+    size_t size = std::max(blockBytes_, (minimumBytes + kBlockAlignment - 1) & ~(kBlockAlignment - 1));
+    char* data = static_cast<char*>(::operator new(size, std::align_val_t(kBlockAlignment)));
+    blocks_.push_back({data, size});
+}
+
+} // namespace utils
+} // namespace trade_simulator
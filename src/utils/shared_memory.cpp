@@ -0,0 +1,91 @@
+#include "utils/shared_memory.h"
+
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trade_simulator {
+namespace utils {
+
+SharedMemoryRegion SharedMemoryRegion::create(const std::string& name, size_t size) {
+    // A previous run that crashed may have left the object behind
+    ::shm_unlink(name.c_str());
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create shared memory: " + name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot size shared memory: " + name);
+    }
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot map shared memory: " + name);
+    }
+    return SharedMemoryRegion(name, mapping, size, true);
+}
+
+SharedMemoryRegion SharedMemoryRegion::open(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open shared memory: " + name);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("Empty shared memory: " + name);
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map shared memory: " + name);
+    }
+    return SharedMemoryRegion(name, mapping, size, false);
+}
+
+SharedMemoryRegion::SharedMemoryRegion(SharedMemoryRegion&& other) noexcept
+    : name_(std::move(other.name_)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      owner_(std::exchange(other.owner_, false)) {
+}
+
+SharedMemoryRegion& SharedMemoryRegion::operator=(SharedMemoryRegion&& other) noexcept {
+    if (this != &other) {
+        release();
+        name_ = std::move(other.name_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        owner_ = std::exchange(other.owner_, false);
+    }
+    return *this;
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    release();
+}
+
+void SharedMemoryRegion::release() {
+    if (data_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+} // namespace utils
+} // namespace trade_simulator
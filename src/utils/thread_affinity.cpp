@@ -0,0 +1,37 @@
+#include "utils/thread_affinity.h"
+
+#include <iostream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace trade_simulator {
+namespace utils {
+
+bool pinCurrentThread(int cpu) {
+    if (cpu < 0) {
+        return false;
+    }
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+void applyThreadConfig(const ThreadConfig& config, const char* threadName) {
+    if (config.cpu >= 0 && !pinCurrentThread(config.cpu)) {
+        std::cerr << "Cannot pin the " << threadName << " thread to CPU " << config.cpu << std::endl;
+    }
+}
+
+} // namespace utils
+} // namespace trade_simulator
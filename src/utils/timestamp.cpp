@@ -0,0 +1,145 @@
+#include "utils/timestamp.h"
+
+namespace trade_simulator {
+namespace utils {
+
+namespace {
+
+constexpr int64_t kNanosecondsPerSecond = 1000000000;
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Read a fixed number of digits
+ * @param text Text to read from; advanced past the digits
+ * @param digits Number of digits
+ * @param value Receives the number
+ * @return False if fewer digits follow
+ */
+bool readDigits(std::string_view& text, size_t digits, int64_t& value) {
+    if (text.size() < digits) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < digits; ++i) {
+        if (!isDigit(text[i])) {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    text.remove_prefix(digits);
+    return true;
+}
+
+bool consume(std::string_view& text, char c) {
+    if (text.empty() || text.front() != c) {
+        return false;
+    }
+    text.remove_prefix(1);
+    return true;
+}
+
+/**
+ * @brief Days from 1970-01-01 to a date of the proleptic Gregorian calendar
+ *
+ * Howard Hinnant's days_from_civil.
+ */
+int64_t daysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2 ? 1 : 0;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+int64_t parseEpoch(std::string_view text) {
+    if (text.empty() || text.size() > 19) {
+        return 0;
+    }
+    int64_t value = 0;
+    for (char c : text) {
+        if (!isDigit(c)) {
+            return 0;
+        }
+        value = value * 10 + (c - '0');
+    }
+    if (text.size() <= 10) {
+        return value * kNanosecondsPerSecond;
+    }
+    if (text.size() <= 13) {
+        return value * 1000000;
+    }
+    if (text.size() <= 16) {
+        return value * 1000;
+    }
+    return value;
+}
+
+int64_t parseIso8601(std::string_view text) {
+    int64_t year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (!readDigits(text, 4, year) || !consume(text, '-') || !readDigits(text, 2, month) ||
+        !consume(text, '-') || !readDigits(text, 2, day) ||
+        !(consume(text, 'T') || consume(text, ' ')) || !readDigits(text, 2, hour) ||
+        !consume(text, ':') || !readDigits(text, 2, minute) || !consume(text, ':') ||
+        !readDigits(text, 2, second)) {
+        return 0;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return 0;
+    }
+
+    int64_t fraction = 0;
+    if (consume(text, '.')) {
+        int64_t scale = kNanosecondsPerSecond;
+        size_t digits = 0;
+        for (; !text.empty() && isDigit(text.front()); text.remove_prefix(1), ++digits) {
+            if (scale > 1) {
+                scale /= 10;
+                fraction += (text.front() - '0') * scale;
+            }
+        }
+        if (digits == 0) {
+            return 0;
+        }
+    }
+
+    int64_t offsetSeconds = 0;
+    if (consume(text, 'Z') || consume(text, 'z')) {
+        // UTC
+    } else if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+        int64_t sign = text.front() == '-' ? -1 : 1;
+        text.remove_prefix(1);
+        int64_t offsetHours = 0, offsetMinutes = 0;
+        if (!readDigits(text, 2, offsetHours)) {
+            return 0;
+        }
+        consume(text, ':');
+        if (!text.empty() && !readDigits(text, 2, offsetMinutes)) {
+            return 0;
+        }
+        offsetSeconds = sign * (offsetHours * 3600 + offsetMinutes * 60);
+    }
+    if (!text.empty()) {
+        return 0;
+    }
+
+    int64_t seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second -
+                      offsetSeconds;
+    return seconds * kNanosecondsPerSecond + fraction;
+}
+
+} // namespace
+
+int64_t parseTimestampNs(std::string_view text) {
+    // "YYYY-" marks ISO 8601; anything else must be all digits
+    if (text.size() > 4 && text[4] == '-') {
+        return parseIso8601(text);
+    }
+    return parseEpoch(text);
+}
+
+} // namespace utils
+} // namespace trade_simulator
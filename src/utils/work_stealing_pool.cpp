@@ -0,0 +1,127 @@
+#include "utils/work_stealing_pool.h"
+
+#include <algorithm>
+
+namespace trade_simulator {
+namespace utils {
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i]() {
+            runWorker(i);
+        });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex_);
+        shutdown_ = true;
+    }
+    jobStarted_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t taskCount, const TaskBody& body) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    // Deal contiguous ranges so neighbouring tasks tend to run on the same worker
+    size_t workerCount = workers_.size();
+    for (size_t w = 0; w < workerCount; ++w) {
+        size_t begin = taskCount * w / workerCount;
+        size_t end = taskCount * (w + 1) / workerCount;
+        std::lock_guard<std::mutex> lock(workers_[w]->mutex);
+        for (size_t task = begin; task < end; ++task) {
+            workers_[w]->tasks.push_back(task);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(jobMutex_);
+    body_ = &body;
+    error_ = nullptr;
+    activeWorkers_ = workerCount;
+    ++generation_;
+    jobStarted_.notify_all();
+
+    jobFinished_.wait(lock, [this]() { return activeWorkers_ == 0; });
+    body_ = nullptr;
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void WorkStealingPool::runWorker(size_t index) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        const TaskBody* body;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex_);
+            jobStarted_.wait(lock, [&]() { return shutdown_ || generation_ != seenGeneration; });
+            if (shutdown_) {
+                return;
+            }
+            seenGeneration = generation_;
+            body = body_;
+        }
+
+        size_t task;
+        while (popOwn(index, task) || steal(index, task)) {
+            try {
+                (*body)(task, index);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(jobMutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(jobMutex_);
+        if (--activeWorkers_ == 0) {
+            jobFinished_.notify_all();
+        }
+    }
+}
+
+bool WorkStealingPool::popOwn(size_t index, size_t& task) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = worker.tasks.back();
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, size_t& task) {
+    size_t workerCount = workers_.size();
+    for (size_t offset = 1; offset < workerCount; ++offset) {
+        Worker& victim = *workers_[(thief + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace utils
+} // namespace trade_simulator 
@@ -0,0 +1,43 @@
+// Converts a feed log recorded with --record into a columnar book store that replays
+// without JSON parsing.
+//
+//     book_store_convert <feed log> <book store> [--raw] [--tick <size>] [--lot <size>]
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "data/book_store.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <feed log> <book store> [--raw] [--tick <size>] [--lot <size>]" << std::endl;
+        return 2;
+    }
+
+    trade_simulator::data::BookStoreConfig config;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--raw") == 0) {
+            config.encoding = trade_simulator::data::BookStoreEncoding::Raw;
+        } else if (std::strcmp(argv[i], "--tick") == 0 && i + 1 < argc) {
+            config.spec.tickSize = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lot") == 0 && i + 1 < argc) {
+            config.spec.lotSize = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+
+    try {
+        uint64_t books = trade_simulator::data::convertFeedLog(argv[1], argv[2], config);
+        std::cout << "Wrote " << books << " books to " << argv[2] << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,98 @@
+// Follows the shared-memory output bus of a running simulator and prints every record
+// as a CSV row, or only the newest one with --latest. On exit (SIGINT, or the simulator
+// going away) it reports the delivery latency from publication to this reader.
+//
+//     output_bus_tail </name> [--latest] [--quiet]
+
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "models/output_bus.h"
+#include "models/output_sink.h"
+#include "utils/latency_histogram.h"
+#include "utils/thread_affinity.h"
+
+namespace {
+
+std::atomic<bool> stopRequested{false};
+
+void onSignal(int) {
+    stopRequested.store(true);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace trade_simulator;
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " </name> [--latest] [--quiet]" << std::endl;
+        return 2;
+    }
+    bool latestOnly = false;
+    bool quiet = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--latest") == 0) {
+            latestOnly = true;
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+
+    try {
+        models::OutputBusReader reader(argv[1]);
+        models::OutputBusRecord record;
+
+        if (latestOnly) {
+            if (!reader.latest(record)) {
+                std::cerr << "Nothing published yet" << std::endl;
+                return 1;
+            }
+            char row[512];
+            size_t length = models::formatOutputCsv(record.output, row, sizeof(row));
+            std::cout << models::kOutputCsvHeader << '\n';
+            std::cout.write(row, static_cast<std::streamsize>(length));
+            return 0;
+        }
+
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        utils::LatencyHistogram delivery;
+        if (!quiet) {
+            std::cout << models::kOutputCsvHeader << '\n';
+        }
+        while (!stopRequested.load(std::memory_order_relaxed)) {
+            if (!reader.next(record)) {
+                if (reader.isClosed()) {
+                    break;
+                }
+                utils::cpuRelax();
+                continue;
+            }
+            delivery.recordInterval(record.output.publishedNs, utils::nowNanoseconds());
+            if (!quiet) {
+                char row[512];
+                size_t length = models::formatOutputCsv(record.output, row, sizeof(row));
+                std::cout.write(row, static_cast<std::streamsize>(length));
+            }
+        }
+        std::cout.flush();
+
+        utils::LatencySnapshot latency = delivery.snapshot();
+        std::cerr << "Read " << latency.count << " records (" << reader.missed()
+                  << " missed); delivery p50 " << latency.p50 << " ns, p99 " << latency.p99
+                  << " ns, max " << latency.max << " ns" << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
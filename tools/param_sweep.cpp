@@ -0,0 +1,135 @@
+// Evaluates a grid of cost model parameters over a recorded session on all cores and
+// writes one row of cost metrics per configuration and quantity.
+//
+//     param_sweep <feed log | book store> [--quantities a,b,...] [--permanent a,b,...]
+//                 [--temporary a,b,...] [--risk-aversion a,b,...] [--fee-tiers a,b,...]
+//                 [--slippage-volume a,b,...] [--slippage-volatility a,b,...]
+//                 [--slippage-imbalance a,b,...] [--volatility x] [--symbol s]
+//                 [--threads n] [--output file.csv]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "models/parameter_sweep.h"
+#include "utils/work_stealing_pool.h"
+
+namespace {
+
+template <typename T>
+std::vector<T> parseList(const char* text) {
+    std::vector<T> values;
+    std::stringstream in(text);
+    for (std::string item; std::getline(in, item, ',');) {
+        if (!item.empty()) {
+            std::stringstream itemStream(item);
+            T value{};
+            itemStream >> value;
+            if (!itemStream) {
+                throw std::runtime_error("Invalid value: " + item);
+            }
+            values.push_back(value);
+        }
+    }
+    if (values.empty()) {
+        throw std::runtime_error(std::string("Empty list: ") + text);
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace trade_simulator;
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <feed log | book store> [--quantities a,b,...]"
+                  << " [--permanent ...] [--temporary ...] [--risk-aversion ...]"
+                  << " [--fee-tiers ...] [--slippage-volume ...] [--slippage-volatility ...]"
+                  << " [--slippage-imbalance ...] [--volatility x] [--symbol s]"
+                  << " [--threads n] [--output file.csv]" << std::endl;
+        return 2;
+    }
+
+    std::vector<double> quantities{100.0};
+    models::SweepGrid grid;
+    std::string symbol;
+    std::string outputPath;
+    size_t threads = 0;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            const char* option = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << option << std::endl;
+                return 2;
+            }
+            const char* value = argv[++i];
+            if (std::strcmp(option, "--quantities") == 0) {
+                quantities = parseList<double>(value);
+            } else if (std::strcmp(option, "--permanent") == 0) {
+                grid.permanentImpactFactors = parseList<double>(value);
+            } else if (std::strcmp(option, "--temporary") == 0) {
+                grid.temporaryImpactFactors = parseList<double>(value);
+            } else if (std::strcmp(option, "--risk-aversion") == 0) {
+                grid.riskAversions = parseList<double>(value);
+            } else if (std::strcmp(option, "--fee-tiers") == 0) {
+                grid.feeTiers = parseList<int>(value);
+            } else if (std::strcmp(option, "--slippage-volume") == 0) {
+                grid.slippageVolumeFactors = parseList<double>(value);
+            } else if (std::strcmp(option, "--slippage-volatility") == 0) {
+                grid.slippageVolatilityFactors = parseList<double>(value);
+            } else if (std::strcmp(option, "--slippage-imbalance") == 0) {
+                grid.slippageImbalanceFactors = parseList<double>(value);
+            } else if (std::strcmp(option, "--volatility") == 0) {
+                grid.volatility = std::atof(value);
+            } else if (std::strcmp(option, "--symbol") == 0) {
+                symbol = value;
+            } else if (std::strcmp(option, "--threads") == 0) {
+                threads = static_cast<size_t>(std::atoi(value));
+            } else if (std::strcmp(option, "--output") == 0) {
+                outputPath = value;
+            } else {
+                std::cerr << "Unknown option: " << option << std::endl;
+                return 2;
+            }
+        }
+
+        auto loadStart = std::chrono::steady_clock::now();
+        models::SweepSession session = models::SweepSession::load(argv[1], quantities,
+                                                                  data::VolatilityConfig(), symbol);
+        auto sweepStart = std::chrono::steady_clock::now();
+
+        utils::WorkStealingPool pool(threads);
+        std::vector<models::SweepResult> results = models::runParameterSweep(session, grid, pool);
+        auto sweepEnd = std::chrono::steady_clock::now();
+
+        using ms = std::chrono::milliseconds;
+        std::cerr << "Decoded " << session.tickCount() << " updates of " << session.symbol()
+                  << " in " << std::chrono::duration_cast<ms>(sweepStart - loadStart).count()
+                  << " ms; swept " << grid.configurationCount() << " configurations on "
+                  << pool.threadCount() << " threads in "
+                  << std::chrono::duration_cast<ms>(sweepEnd - sweepStart).count() << " ms"
+                  << std::endl;
+
+        if (outputPath.empty()) {
+            models::writeSweepCsv(std::cout, results);
+        } else {
+            std::ofstream out(outputPath);
+            if (!out) {
+                throw std::runtime_error("Cannot open " + outputPath);
+            }
+            models::writeSweepCsv(out, results);
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}